@@ -0,0 +1,212 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "BattleReport.h"
+#include "HeadlessGame.h"
+#include <iomanip>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace {
+std::ostream& operator<<(std::ostream& out, const RuntimeStats& stats)
+{
+    return out << stats.count << ' ' << stats.p50 << ' ' << stats.p95 << ' ' << stats.max;
+}
+
+std::istream& operator>>(std::istream& in, RuntimeStats& stats)
+{
+    return in >> stats.count >> stats.p50 >> stats.p95 >> stats.max;
+}
+
+std::string escapeJson(const std::string& str)
+{
+    std::ostringstream result;
+    for(const char c : str)
+    {
+        switch(c)
+        {
+            case '"': result << "\\\""; break;
+            case '\\': result << "\\\\"; break;
+            case '\n': result << "\\n"; break;
+            case '\r': result << "\\r"; break;
+            case '\t': result << "\\t"; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20)
+                    result << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+                else
+                    result << c;
+        }
+    }
+    return result.str();
+}
+
+std::string escapeCsv(const std::string& str)
+{
+    if(str.find_first_of(",\"\n") == std::string::npos)
+        return str;
+    std::string result = "\"";
+    for(const char c : str)
+    {
+        if(c == '"')
+            result += '"';
+        result += c;
+    }
+    return result + '"';
+}
+
+void writeJsonStats(std::ostream& out, const RuntimeStats& stats)
+{
+    out << "\"count\": " << stats.count << ", \"p50_ms\": " << stats.p50 << ", \"p95_ms\": " << stats.p95
+        << ", \"max_ms\": " << stats.max;
+}
+} // namespace
+
+void WriteMatchResult(std::ostream& out, const MatchResult& result)
+{
+    out << std::setprecision(std::numeric_limits<double>::max_digits10);
+    out << "match " << result.index << ' ' << std::quoted(result.map) << ' ' << result.seed << ' ' << result.gfs << ' '
+        << result.seconds << ' ' << result.winner << '\n';
+    for(const MatchResult::Player& player : result.players)
+    {
+        out << "player " << player.id << ' ' << std::quoted(player.ai) << ' ' << player.defeated << ' '
+            << player.country << ' ' << player.runGF << '\n';
+    }
+    for(const MatchResult::Recurrent& recurrent : result.recurrents)
+        out << "recurrent " << recurrent.player << ' ' << std::quoted(recurrent.name) << ' ' << recurrent.runtime << '\n';
+    if(!result.error.empty())
+        out << "error " << std::quoted(result.error) << '\n';
+    out << "end\n";
+}
+
+bool ReadMatchResult(std::istream& in, MatchResult& result)
+{
+    result = MatchResult();
+    std::string line;
+    while(std::getline(in, line))
+    {
+        std::istringstream lineStream(line);
+        std::string type;
+        lineStream >> type;
+        if(type == "match")
+        {
+            lineStream >> result.index >> std::quoted(result.map) >> result.seed >> result.gfs >> result.seconds
+              >> result.winner;
+        } else if(type == "player")
+        {
+            MatchResult::Player player;
+            lineStream >> player.id >> std::quoted(player.ai) >> player.defeated >> player.country >> player.runGF;
+            result.players.push_back(player);
+        } else if(type == "recurrent")
+        {
+            MatchResult::Recurrent recurrent;
+            lineStream >> recurrent.player >> std::quoted(recurrent.name) >> recurrent.runtime;
+            result.recurrents.push_back(recurrent);
+        } else if(type == "error")
+            lineStream >> std::quoted(result.error);
+        else if(type == "end")
+            return true;
+        else
+            return false;
+        if(lineStream.fail())
+            return false;
+    }
+    return false;
+}
+
+void WriteJson(std::ostream& out, const std::vector<MatchResult>& results)
+{
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"matches\": [";
+    for(size_t i = 0; i < results.size(); ++i)
+    {
+        const MatchResult& result = results[i];
+        out << (i ? ",\n" : "\n");
+        out << "    {\n";
+        out << "      \"index\": " << result.index << ",\n";
+        out << "      \"map\": \"" << escapeJson(result.map) << "\",\n";
+        out << "      \"seed\": " << result.seed << ",\n";
+        out << "      \"outcome\": \"" << result.GetOutcome() << "\",\n";
+        if(result.winner >= 0)
+            out << "      \"winner\": " << result.winner << ",\n";
+        if(!result.error.empty())
+            out << "      \"error\": \"" << escapeJson(result.error) << "\",\n";
+        out << "      \"gfs\": " << result.gfs << ",\n";
+        out << "      \"seconds\": " << result.seconds << ",\n";
+        out << "      \"gfs_per_second\": " << result.GetGFsPerSecond() << ",\n";
+        out << "      \"players\": [";
+        for(size_t j = 0; j < result.players.size(); ++j)
+        {
+            const MatchResult::Player& player = result.players[j];
+            out << (j ? ",\n" : "\n");
+            out << "        { \"id\": " << player.id << ", \"ai\": \"" << escapeJson(player.ai)
+                << "\", \"defeated\": " << (player.defeated ? "true" : "false") << ", \"country\": " << player.country
+                << ", \"run_gf\": { ";
+            writeJsonStats(out, player.runGF);
+            out << " } }";
+        }
+        out << "\n      ],\n";
+        out << "      \"recurrents\": [";
+        for(size_t j = 0; j < result.recurrents.size(); ++j)
+        {
+            const MatchResult::Recurrent& recurrent = result.recurrents[j];
+            out << (j ? ",\n" : "\n");
+            out << "        { \"player\": " << recurrent.player << ", \"name\": \"" << escapeJson(recurrent.name)
+                << "\", ";
+            writeJsonStats(out, recurrent.runtime);
+            out << " }";
+        }
+        out << "\n      ]\n";
+        out << "    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void WriteCsv(std::ostream& out, const std::vector<MatchResult>& results)
+{
+    out << std::fixed << std::setprecision(3);
+    out << "match,map,seed,outcome,winner,gfs,seconds,gfs_per_second,player,ai,series,count,p50_ms,p95_ms,max_ms\n";
+    for(const MatchResult& result : results)
+    {
+        std::ostringstream matchCols;
+        matchCols << std::fixed << std::setprecision(3);
+        matchCols << result.index << ',' << escapeCsv(result.map) << ',' << result.seed << ',' << result.GetOutcome()
+                  << ',' << (result.winner >= 0 ? std::to_string(result.winner) : "") << ',' << result.gfs << ','
+                  << result.seconds << ',' << result.GetGFsPerSecond();
+
+        const auto writeRow = [&](const MatchResult::Player& player, const std::string& series,
+                                  const RuntimeStats& stats) {
+            out << matchCols.str() << ',' << player.id << ',' << escapeCsv(player.ai) << ',' << escapeCsv(series)
+                << ',' << stats.count << ',' << stats.p50 << ',' << stats.p95 << ',' << stats.max << '\n';
+        };
+
+        if(result.players.empty())
+            out << matchCols.str() << ",,,,,,,\n";
+        for(const MatchResult::Player& player : result.players)
+        {
+            writeRow(player, "RunGF", player.runGF);
+            for(const MatchResult::Recurrent& recurrent : result.recurrents)
+            {
+                if(recurrent.player == player.id)
+                    writeRow(player, recurrent.name, recurrent.runtime);
+            }
+        }
+    }
+}
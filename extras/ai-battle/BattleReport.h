@@ -0,0 +1,33 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+#include <vector>
+
+struct MatchResult;
+
+/// Write the result of a match so it can be read by ReadMatchResult (used to pass results between processes)
+void WriteMatchResult(std::ostream& out, const MatchResult& result);
+/// Read a result written by WriteMatchResult. Returns false if the input is malformed
+bool ReadMatchResult(std::istream& in, MatchResult& result);
+
+/// Write all results as a JSON document
+void WriteJson(std::ostream& out, const std::vector<MatchResult>& results);
+/// Write all results as CSV with one row per runtime series (AIPlayer::RunGF per player and every Beowulf recurrent)
+void WriteCsv(std::ostream& out, const std::vector<MatchResult>& results);
@@ -0,0 +1,217 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "HeadlessGame.h"
+#include "EventManager.h"
+#include "Game.h"
+#include "GamePlayer.h"
+#include "GlobalGameSettings.h"
+#include "PlayerInfo.h"
+#include "ai/AIPlayer.h"
+#include "ai/beowulf/Beowulf.h"
+#include "factories/AIFactory.h"
+#include "ogl/glArchivItem_Map.h"
+#include "random/Random.h"
+#include "world/GameWorld.h"
+#include "world/MapLoader.h"
+#include "gameTypes/GameSettingTypes.h"
+#include "s25util/colors.h"
+#include <boost/nowide/fstream.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+namespace bnw = boost::nowide;
+
+namespace {
+/// GFs between two network frames. AI commands are only executed on network frames.
+const unsigned nwfLength = 20;
+
+using Clock = std::chrono::steady_clock;
+
+/// Runtimes are wall clock time, like beowulf::Beowulf::Runtime.
+double toMs(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+unsigned getNumAlivePlayers(const GameWorldBase& world)
+{
+    unsigned result = 0;
+    for(unsigned i = 0; i < world.GetNumPlayers(); ++i)
+    {
+        if(!world.GetPlayer(i).IsDefeated())
+            ++result;
+    }
+    return result;
+}
+} // namespace
+
+RuntimeStats RuntimeStats::FromSamples(std::vector<double> samples)
+{
+    RuntimeStats result;
+    if(samples.empty())
+        return result;
+    std::sort(samples.begin(), samples.end());
+    // Nearest rank
+    const auto percentile = [&samples](double p) {
+        const auto rank = static_cast<size_t>(std::ceil(p * samples.size()));
+        return samples[std::max<size_t>(rank, 1u) - 1u];
+    };
+    result.count = static_cast<unsigned>(samples.size());
+    result.p50 = percentile(0.5);
+    result.p95 = percentile(0.95);
+    result.max = samples.back();
+    return result;
+}
+
+std::string MatchResult::GetOutcome() const
+{
+    if(!error.empty())
+        return "error";
+    return winner >= 0 ? "win" : "timeout";
+}
+
+std::string GetAIName(const AI::Info& ai)
+{
+    switch(ai.type)
+    {
+        case AI::DUMMY: return "dummy";
+        case AI::DEFAULT: return "aijh";
+        case AI::BEOWULF: return "beowulf";
+    }
+    return "unknown";
+}
+
+MatchResult RunMatch(const MatchSettings& settings)
+{
+    RANDOM.Init(settings.seed);
+
+    std::vector<PlayerInfo> playerInfos;
+    for(const AI::Info& ai : settings.players)
+    {
+        PlayerInfo p;
+        p.ps = PS_AI;
+        p.aiInfo = ai;
+        p.name = GetAIName(ai);
+        p.color = PLAYER_COLORS[playerInfos.size() % PLAYER_COLORS.size()];
+        playerInfos.push_back(p);
+    }
+
+    GlobalGameSettings ggs;
+    ggs.objective = GO_NONE;
+    ggs.exploration = EXP_FOGOFWAR;
+
+    auto game = std::make_shared<Game>(ggs, 0u, playerInfos);
+    GameWorld& world = game->world_;
+    EventManager& em = *game->em_;
+
+    glArchivItem_Map map;
+    bnw::ifstream mapFile(settings.map, std::ios::binary);
+    if(map.load(mapFile, false) != 0)
+        throw std::runtime_error("Could not load file " + settings.map.string());
+    MapLoader loader(world);
+    if(!loader.Load(map, ggs.exploration))
+        throw std::runtime_error("Could not load map " + settings.map.string());
+    if(!loader.PlaceHQs(world, false))
+        throw std::runtime_error("Could not place HQs on " + settings.map.string());
+    world.InitAfterLoad();
+
+    std::vector<beowulf::Beowulf*> beowulfs;
+    for(unsigned i = 0; i < playerInfos.size(); ++i)
+    {
+        std::unique_ptr<AIPlayer> ai = AIFactory::Create(settings.players[i], i, world);
+        if(settings.players[i].type == AI::BEOWULF)
+        {
+            beowulfs.push_back(static_cast<beowulf::Beowulf*>(ai.get()));
+            beowulfs.back()->RecordRuntimes(true);
+        }
+        game->AddAIPlayer(std::move(ai));
+    }
+    game->Start(false);
+
+    std::vector<std::vector<double>> runGFTimes(playerInfos.size());
+
+    const Clock::time_point start = Clock::now();
+    while(em.GetCurrentGF() < settings.maxGF && getNumAlivePlayers(world) > 1)
+    {
+        const unsigned gf = em.GetCurrentGF();
+        const bool isNWF = gf % nwfLength == 0;
+        if(isNWF)
+        {
+            for(AIPlayer& ai : game->aiPlayers_)
+            {
+                for(const gc::GameCommandPtr& gc : ai.FetchGameCommands())
+                    gc->Execute(world, ai.GetPlayerId());
+            }
+        }
+        for(AIPlayer& ai : game->aiPlayers_)
+        {
+            const Clock::time_point aiStart = Clock::now();
+            ai.RunGF(gf, isNWF);
+            runGFTimes[ai.GetPlayerId()].push_back(toMs(Clock::now() - aiStart));
+        }
+        game->RunGF();
+    }
+    const std::chrono::duration<double> duration = Clock::now() - start;
+
+    MatchResult result;
+    result.map = settings.map.string();
+    result.seed = settings.seed;
+    result.gfs = em.GetCurrentGF();
+    result.seconds = duration.count();
+    if(getNumAlivePlayers(world) == 1)
+    {
+        for(unsigned i = 0; i < world.GetNumPlayers(); ++i)
+        {
+            if(!world.GetPlayer(i).IsDefeated())
+                result.winner = static_cast<int>(i);
+        }
+    }
+
+    for(unsigned i = 0; i < world.GetNumPlayers(); ++i)
+    {
+        const GamePlayer& player = world.GetPlayer(i);
+        MatchResult::Player resultPlayer;
+        resultPlayer.id = i;
+        resultPlayer.ai = GetAIName(settings.players[i]);
+        resultPlayer.defeated = player.IsDefeated();
+        resultPlayer.country = player.GetStatisticCurrentValue(STAT_COUNTRY);
+        resultPlayer.runGF = RuntimeStats::FromSamples(std::move(runGFTimes[i]));
+        result.players.push_back(resultPlayer);
+    }
+
+    for(const beowulf::Beowulf* beowulf : beowulfs)
+    {
+        const std::vector<std::string>& names = beowulf->GetRecurrentNames();
+        for(size_t i = 0; i < names.size(); ++i)
+        {
+            std::vector<double> samples;
+            for(const beowulf::Beowulf::Runtime& runtime : beowulf->GetRuntimes()[i])
+                samples.push_back(toMs(runtime));
+            MatchResult::Recurrent recurrent;
+            recurrent.player = beowulf->GetPlayerId();
+            recurrent.name = names[i];
+            recurrent.runtime = RuntimeStats::FromSamples(std::move(samples));
+            result.recurrents.push_back(recurrent);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "gameTypes/AIInfo.h"
+#include <boost/filesystem/path.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Summary of a series of runtime samples in milliseconds
+struct RuntimeStats
+{
+    unsigned count = 0;
+    double p50 = 0;
+    double p95 = 0;
+    double max = 0;
+
+    static RuntimeStats FromSamples(std::vector<double> samples);
+};
+
+struct MatchSettings
+{
+    boost::filesystem::path map;
+    uint64_t seed = 1;
+    std::vector<AI::Info> players;
+    /// Stop the match after this many GFs without a winner
+    unsigned maxGF = 0;
+};
+
+struct MatchResult
+{
+    struct Player
+    {
+        unsigned id = 0;
+        std::string ai;
+        bool defeated = false;
+        /// Country size (statistic) at the end of the match
+        unsigned country = 0;
+        /// Time of every call to AIPlayer::RunGF
+        RuntimeStats runGF;
+    };
+    struct Recurrent
+    {
+        unsigned player = 0;
+        std::string name;
+        RuntimeStats runtime;
+    };
+
+    unsigned index = 0;
+    std::string map;
+    uint64_t seed = 0;
+    unsigned gfs = 0;
+    double seconds = 0;
+    /// Last remaining player or -1 if the match reached the GF limit
+    int winner = -1;
+    std::vector<Player> players;
+    /// Runtimes of the Beowulf recurrents
+    std::vector<Recurrent> recurrents;
+    /// Set if the match could not be run
+    std::string error;
+
+    double GetGFsPerSecond() const { return seconds > 0 ? gfs / seconds : 0; }
+    std::string GetOutcome() const;
+};
+
+std::string GetAIName(const AI::Info& ai);
+
+/// Run a single match without any GUI or network. Throws std::runtime_error if the map could not be loaded
+MatchResult RunMatch(const MatchSettings& settings);
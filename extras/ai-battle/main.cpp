@@ -0,0 +1,270 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "BattleReport.h"
+#include "HeadlessGame.h"
+#include "RttrConfig.h"
+#include "s25util/LocaleHelper.h"
+#include "s25util/Log.h"
+#include "s25util/NullWriter.h"
+#include "s25util/System.h"
+#include <boost/filesystem.hpp>
+#include <boost/nowide/args.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/nowide/iostream.hpp>
+#include <boost/process.hpp>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <list>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bfs = boost::filesystem;
+namespace bnw = boost::nowide;
+namespace bp = boost::process;
+namespace po = boost::program_options;
+
+namespace {
+
+AI::Info parseAI(const std::string& name)
+{
+    if(name == "beowulf")
+        return AI::Info(AI::BEOWULF, AI::HARD);
+    if(name == "aijh")
+        return AI::Info(AI::DEFAULT, AI::HARD);
+    if(name == "dummy")
+        return AI::Info(AI::DUMMY);
+    throw std::invalid_argument("Unknown AI '" + name + "'. Valid are: beowulf, aijh, dummy");
+}
+
+std::vector<MatchSettings> createMatches(const po::variables_map& options)
+{
+    std::vector<AI::Info> players;
+    for(const std::string& ai : options["ai"].as<std::vector<std::string>>())
+        players.push_back(parseAI(ai));
+    if(players.size() < 2)
+        throw std::invalid_argument("At least 2 AIs are required");
+
+    std::vector<uint64_t> seeds;
+    if(options.count("seed"))
+        seeds = options["seed"].as<std::vector<uint64_t>>();
+    else
+    {
+        for(unsigned i = 1; i <= options["matches"].as<unsigned>(); i++)
+            seeds.push_back(i);
+    }
+
+    std::vector<MatchSettings> matches;
+    for(const std::string& map : options["map"].as<std::vector<std::string>>())
+    {
+        for(uint64_t seed : seeds)
+        {
+            MatchSettings match;
+            match.map = RTTRCONFIG.ExpandPath(map);
+            match.seed = seed;
+            match.players = players;
+            match.maxGF = options["max-gf"].as<unsigned>();
+            matches.push_back(match);
+        }
+    }
+    return matches;
+}
+
+MatchResult runMatchSafe(const MatchSettings& settings, unsigned index)
+{
+    MatchResult result;
+    try
+    {
+        result = RunMatch(settings);
+    } catch(const std::exception& e)
+    {
+        result.map = settings.map.string();
+        result.seed = settings.seed;
+        result.error = e.what();
+    }
+    result.index = index;
+    return result;
+}
+
+/// Run a single match (in a child process) and write the result to the given file
+int runChild(const std::vector<MatchSettings>& matches, unsigned index, const std::string& resultFile)
+{
+    if(index >= matches.size())
+        return 1;
+    bnw::ofstream out(resultFile);
+    WriteMatchResult(out, runMatchSafe(matches[index], index));
+    return out ? 0 : 1;
+}
+
+/// Run all matches in up to numJobs child processes
+std::vector<MatchResult> runMatches(const std::vector<MatchSettings>& matches, unsigned numJobs, int argc,
+                                    char** argv)
+{
+    struct Job
+    {
+        unsigned index;
+        bfs::path resultFile;
+        bp::child process;
+    };
+
+    const bfs::path executable = System::getExecutablePath();
+    std::vector<std::string> baseArgs(argv + 1, argv + argc);
+
+    std::vector<MatchResult> results(matches.size());
+    std::list<Job> running;
+    unsigned nextMatch = 0;
+    while(nextMatch < matches.size() || !running.empty())
+    {
+        while(nextMatch < matches.size() && running.size() < numJobs)
+        {
+            const bfs::path resultFile = bfs::temp_directory_path() / bfs::unique_path("ai-battle-%%%%-%%%%-%%%%.txt");
+            std::vector<std::string> args = baseArgs;
+            args.push_back("--child-index=" + std::to_string(nextMatch));
+            args.push_back("--child-result=" + resultFile.string());
+            running.push_back(Job{nextMatch, resultFile, bp::child(executable, bp::args(args), bp::std_out > bp::null)});
+            nextMatch++;
+        }
+
+        bool finishedAny = false;
+        for(auto it = running.begin(); it != running.end();)
+        {
+            if(it->process.running())
+            {
+                ++it;
+                continue;
+            }
+            it->process.wait();
+            MatchResult& result = results[it->index];
+            bnw::ifstream in(it->resultFile.string());
+            if(!in || !ReadMatchResult(in, result))
+            {
+                result = MatchResult();
+                result.map = matches[it->index].map.string();
+                result.seed = matches[it->index].seed;
+                result.error = "Match process failed with exit code " + std::to_string(it->process.exit_code());
+            }
+            result.index = it->index;
+            in.close();
+            boost::system::error_code ec;
+            bfs::remove(it->resultFile, ec);
+            bnw::cerr << "Finished match " << (it->index + 1) << "/" << matches.size() << ": " << result.GetOutcome()
+                      << std::endl;
+            it = running.erase(it);
+            finishedAny = true;
+        }
+        if(!finishedAny)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return results;
+}
+
+int writeResults(const std::vector<MatchResult>& results, const po::variables_map& options)
+{
+    if(options.count("csv"))
+    {
+        bnw::ofstream out(options["csv"].as<std::string>());
+        WriteCsv(out, results);
+        if(!out)
+        {
+            bnw::cerr << "Could not write " << options["csv"].as<std::string>() << std::endl;
+            return 1;
+        }
+    }
+    if(options.count("json"))
+    {
+        bnw::ofstream out(options["json"].as<std::string>());
+        WriteJson(out, results);
+        if(!out)
+        {
+            bnw::cerr << "Could not write " << options["json"].as<std::string>() << std::endl;
+            return 1;
+        }
+    } else if(!options.count("csv"))
+        WriteJson(bnw::cout, results);
+    return 0;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bnw::args _(argc, argv);
+
+    po::options_description desc("Allowed options");
+    // clang-format off
+    desc.add_options()
+        ("help,h", "Show help")
+        ("map,m", po::value<std::vector<std::string>>()->required(), "Maps to play (may use RTTR path placeholders)")
+        ("seed,s", po::value<std::vector<uint64_t>>()->multitoken(), "Random seeds, one match per map and seed")
+        ("matches,n", po::value<unsigned>()->default_value(1), "Number of matches per map (seeds 1..n) if no seed is given")
+        ("ai", po::value<std::vector<std::string>>()->multitoken()->default_value({"beowulf", "aijh", "dummy"}, "beowulf aijh dummy"), "Players (beowulf, aijh, dummy)")
+        ("max-gf", po::value<unsigned>()->default_value(50000), "Maximum number of GFs per match")
+        ("jobs,j", po::value<unsigned>()->default_value(std::max(1u, std::thread::hardware_concurrency())), "Number of matches run in parallel")
+        ("json", po::value<std::string>(), "Write results as JSON to this file (default: stdout)")
+        ("csv", po::value<std::string>(), "Write results as CSV to this file")
+        ;
+    po::options_description hidden("Child process options");
+    hidden.add_options()
+        ("child-index", po::value<unsigned>(), "Only run the match with this index")
+        ("child-result", po::value<std::string>(), "File to write the result of the match to")
+        ;
+    // clang-format on
+    po::options_description allOptions;
+    allOptions.add(desc).add(hidden);
+
+    po::variables_map options;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, allOptions), options);
+        if(options.count("help"))
+        {
+            bnw::cout << "Runs headless matches between AIs and reports runtime statistics\n" << desc << std::endl;
+            return 0;
+        }
+        po::notify(options);
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << "Error: " << e.what() << "\n\n" << desc << std::endl;
+        return 1;
+    }
+
+    if(!LocaleHelper::init())
+        return 1;
+    if(!RTTRCONFIG.Init())
+        return 1;
+    LOG.setWriter(new NullWriter(), LogTarget::File);
+
+    try
+    {
+        const std::vector<MatchSettings> matches = createMatches(options);
+        if(options.count("child-index"))
+        {
+            LOG.setWriter(new NullWriter(), LogTarget::Stdout);
+            return runChild(matches, options["child-index"].as<unsigned>(), options["child-result"].as<std::string>());
+        }
+
+        const unsigned numJobs = std::max(1u, options["jobs"].as<unsigned>());
+        return writeResults(runMatches(matches, numJobs, argc, argv), options);
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
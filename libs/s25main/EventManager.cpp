@@ -34,16 +34,18 @@ EventManager::~EventManager()
 
 void EventManager::Clear()
 {
-    for(auto& event : events)
+    for(const GameEvent* ev : GetEvents())
     {
-        for(const GameEvent* ev : event.second)
-        {
-            delete ev;
-            RTTR_Assert(numActiveEvents > 0u);
-            numActiveEvents--;
-        }
+        delete ev;
+        RTTR_Assert(numActiveEvents > 0u);
+        numActiveEvents--;
     }
-    events.clear();
+    for(EventSlot& slot : wheel)
+    {
+        slot.events.clear();
+        slot.numActive = 0;
+    }
+    overflowEvents.clear();
     RTTR_Assert(numActiveEvents == 0u);
 
     for(auto& it : killList)
@@ -64,7 +66,11 @@ const GameEvent* EventManager::AddEventToQueue(const GameEvent* event)
 {
     // Should be in the future!
     RTTR_Assert(event->GetTargetGF() > currentGF);
-    events[event->GetTargetGF()].push_back(event);
+    const unsigned targetGF = event->GetTargetGF();
+    EventSlot& slot = IsInWheel(targetGF) ? GetWheelSlot(targetGF) : overflowEvents[targetGF];
+    event->queuePos = static_cast<unsigned>(slot.events.size());
+    slot.events.push_back(event);
+    ++slot.numActive;
     ++numActiveEvents;
     return event;
 }
@@ -96,6 +102,7 @@ unsigned EventManager::GetNextEventInstanceId()
 void EventManager::ExecuteNextGF()
 {
     currentGF++;
+    MoveOverflowEvents();
 
     ExecuteCurrentEvents();
     DestroyCurrentObjects();
@@ -116,47 +123,83 @@ void EventManager::DestroyCurrentObjects()
     killList.clear();
 }
 
-std::vector<const GameEvent*> EventManager::GetEvents() const
+void EventManager::SetCurrentGF(unsigned gf)
 {
-    std::vector<const GameEvent*> nextEv;
-    for(const auto& event : events)
-        nextEv.insert(nextEv.end(), event.second.begin(), event.second.end());
-    return nextEv;
+    // Skipped GFs must not have any events as the wheel slots get reused
+    RTTR_Assert(gf >= currentGF);
+    RTTR_Assert(GetNextEventGF() == 0u || GetNextEventGF() >= gf);
+    currentGF = gf;
+    MoveOverflowEvents();
 }
 
-void EventManager::ExecuteCurrentEvents()
+unsigned EventManager::GetNextEventGF() const
 {
-    if(events.empty())
-        return;
-    // Get list of events to be executed next
-    auto itCurEvents = events.begin();
+    for(unsigned gf = currentGF; gf - currentGF < WHEEL_SIZE; ++gf)
+    {
+        if(GetWheelSlot(gf).numActive > 0u)
+            return gf;
+    }
+    if(!overflowEvents.empty())
+        return overflowEvents.begin()->first;
+    return 0u;
+}
 
-    RTTR_Assert(itCurEvents->first >= currentGF);
+void EventManager::MoveOverflowEvents()
+{
+    for(auto it = overflowEvents.begin(); it != overflowEvents.end() && IsInWheel(it->first);
+        it = overflowEvents.erase(it))
+    {
+        EventSlot& slot = GetWheelSlot(it->first);
+        RTTR_Assert(slot.events.empty());
+        // Positions stay the same as the whole list is moved
+        slot = std::move(it->second);
+    }
+}
 
-    if(itCurEvents->first == currentGF)
-        ExecuteEvents(itCurEvents);
+std::vector<const GameEvent*> EventManager::GetEvents() const
+{
+    std::vector<const GameEvent*> nextEv;
+    nextEv.reserve(numActiveEvents);
+    const auto addEvents = [&nextEv](const EventSlot& slot) {
+        for(const GameEvent* ev : slot.events)
+        {
+            if(ev)
+                nextEv.push_back(ev);
+        }
+    };
+    for(unsigned gf = currentGF; gf - currentGF < WHEEL_SIZE; ++gf)
+        addEvents(GetWheelSlot(gf));
+    for(const auto& it : overflowEvents)
+        addEvents(it.second);
+    return nextEv;
 }
 
-void EventManager::ExecuteEvents(const EventMap::iterator& itEvents)
+void EventManager::ExecuteCurrentEvents()
 {
-    EventList& curEvents = itEvents->second;
-    // We have to allow 2 cases:
-    // 1) Adding of events to current GF -> std::list allows this without invalidating any iterators
-    // 2) Checking for events -> Remove all deleted events so only valid ones are in the list
-    for(auto e_it = curEvents.begin(); e_it != curEvents.end(); e_it = curEvents.erase(e_it))
+    EventSlot& curEvents = GetWheelSlot(currentGF);
+    // Events may be removed while executing (Event A can cause Event B in the same GF to be removed).
+    // Those are set to nullptr, so iterate by index and skip them
+    for(unsigned i = 0; i < curEvents.events.size(); ++i)
     {
-        const GameEvent* ev = (*e_it);
+        const GameEvent* ev = curEvents.events[i];
+        if(!ev)
+            continue;
+        RTTR_Assert(ev->GetTargetGF() == currentGF);
         RTTR_Assert(ev->obj);
         RTTR_Assert(ev->obj->GetObjId() <= GameObject::GetObjIDCounter());
 
         curActiveEvent = ev;
         ev->obj->HandleEvent(ev->id);
 
+        curEvents.events[i] = nullptr;
+        --curEvents.numActive;
         delete ev;
         --numActiveEvents;
     }
     curActiveEvent = nullptr;
-    events.erase(itEvents);
+    RTTR_Assert(curEvents.numActive == 0u);
+    curEvents.events.clear();
+    curEvents.numActive = 0;
 }
 
 void EventManager::Serialize(SerializedGameData& sgd) const
@@ -195,30 +238,19 @@ void EventManager::Deserialize(SerializedGameData& sgd)
         boost::format eventCtError(_("Event count mismatch. Read events: %1%. Expected: %2%.\n"));
         throw SerializedGameData::Error((eventCtError % numActiveEvents % numEvents).str());
     }
-    for(const auto& it : events)
+    for(const GameEvent* ev : GetEvents())
     {
-        for(const GameEvent* ev : it.second)
+        if(ev->GetInstanceId() >= eventInstanceCtr)
         {
-            if(ev->GetInstanceId() >= eventInstanceCtr)
-            {
-                boost::format eventIdError(_("Invalid event instance id. Found: %1%. Expected less than %2%.\n"));
-                throw SerializedGameData::Error((eventIdError % ev->GetInstanceId() % eventInstanceCtr).str());
-            }
+            boost::format eventIdError(_("Invalid event instance id. Found: %1%. Expected less than %2%.\n"));
+            throw SerializedGameData::Error((eventIdError % ev->GetInstanceId() % eventInstanceCtr).str());
         }
     }
 }
 
 bool EventManager::ObjectHasEvents(const GameObject& obj)
 {
-    for(auto& event : events)
-    {
-        for(const GameEvent* ev : event.second)
-        {
-            if(ev->obj == &obj)
-                return true;
-        }
-    }
-    return false;
+    return helpers::contains_if(GetEvents(), [&obj](const GameEvent* ev) { return ev->obj == &obj; });
 }
 
 bool EventManager::IsObjectInKillList(const GameObject& obj)
@@ -245,30 +277,43 @@ void EventManager::RemoveEvent(const GameEvent*& ep)
 void EventManager::RemoveEventFromQueue(const GameEvent& event)
 {
     RTTR_Assert(curActiveEvent != &event);
-    auto itEventsAtTime = events.find(event.GetTargetGF());
-    if(itEventsAtTime != events.end())
+    const unsigned targetGF = event.GetTargetGF();
+    auto itOverflow = overflowEvents.end();
+    EventSlot* slot = nullptr;
+    if(IsInWheel(targetGF))
+        slot = &GetWheelSlot(targetGF);
+    else
     {
-        EventList& eventsAtTime = itEventsAtTime->second;
-        auto e_it = helpers::find(eventsAtTime, &event);
-        if(e_it != eventsAtTime.end())
-        {
-            eventsAtTime.erase(e_it);
-            --numActiveEvents;
-            RTTR_Assert(!helpers::contains(eventsAtTime, &event)); // Event existed multiple times?
-        } else
-        {
-            RTTR_Assert(false);
-            LOG.write("Bug detected: Event to be removed did not exist");
-        }
-
-        // Note: Removing this is possible, as it cannot be the currently processed list
-        //       because there is always the curActiveEvent left, which cannot be removed (check above)
-        if(eventsAtTime.empty())
-            events.erase(itEventsAtTime);
-    } else
+        itOverflow = overflowEvents.find(targetGF);
+        if(itOverflow != overflowEvents.end())
+            slot = &itOverflow->second;
+    }
+    if(!slot || slot->events.empty())
     {
         RTTR_Assert(false);
         LOG.write("Bug detected: GF of event to be removed did not exist");
+        return;
+    }
+    if(event.queuePos < slot->events.size() && slot->events[event.queuePos] == &event)
+    {
+        slot->events[event.queuePos] = nullptr;
+        --slot->numActive;
+        --numActiveEvents;
+        RTTR_Assert(!helpers::contains(slot->events, &event)); // Event existed multiple times?
+    } else
+    {
+        RTTR_Assert(false);
+        LOG.write("Bug detected: Event to be removed did not exist");
+    }
+
+    // Note: Clearing this is possible, as it cannot be the currently processed list
+    //       because there is always the curActiveEvent left, which cannot be removed (check above)
+    if(slot->numActive == 0u)
+    {
+        if(itOverflow != overflowEvents.end())
+            overflowEvents.erase(itOverflow);
+        else
+            slot->events.clear();
     }
 }
 
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <map>
 #include <vector>
@@ -65,27 +66,45 @@ public:
     bool IsObjectInKillList(const GameObject& obj);
 
 protected:
-    // Use list to allow removing of events while iterating (Event A can cause Event B in the same GF to be removed)
-    using EventList = std::list<const GameEvent*>;
-    using EventMap = std::map<unsigned, EventList>;
+    /// Events of one GF in the order they were added. Removed events leave a nullptr (keeps the positions).
+    struct EventSlot
+    {
+        std::vector<const GameEvent*> events;
+        unsigned numActive = 0;
+    };
+    /// Events up to this many GFs ahead are kept in the wheel, later ones in the overflow map.
+    /// Must be a power of 2.
+    static constexpr unsigned WHEEL_SIZE = 1024;
     // Use list to allow adding events while iterating (Destroying 1 object may lead to destruction of another)
     using GameObjList = std::list<GameObject*>;
     unsigned numActiveEvents;
     /// Instances created. Must be != 0
     unsigned eventInstanceCtr;
     unsigned currentGF;
-    EventMap events;      /// Mapping of GF to Events to be executed in this GF
+    /// Timing wheel: Events of GF x (currentGF <= x < currentGF + WHEEL_SIZE) are in slot x % WHEEL_SIZE
+    std::array<EventSlot, WHEEL_SIZE> wheel;
+    /// Mapping of GF to events for all GFs after the wheel
+    std::map<unsigned, EventSlot> overflowEvents;
     GameObjList killList; /// Objects that will be killed after current GF
     const GameEvent* curActiveEvent;
 
     const GameEvent* AddEventToQueue(const GameEvent* event);
     void RemoveEventFromQueue(const GameEvent& event);
+    /// Set the current GF. All events before it must have been executed.
+    void SetCurrentGF(unsigned gf);
+    /// Return the GF of the next event or 0 if there is none
+    unsigned GetNextEventGF() const;
     /// Execute all events of the current GF
     void ExecuteCurrentEvents();
-    /// Execute the events from the given iterator
-    void ExecuteEvents(const EventMap::iterator& itEvents);
     /// Destroy all objects in the kill list
     void DestroyCurrentObjects();
     /// Get all events in the order they will be processed
     std::vector<const GameEvent*> GetEvents() const;
+
+private:
+    bool IsInWheel(unsigned gf) const { return gf - currentGF < WHEEL_SIZE; }
+    EventSlot& GetWheelSlot(unsigned gf) { return wheel[gf & (WHEEL_SIZE - 1)]; }
+    const EventSlot& GetWheelSlot(unsigned gf) const { return wheel[gf & (WHEEL_SIZE - 1)]; }
+    /// Move events that are now close enough from the overflow map into the wheel
+    void MoveOverflowEvents();
 };
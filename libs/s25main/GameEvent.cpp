@@ -18,6 +18,53 @@
 #include "GameEvent.h"
 #include "GameObject.h"
 #include "SerializedGameData.h"
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+/// Free list allocator for GameEvents. Memory is allocated in chunks and never returned to the system.
+class EventPool
+{
+    union Slot
+    {
+        Slot* next;
+        alignas(GameEvent) unsigned char storage[sizeof(GameEvent)];
+    };
+    static constexpr unsigned CHUNK_SIZE = 1024;
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot* freeList = nullptr;
+
+public:
+    void* Alloc()
+    {
+        if(!freeList)
+        {
+            chunks.emplace_back(new Slot[CHUNK_SIZE]);
+            Slot* chunk = chunks.back().get();
+            for(unsigned i = 0; i < CHUNK_SIZE; i++)
+                chunk[i].next = (i + 1 < CHUNK_SIZE) ? &chunk[i + 1] : nullptr;
+            freeList = chunk;
+        }
+        Slot* result = freeList;
+        freeList = result->next;
+        return result;
+    }
+    void Free(void* ptr)
+    {
+        auto* slot = static_cast<Slot*>(ptr);
+        slot->next = freeList;
+        freeList = slot;
+    }
+};
+
+EventPool& GetEventPool()
+{
+    // Intentionally leaked: Events may still be freed during static destruction
+    static auto* pool = new EventPool;
+    return *pool;
+}
+} // namespace
 
 GameEvent::GameEvent(unsigned instanceId, GameObject* obj, unsigned startGF, unsigned length, unsigned id)
     : instanceId(instanceId), obj(obj), startGF(startGF), length(length), id(id)
@@ -40,3 +87,21 @@ void GameEvent::Serialize(SerializedGameData& sgd) const
     sgd.PushUnsignedInt(length);
     sgd.PushUnsignedInt(id);
 }
+
+void* GameEvent::operator new(std::size_t size)
+{
+    // Derived classes would not fit into the slots
+    if(size != sizeof(GameEvent))
+        return ::operator new(size);
+    return GetEventPool().Alloc();
+}
+
+void GameEvent::operator delete(void* ptr, std::size_t size)
+{
+    if(!ptr)
+        return;
+    if(size != sizeof(GameEvent))
+        ::operator delete(ptr);
+    else
+        GetEventPool().Free(ptr);
+}
@@ -17,12 +17,20 @@
 
 #pragma once
 
+#include <cstddef>
+
+class EventManager;
 class GameObject;
 class SerializedGameData;
 
 class GameEvent
 {
+    friend class EventManager;
+
     const unsigned instanceId; /// unique ID
+    /// Index in the event list of its target GF (managed by the EventManager)
+    mutable unsigned queuePos = 0;
+
 public:
     /// Object that will handle this event
     GameObject* obj;
@@ -40,4 +48,8 @@ public:
     /// Return GF at which this event will be executed
     unsigned GetTargetGF() const { return startGF + length; }
     unsigned GetInstanceId() const { return instanceId; }
+
+    /// Events are allocated from a pool as they are created and destroyed very often
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size);
 };
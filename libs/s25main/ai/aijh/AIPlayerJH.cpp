@@ -1741,20 +1741,16 @@ void AIPlayerJH::TryToAttack()
         unsigned attackersStrength = 0;
 
         // ask each of nearby own military buildings for soldiers to contribute to the potential attack
-        sortedMilitaryBlds myBuildings = gwb.LookForMilitaryBuildings(dest, 2);
-        for(const nobBaseMilitary* otherMilBld : myBuildings)
-        {
-            if(otherMilBld->GetPlayer() == playerId)
-            {
-                const auto* myMil = dynamic_cast<const nobMilitary*>(otherMilBld);
-                if(!myMil || myMil->IsUnderAttack())
-                    continue;
-
-                unsigned newAttackers;
-                attackersStrength += myMil->GetSoldiersStrengthForAttack(dest, newAttackers);
-                attackersCount += newAttackers;
-            }
-        }
+        gwb.VisitMilitaryBuildings(
+          dest, 2, 1u << playerId, [dest, &attackersCount, &attackersStrength](const nobBaseMilitary* otherMilBld) {
+              const auto* myMil = dynamic_cast<const nobMilitary*>(otherMilBld);
+              if(!myMil || myMil->IsUnderAttack())
+                  return;
+
+              unsigned newAttackers;
+              attackersStrength += myMil->GetSoldiersStrengthForAttack(dest, newAttackers);
+              attackersCount += newAttackers;
+          });
 
         if(attackersCount == 0)
             continue;
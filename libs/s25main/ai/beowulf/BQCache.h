@@ -0,0 +1,88 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_BQCACHE_H_INCLUDED
+#define BEOWULF_BQCACHE_H_INCLUDED
+
+#include "gameTypes/BuildingQuality.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace beowulf {
+
+/**
+ * @brief Per node cache of World::GetBQ() for the actual and the anticipated territory.
+ *
+ * The build location scoring reads BQs from several threads. Entries are therefore atomic.
+ * Concurrent writers of an entry always store the same value. Invalidation must not run
+ * concurrently with reads.
+ */
+class BQCache
+{
+public:
+    void Init(size_t numNodes)
+    {
+        numNodes_ = numNodes;
+        entries_.reset(new std::atomic<unsigned char>[2 * numNodes]);
+        Clear();
+    }
+
+    /// Returns false if no BQ is cached.
+    bool Get(size_t idx, bool anticipated, BuildingQuality& bq) const
+    {
+        const unsigned char entry = entries_[Offset(idx, anticipated)].load(std::memory_order_relaxed);
+        if (entry == Invalid)
+            return false;
+        bq = static_cast<BuildingQuality>(entry);
+        return true;
+    }
+
+    void Set(size_t idx, bool anticipated, BuildingQuality bq)
+    {
+        entries_[Offset(idx, anticipated)].store(static_cast<unsigned char>(bq), std::memory_order_relaxed);
+    }
+
+    void Invalidate(size_t idx)
+    {
+        InvalidateAnticipated(idx);
+        entries_[Offset(idx, false)].store(Invalid, std::memory_order_relaxed);
+    }
+
+    void InvalidateAnticipated(size_t idx)
+    {
+        entries_[Offset(idx, true)].store(Invalid, std::memory_order_relaxed);
+    }
+
+    void Clear()
+    {
+        for (size_t i = 0; i < 2 * numNodes_; ++i)
+            entries_[i].store(Invalid, std::memory_order_relaxed);
+    }
+
+private:
+    static const unsigned char Invalid = 0xFF;
+
+    size_t Offset(size_t idx, bool anticipated) const { return anticipated ? numNodes_ + idx : idx; }
+
+    size_t numNodes_ = 0;
+    std::unique_ptr<std::atomic<unsigned char>[]> entries_;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_BQCACHE_H_INCLUDED
@@ -16,12 +16,16 @@
 // along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
 
 #include "ai/beowulf/Beowulf.h"
+#include "ai/beowulf/Budget.h"
 #include "ai/beowulf/recurrent/ProductionPlanner.h"
 
 #include "network/GameClient.h"
 #include "network/GameMessages.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <iterator>
+#include <numeric>
 
 namespace beowulf {
 
@@ -32,10 +36,16 @@ enum Event {
     PlanProductionEvent,
 };
 
+// Work units the recurrents may spend per run (see Budget).
+static const unsigned S_budget_work_units = 20000;
+// NWFs after which the commands of a background planning are issued.
+static const unsigned S_planning_latency = 1;
+
 Beowulf::Beowulf(const unsigned char playerId,
                  const GameWorldBase& gwb,
                  const AI::Level level)
     : AIPlayer(playerId, gwb, level),
+      planningAii_(gwb, planningGcs_, playerId),
       world(this, false),
       build(this),
       roads(this),
@@ -43,7 +53,8 @@ Beowulf::Beowulf(const unsigned char playerId,
       produce(this),
       metalworks(this),
       attack(this),
-      coins(this)
+      coins(this),
+      budgetWorkUnits_(S_budget_work_units)
 {
     recurrents_.push_back(&build);
     recurrents_.push_back(&roads);
@@ -52,17 +63,42 @@ Beowulf::Beowulf(const unsigned char playerId,
     recurrents_.push_back(&metalworks);
     recurrents_.push_back(&attack);
     recurrents_.push_back(&coins);
+    recurrentNames_ = { "build", "roads", "expand", "produce", "metalworks", "attack", "coins" };
+
+    // Connecting and placing requested buildings comes first, since all other
+    // recurrents depend on them.
+    roads.SetPriority(6);
+    build.SetPriority(5);
+    expand.SetPriority(4);
+    attack.SetPriority(3);
+    produce.SetPriority(2);
+    metalworks.SetPriority(1);
+    coins.SetPriority(0);
+
+    runOrder_.resize(recurrents_.size());
+    std::iota(runOrder_.begin(), runOrder_.end(), 0);
 
     recurrentsWorstRuntime_.resize(recurrents_.size());
+    recurrentsRuntimes_.resize(recurrents_.size());
     ClearWorstRuntime();
 }
 
 Beowulf::~Beowulf()
 {
+    if (planning_)
+        planningJob_.wait();
 }
 
 void Beowulf::RunGF(const unsigned gf, bool gfisnwf)
 {
+    if (planning_) {
+        // The results are issued after a fixed number of NWFs regardless of how long the
+        // planning took. Otherwise the game would depend on the speed of the machine.
+        if (gfisnwf && ++planningNwfs_ >= S_planning_latency)
+            FinishPlanning();
+        return;
+    }
+
     if (CheckDefeat())
         return;
 
@@ -73,11 +109,36 @@ void Beowulf::RunGF(const unsigned gf, bool gfisnwf)
     if (waitForNextSync_ || (static_cast<unsigned char>(gf) & 0xF) != playerId)
         return;
 
-    for (size_t i = 0; i < recurrents_.size(); ++i) {
-        std::clock_t start = std::clock();
-        recurrents_[i]->RunGf();
-        std::clock_t end = std::clock();
-        recurrentsWorstRuntime_[i] = std::max(recurrentsWorstRuntime_[i], end - start);
+    world.resources.Refresh();
+    world.RefreshEnemyMilitary();
+
+    // Recurrents with higher priority run first. Once the budget is exhausted the remaining
+    // due recurrents are deferred to the next run.
+    std::stable_sort(runOrder_.begin(), runOrder_.end(), [this](size_t l, size_t r)
+    {
+        if (recurrents_[l]->GetPriority() != recurrents_[r]->GetPriority())
+            return recurrents_[l]->GetPriority() > recurrents_[r]->GetPriority();
+        return l < r;
+    });
+
+    Budget budget(budgetWorkUnits_, budgetTime_);
+    bool planInBackground = false;
+    for (size_t i : runOrder_) {
+        if (IsBackground(i)) {
+            planInBackground |= recurrents_[i]->IsDue();
+            continue;
+        }
+        Run(i, budget);
+    }
+
+    if (planInBackground) {
+        StartPlanning();
+    } else {
+        // Nothing to plan. The background recurrents only count down their interval.
+        for (size_t i : runOrder_) {
+            if (IsBackground(i))
+                Run(i, budget);
+        }
     }
 
     if (aii.HasIssuedGameCommands())
@@ -97,15 +158,88 @@ void Beowulf::RunGF(const unsigned gf, bool gfisnwf)
     // DecommissionUnusedRoads();
 }
 
+void Beowulf::Run(size_t recurrent, Budget& budget)
+{
+    const bool runs = recurrents_[recurrent]->IsDue() && !budget.IsExhausted();
+    // Background recurrents call this on the planning thread, so they are timed there.
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    recurrents_[recurrent]->RunGf(budget);
+    const Runtime runtime = std::chrono::steady_clock::now() - start;
+    recurrentsWorstRuntime_[recurrent] = std::max(recurrentsWorstRuntime_[recurrent], runtime);
+    if (recordRuntimes_ && runs)
+        recurrentsRuntimes_[recurrent].push_back(runtime);
+}
+
+bool Beowulf::IsBackground(size_t recurrent) const
+{
+    if (!backgroundPlanning_)
+        return false;
+    const RecurrentBase* r = recurrents_[recurrent];
+    return r == &build || r == &expand || r == &produce;
+}
+
+void Beowulf::SetBackgroundPlanning(bool enable)
+{
+    if (!enable && planning_) {
+        planningJob_.wait();
+        FinishPlanning();
+    }
+    backgroundPlanning_ = enable;
+}
+
+void Beowulf::StartPlanning()
+{
+    RTTR_Assert(!planning_);
+
+    // Everything the planners read from the game is copied now. Notes arriving until the
+    // planning finished are delivered afterwards, so Beowulf's state only changes on this thread.
+    snapshot_.Capture(aii);
+    world.SetSnapshot(&snapshot_);
+    world.notes.Defer();
+    planning_ = true;
+    planningNwfs_ = 0;
+
+    planningJob_ = std::async(std::launch::async, [this]()
+    {
+        Budget budget(budgetWorkUnits_, budgetTime_);
+        for (size_t i : runOrder_) {
+            if (IsBackground(i))
+                Run(i, budget);
+        }
+    });
+}
+
+void Beowulf::FinishPlanning()
+{
+    RTTR_Assert(planning_);
+
+    // Rethrows exceptions of the planning.
+    planningJob_.get();
+    planning_ = false;
+    world.SetSnapshot(nullptr);
+    world.notes.Flush();
+
+    std::move(planningGcs_.begin(), planningGcs_.end(), std::back_inserter(gcs));
+    planningGcs_.clear();
+    if (aii.HasIssuedGameCommands())
+        waitForNextSync_ = true;
+}
+
 void Beowulf::DisableRecurrents()
 {
     for (RecurrentBase* recurrent : recurrents_)
         recurrent->Disable();
 }
 
+void Beowulf::SetBudget(unsigned workUnits, std::clock_t maxTime)
+{
+    budgetWorkUnits_ = workUnits;
+    budgetTime_ = maxTime;
+}
+
 void Beowulf::ClearWorstRuntime()
 {
-    std::fill(recurrentsWorstRuntime_.begin(), recurrentsWorstRuntime_.end(), 0);
+    std::fill(recurrentsWorstRuntime_.begin(), recurrentsWorstRuntime_.end(), Runtime::zero());
 }
 
 bool Beowulf::CheckDefeat()
@@ -18,6 +18,7 @@
 #define BEOWULF_BEOWULF_H_INCLUDED
 
 #include "ai/beowulf/World.h"
+#include "ai/beowulf/WorldSnapshot.h"
 #include "ai/beowulf/recurrent/RoadManager.h"
 #include "ai/beowulf/recurrent/BuildingPlanner.h"
 #include "ai/beowulf/recurrent/ExpansionPlanner.h"
@@ -28,15 +29,24 @@
 
 #include "ai/AIPlayer.h"
 
-#include <vector>
+#include <chrono>
 #include <ctime>
+#include <future>
+#include <string>
+#include <vector>
 
 namespace beowulf {
 
+class Budget;
 class RecurrentBase;
 
 class Beowulf : public AIPlayer
 {
+    // Declared before the recurrents, which use GetAII() on construction.
+    std::vector<gc::GameCommandPtr> planningGcs_;
+    AIInterface planningAii_;
+    bool planning_ = false;
+
 public:
     World world;
     BuildingPlanner build;
@@ -57,23 +67,63 @@ public:
 
     void DisableRecurrents();
 
-    AIInterface& GetAII() { return aii; }
-    const AIInterface& GetAII() const { return aii; }
+    /// Limit the work of the recurrents per run (see Budget). A 'maxTime' > 0 additionally limits
+    /// the wall clock time, which makes the AI depend on the machine it runs on.
+    void SetBudget(unsigned workUnits, std::clock_t maxTime = 0);
+
+    /// Run build, expand and produce on a background thread. They plan on a snapshot of the
+    /// world and their commands are issued on the next NWF. All other recurrents wait meanwhile.
+    void SetBackgroundPlanning(bool enable);
+    bool IsPlanning() const { return planning_; }
+
+    /// While planning in the background, commands are collected separately.
+    AIInterface& GetAII() { return planning_ ? planningAii_ : aii; }
+    const AIInterface& GetAII() const { return planning_ ? planningAii_ : aii; }
+
+    /// Wall clock time of a recurrent run, measured on the thread running it. CPU time
+    /// (std::clock()) would include the scoring threads, the planning thread and other AIs.
+    typedef std::chrono::steady_clock::duration Runtime;
 
     void ClearWorstRuntime();
-    const std::vector<std::clock_t>& GetWorstRuntime() const { return recurrentsWorstRuntime_; }
+    const std::vector<Runtime>& GetWorstRuntime() const { return recurrentsWorstRuntime_; }
+
+    /// Names of the recurrents in the order used by GetWorstRuntime() and GetRuntimes().
+    const std::vector<std::string>& GetRecurrentNames() const { return recurrentNames_; }
+
+    /// Keep the runtime of every run of every recurrent (for benchmarks).
+    void RecordRuntimes(bool record) { recordRuntimes_ = record; }
+    const std::vector<std::vector<Runtime>>& GetRuntimes() const { return recurrentsRuntimes_; }
 
 private:
     void Chat(const std::string& message) const;
     bool CheckDefeat();
 
+    /// Run a recurrent and record its runtime.
+    void Run(size_t recurrent, Budget& budget);
+    bool IsBackground(size_t recurrent) const;
+    void StartPlanning();
+    void FinishPlanning();
+
 private:
     bool defeated_ = false;
     bool waitForNextSync_ = false;
 
-    std::vector<std::clock_t> recurrentsWorstRuntime_;
+    std::vector<Runtime> recurrentsWorstRuntime_;
+    std::vector<std::vector<Runtime>> recurrentsRuntimes_;
+    bool recordRuntimes_ = false;
 
     std::vector<RecurrentBase*> recurrents_;
+    std::vector<std::string> recurrentNames_;
+    // Indices into recurrents_ ordered by priority.
+    std::vector<size_t> runOrder_;
+
+    unsigned budgetWorkUnits_;
+    std::clock_t budgetTime_ = 0;
+
+    bool backgroundPlanning_ = false;
+    WorldSnapshot snapshot_;
+    std::future<void> planningJob_;
+    unsigned planningNwfs_ = 0;
 };
 
 } // namespace beowulf
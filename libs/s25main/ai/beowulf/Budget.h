@@ -0,0 +1,68 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_BUDGET_H_INCLUDED
+#define BEOWULF_BUDGET_H_INCLUDED
+
+#include <ctime>
+#include <limits>
+
+namespace beowulf {
+
+/**
+ * @brief Amount of work the recurrents may do in one run of Beowulf.
+ *
+ * Work is counted in units (roughly one scored build location, one visited node or one
+ * connectivity check). A time limit can be added, but as wall clock time differs between
+ * machines only the work units are deterministic.
+ */
+class Budget
+{
+public:
+    static const unsigned Unlimited = std::numeric_limits<unsigned>::max();
+
+    /// 'maxTime' = 0 only counts work units.
+    explicit Budget(unsigned workUnits = Unlimited, std::clock_t maxTime = 0)
+        : workUnits_(workUnits),
+          maxTime_(maxTime),
+          start_(maxTime > 0 ? std::clock() : 0)
+    {
+    }
+
+    void Spend(unsigned units = 1)
+    {
+        spent_ = units > Unlimited - spent_ ? Unlimited : spent_ + units;
+    }
+
+    bool IsExhausted() const
+    {
+        if (workUnits_ != Unlimited && spent_ >= workUnits_)
+            return true;
+        return maxTime_ > 0 && std::clock() - start_ >= maxTime_;
+    }
+
+    unsigned GetSpent() const { return spent_; }
+
+private:
+    unsigned workUnits_;
+    unsigned spent_ = 0;
+    std::clock_t maxTime_;
+    std::clock_t start_;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_BUDGET_H_INCLUDED
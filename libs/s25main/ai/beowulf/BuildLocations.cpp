@@ -19,16 +19,28 @@
 #include "ai/beowulf/World.h"
 #include "ai/beowulf/Helper.h"
 
+#include "RttrForeachPt.h"
+
 #include <utility> /* std::pair */
 #include <algorithm> /* std::max */
 
 namespace beowulf {
 
+namespace {
+// Values of the reachability field besides direction + 1.
+const unsigned char Unreachable = 0;
+const unsigned char Destination = 0xFF;
+
+// Temporary buildings influence the BQ (and thus possible roads) within this distance.
+const unsigned TmpsInfluenceRadius = 4;
+} // namespace
+
 BuildLocations::BuildLocations(const World& world, bool includeAnticipated)
     : world_(world),
       includeAnticipated_(includeAnticipated)
 {
     map_.Resize(world.GetSize());
+    toRegion_.Resize(world.GetSize());
 }
 
 BuildLocations::~BuildLocations()
@@ -72,13 +84,11 @@ void BuildLocations::Calculate(
             locations.push_back({ pt, bq });
     });
 
+    CalculateReachability();
+
     for (const auto& loc : locations) {
         // Check if we can still connect that connection if we place a building.
-        MapPoint flag = world_.GetNeighbour(loc.first, Direction::SOUTHEAST);
-
-        std::vector<std::pair<MapPoint, BuildingQuality>> tmps = { { loc.first, loc.second } };
-
-        if (world_.CanConnectBuilding(flag, regionPt, includeAnticipated_, tmps))
+        if (CanConnect(loc.first, loc.second))
             Add(loc.first, loc.second);
     }
 }
@@ -107,17 +117,16 @@ void BuildLocations::Update(
         }
     }, true);
 
+    // Roads can only have changed around 'pos'.
+    if (!IsReachabilityValid(pos, radius))
+        CalculateReachability();
+
     // Check all locations whether they can still be connected.
-    for (Node* n = first_; n; n = n->next) {
-        MapPoint flagPt = world_.GetNeighbour(n->pos, Direction::SOUTHEAST);
-        std::vector<std::pair<MapPoint, BuildingQuality>> tmps = { { n->pos, n->bq } };
-        if (!world_.CanConnectBuilding(flagPt, regionPt, includeAnticipated_, tmps)) {
-            Node* newPrev = n->prev;
+    for (Node* n = first_; n;) {
+        Node* next = n->next;
+        if (!CanConnect(n->pos, n->bq))
             Remove(n);
-            n = newPrev;
-            if (!n)
-                break;
-        }
+        n = next;
     }
 }
 
@@ -210,6 +219,95 @@ void BuildLocations::Add(
     size_++;
 }
 
+bool BuildLocations::CanConnect(
+        const MapPoint& pos,
+        BuildingQuality bq) const
+{
+    MapPoint flag = world_.GetNeighbour(pos, Direction::SOUTHEAST);
+    if (flag == regionPt)
+        return true;
+
+    // Temporary buildings can only prevent roads. If we cannot reach regionPt without
+    // them, we won't reach it with them.
+    if (toRegion_[flag] == Unreachable)
+        return false;
+
+    // Follow the field and only check the segments the building could block.
+    std::vector<std::pair<MapPoint, BuildingQuality>> tmps = { { pos, bq } };
+    for (MapPoint pt = flag; pt != regionPt;) {
+        Direction dir = Direction::fromInt(toRegion_[pt] - 1);
+        if (map_.CalcDistance(pt, pos) <= TmpsInfluenceRadius && !IsSegmentPossible(pt, dir, tmps)) {
+            // There might be a detour.
+            return world_.CanConnectBuilding(flag, regionPt, includeAnticipated_, tmps);
+        }
+        pt = map_.GetNeighbour(pt, dir);
+    }
+
+    return true;
+}
+
+bool BuildLocations::IsSegmentPossible(
+        const MapPoint& pt,
+        Direction dir,
+        const std::vector<std::pair<MapPoint, BuildingQuality>>& tmps) const
+{
+    return world_.HasRoad(pt, dir) || world_.IsRoadPossible(pt, dir, includeAnticipated_, tmps);
+}
+
+void BuildLocations::CalculateReachability()
+{
+    RTTR_FOREACH_PT(MapPoint, map_.GetSize()) {
+        toRegion_[pt] = Unreachable;
+    }
+
+    // Breadth first search from regionPt over reversed segments.
+    queue_.clear();
+    queue_.push_back(regionPt);
+    toRegion_[regionPt] = Destination;
+
+    for (size_t i = 0; i < queue_.size(); ++i) {
+        const MapPoint pt = queue_[i];
+        for (const auto dir : helpers::EnumRange<Direction>{}) {
+            MapPoint from = map_.GetNeighbour(pt, dir);
+            if (toRegion_[from] != Unreachable)
+                continue;
+
+            Direction back = OppositeDirection(dir);
+            if (IsSegmentPossible(from, back)) {
+                toRegion_[from] = static_cast<unsigned char>(back.native_value() + 1);
+                queue_.push_back(from);
+            }
+        }
+    }
+}
+
+bool BuildLocations::IsReachabilityValid(
+        const MapPoint& pos,
+        unsigned radius) const
+{
+    // Segments starting up to one point outside the changed area might be affected.
+    const bool changed = map_.CheckPointsInRadius(pos, radius + 1, [&](const MapPoint& pt, unsigned)
+    {
+        const unsigned char reach = toRegion_[pt];
+        if (reach == Destination)
+            return false;
+
+        if (reach != Unreachable) {
+            // The first step towards regionPt must still be possible.
+            return !IsSegmentPossible(pt, Direction::fromInt(reach - 1));
+        }
+
+        // Unreachable points must not have become reachable.
+        for (const auto dir : helpers::EnumRange<Direction>{}) {
+            if (toRegion_[map_.GetNeighbour(pt, dir)] != Unreachable && IsSegmentPossible(pt, dir))
+                return true;
+        }
+        return false;
+    }, true);
+
+    return !changed;
+}
+
 void BuildLocations::Remove(Node* node)
 {
     sum_ -= static_cast<unsigned>(node->bq) - 1;
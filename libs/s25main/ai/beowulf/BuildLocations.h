@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <array>
+#include <utility> /* std::pair */
 
 namespace beowulf {
 
@@ -65,6 +66,13 @@ private:
     void Remove(Node* node);
     void Free();
 
+    /// Can a building with 'bq' at 'pos' still be connected to regionPt?
+    bool CanConnect(const MapPoint& pos, BuildingQuality bq) const;
+    bool IsSegmentPossible(const MapPoint& pt, Direction dir, const std::vector<std::pair<MapPoint, BuildingQuality>>& tmps = {}) const;
+    void CalculateReachability();
+    /// Check if the reachability of points around 'pos' is still the same.
+    bool IsReachabilityValid(const MapPoint& pos, unsigned radius) const;
+
     NodeMapBase<Node*> map_;
     Node* first_ = nullptr;
     Node* last_ = nullptr;
@@ -73,6 +81,11 @@ private:
     unsigned sum_ = 0;
     Node* freelist_ = nullptr;
     MapPoint regionPt;
+
+    // Reverse reachability field: for every point the direction of the next step
+    // towards regionPt (without any temporary buildings).
+    NodeMapBase<unsigned char> toRegion_;
+    std::vector<MapPoint> queue_;
 };
 
 } // namespace beowulf
@@ -20,7 +20,6 @@
 
 #include "gameData/BuildingConsts.h"
 #include "gameData/BuildingProperties.h"
-#include "buildings/nobBaseWarehouse.h"
 
 #include <limits>
 
@@ -229,14 +228,9 @@ const Inventory* Building::GetInventory() const
     if (state_ != Finished)
         return nullptr;
 
-    const noBaseBuilding* base = world_.GetBaseBuilding(this);
-
-    RTTR_Assert(base);
-    RTTR_Assert(base->GetType() == NOP_BUILDING);
-    RTTR_Assert(BuildingProperties::IsWareHouse(base->GetBuildingType()));
-
-    const nobBaseWarehouse* warehouse = static_cast<const nobBaseWarehouse*>(base);
-    return &warehouse->GetInventory();
+    const Inventory* inventory = world_.GetInventory(pt_);
+    RTTR_Assert(inventory);
+    return inventory;
 }
 
 } // namespace beowulf
@@ -66,9 +66,12 @@ private:
     State state_;
     unsigned group_;
     bool captured_;
+    // Slot in the BuildingPool of the world.
+    unsigned poolIndex_ = 0;
 
     // Only 'Buildings' can create and destroy building objects or change their state or group.
     friend class World;
+    friend class BuildingPool;
     friend class BuildingsPlan;
 
     Building(World& world, BuildingType type, State state);
@@ -0,0 +1,231 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ai/beowulf/BuildingIndex.h"
+#include "ai/beowulf/Building.h"
+
+#include "helpers/containerUtils.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace beowulf {
+
+void BuildingIndex::Init(const MapBase& world)
+{
+    world_ = &world;
+    // Rounding up
+    cells_ = MapExtent((world.GetSize().x + CellSize - 1) / CellSize, (world.GetSize().y + CellSize - 1) / CellSize);
+    for (Grid& grid : grids_)
+        grid.clear();
+}
+
+unsigned BuildingIndex::GetCell(const MapPoint& pt) const
+{
+    return (pt.y / CellSize) * cells_.x + pt.x / CellSize;
+}
+
+void BuildingIndex::Add(const Building* building)
+{
+    RTTR_Assert(building->GetPt().isValid());
+
+    Grid& grid = grids_[building->GetType()];
+    if (grid.empty())
+        grid.resize(cells_.x * cells_.y);
+
+    std::vector<const Building*>& cell = grid[GetCell(building->GetPt())];
+    RTTR_Assert(!helpers::contains(cell, building));
+    cell.push_back(building);
+}
+
+void BuildingIndex::Remove(const Building* building)
+{
+    RTTR_Assert(building->GetPt().isValid());
+
+    std::vector<const Building*>& cell = grids_[building->GetType()][GetCell(building->GetPt())];
+    auto it = std::find(cell.begin(), cell.end(), building);
+    RTTR_Assert(it != cell.end());
+    // Order within a square does not matter.
+    *it = cell.back();
+    cell.pop_back();
+}
+
+template<class T_Visit, class T_Proceed>
+void BuildingIndex::VisitRings(
+        const MapPoint& pt,
+        const std::vector<BuildingType>& types,
+        T_Visit visitor,
+        T_Proceed proceed) const
+{
+    // Every square gets exactly one offset to the center square in [lo, hi] (per axis),
+    // so no square is visited twice when the rings wrap around the map.
+    const int loX = -((static_cast<int>(cells_.x) - 1) / 2);
+    const int hiX = static_cast<int>(cells_.x) / 2;
+    const int loY = -((static_cast<int>(cells_.y) - 1) / 2);
+    const int hiY = static_cast<int>(cells_.y) / 2;
+    const int maxR = std::max(std::max(-loX, hiX), std::max(-loY, hiY));
+
+    const int centerX = pt.x / CellSize;
+    const int centerY = pt.y / CellSize;
+
+    auto visitCell = [&](int dx, int dy)
+    {
+        int cx = (centerX + dx) % static_cast<int>(cells_.x);
+        int cy = (centerY + dy) % static_cast<int>(cells_.y);
+        if (cx < 0)
+            cx += cells_.x;
+        if (cy < 0)
+            cy += cells_.y;
+
+        const unsigned cell = cy * cells_.x + cx;
+        for (BuildingType type : types) {
+            const Grid& grid = grids_[type];
+            if (grid.empty())
+                continue;
+            for (const Building* building : grid[cell])
+                visitor(building);
+        }
+    };
+
+    for (int r = 0; r <= maxR; ++r) {
+        // A point in ring r is at least (r - 1) * CellSize + 1 away on one axis. The last (partial)
+        // square on wrap-around reduces this by less than one square and the distance
+        // is at least the difference on one axis minus one.
+        const unsigned minDistance = r >= 2 ? (r - 2) * CellSize : 0;
+        if (!proceed(minDistance))
+            return;
+
+        for (int dy = std::max(-r, loY); dy <= std::min(r, hiY); ++dy) {
+            if (dy == -r || dy == r) {
+                for (int dx = std::max(-r, loX); dx <= std::min(r, hiX); ++dx)
+                    visitCell(dx, dy);
+            } else {
+                if (-r >= loX)
+                    visitCell(-r, dy);
+                if (r != 0 && r <= hiX)
+                    visitCell(r, dy);
+            }
+        }
+    }
+}
+
+bool BuildingIndex::IsCloser(
+        unsigned dist,
+        const Building* building,
+        unsigned otherDist,
+        const Building* other) const
+{
+    if (dist != otherDist)
+        return dist < otherDist;
+    return world_->GetIdx(building->GetPt()) < world_->GetIdx(other->GetPt());
+}
+
+std::pair<const Building*, unsigned> BuildingIndex::GetNearest(
+        const MapPoint& pt,
+        const std::vector<BuildingType>& types,
+        const Building* self) const
+{
+    const Building* best = nullptr;
+    unsigned bestDist = std::numeric_limits<unsigned>::max();
+
+    VisitRings(pt, types,
+    // visitor
+    [&](const Building* building)
+    {
+        if (building == self)
+            return;
+        unsigned dist = world_->CalcDistance(pt, building->GetPt());
+        if (!best || IsCloser(dist, building, bestDist, best)) {
+            best = building;
+            bestDist = dist;
+        }
+    },
+    // proceed
+    [&](unsigned minDistance)
+    {
+        return minDistance <= bestDist;
+    });
+
+    return { best, bestDist };
+}
+
+std::vector<const Building*> BuildingIndex::GetNearest(
+        const MapPoint& pt,
+        BuildingType type,
+        unsigned count) const
+{
+    std::vector<std::pair<unsigned, const Building*>> found;
+    auto less = [this](const std::pair<unsigned, const Building*>& l, const std::pair<unsigned, const Building*>& r)
+    {
+        return IsCloser(l.first, l.second, r.first, r.second);
+    };
+
+    if (count == 0)
+        return {};
+
+    VisitRings(pt, { type },
+    // visitor
+    [&](const Building* building)
+    {
+        found.push_back({ world_->CalcDistance(pt, building->GetPt()), building });
+    },
+    // proceed
+    [&](unsigned minDistance)
+    {
+        if (found.size() < count)
+            return true;
+        // Only keep the closest 'count' buildings.
+        std::nth_element(found.begin(), found.begin() + (count - 1), found.end(), less);
+        found.resize(count);
+        return minDistance <= std::max_element(found.begin(), found.end(), less)->first;
+    });
+
+    std::sort(found.begin(), found.end(), less);
+    if (found.size() > count)
+        found.resize(count);
+
+    std::vector<const Building*> ret;
+    ret.reserve(found.size());
+    for (const auto& entry : found)
+        ret.push_back(entry.second);
+    return ret;
+}
+
+std::vector<const Building*> BuildingIndex::GetInRadius(
+        const MapPoint& pt,
+        BuildingType type,
+        unsigned radius) const
+{
+    std::vector<const Building*> ret;
+
+    VisitRings(pt, { type },
+    // visitor
+    [&](const Building* building)
+    {
+        if (world_->CalcDistance(pt, building->GetPt()) <= radius)
+            ret.push_back(building);
+    },
+    // proceed
+    [&](unsigned minDistance)
+    {
+        return minDistance <= radius;
+    });
+
+    return ret;
+}
+
+} // namespace beowulf
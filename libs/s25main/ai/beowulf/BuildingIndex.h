@@ -0,0 +1,85 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_BUILDINGINDEX_H_INCLUDED
+#define BEOWULF_BUILDINGINDEX_H_INCLUDED
+
+#include "world/MapBase.h"
+#include "gameTypes/BuildingType.h"
+#include "gameTypes/MapCoordinates.h"
+
+#include <array>
+#include <utility> /* pair */
+#include <vector>
+
+namespace beowulf {
+
+class Building;
+
+/**
+ * @brief Spatial index of positioned buildings by type.
+ *
+ * The map is divided into squares of CellSize x CellSize points (like MilitarySquares).
+ * Queries visit the squares in rings around the query point and stop once no closer
+ * building can be found. Ties in distance are broken by the map index of the building.
+ * Queries do not modify the index and may run concurrently.
+ */
+class BuildingIndex
+{
+public:
+    void Init(const MapBase& world);
+
+    /// Add/remove a building at its current point.
+    void Add(const Building* building);
+    void Remove(const Building* building);
+
+    /// Get the closest building of one of 'types' (except 'self') and its distance.
+    std::pair<const Building*, unsigned> GetNearest(
+            const MapPoint& pt,
+            const std::vector<BuildingType>& types,
+            const Building* self = nullptr) const;
+    /// Get up to 'count' buildings of 'type' ordered by distance to 'pt'.
+    std::vector<const Building*> GetNearest(const MapPoint& pt, BuildingType type, unsigned count) const;
+    /// Get all buildings of 'type' with a distance to 'pt' of at most 'radius'.
+    std::vector<const Building*> GetInRadius(const MapPoint& pt, BuildingType type, unsigned radius) const;
+
+private:
+    static const unsigned CellSize = 8;
+    typedef std::vector<std::vector<const Building*>> Grid;
+
+    unsigned GetCell(const MapPoint& pt) const;
+
+    /// Call visitor(building) for all buildings of 'types' in rings of squares around 'pt'
+    /// as long as proceed(minDistance) returns true for the next ring.
+    template<class T_Visit, class T_Proceed>
+    void VisitRings(
+            const MapPoint& pt,
+            const std::vector<BuildingType>& types,
+            T_Visit visitor,
+            T_Proceed proceed) const;
+
+    /// Strict ordering by (distance, map index).
+    bool IsCloser(unsigned dist, const Building* building, unsigned otherDist, const Building* other) const;
+
+    const MapBase* world_ = nullptr;
+    MapExtent cells_;
+    /// One grid per building type. Only allocated once a building of that type is added.
+    std::array<Grid, NUM_BUILDING_TYPES> grids_;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_BUILDINGINDEX_H_INCLUDED
@@ -0,0 +1,90 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ai/beowulf/BuildingPool.h"
+
+#include <new>
+
+namespace beowulf {
+
+BuildingPool::~BuildingPool()
+{
+    for (unsigned i = 0; i < used_; ++i) {
+        Slot& slot = GetSlot(i);
+        if (slot.alive)
+            slot.Get()->~Building();
+    }
+}
+
+Building* BuildingPool::Create(World& world, BuildingType type, Building::State state)
+{
+    unsigned index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        if (used_ % SlabSize == 0)
+            slabs_.emplace_back(new Slot[SlabSize]);
+        index = used_++;
+    }
+
+    Slot& slot = GetSlot(index);
+    RTTR_Assert(!slot.alive);
+    Building* building = new (&slot.storage) Building(world, type, state);
+    building->poolIndex_ = index;
+    slot.alive = true;
+    size_++;
+    return building;
+}
+
+void BuildingPool::Destroy(Building* building)
+{
+    const unsigned index = building->poolIndex_;
+    Slot& slot = GetSlot(index);
+    RTTR_Assert(slot.alive && slot.Get() == building);
+
+    building->~Building();
+    slot.alive = false;
+    // Invalidates all handles of the building.
+    slot.generation++;
+    free_.push_back(index);
+    size_--;
+}
+
+BuildingHandle BuildingPool::GetHandle(const Building* building) const
+{
+    BuildingHandle handle;
+    if (!building)
+        return handle;
+
+    handle.index = building->poolIndex_;
+    handle.generation = GetSlot(handle.index).generation;
+    RTTR_Assert(GetSlot(handle.index).alive && GetSlot(handle.index).Get() == building);
+    return handle;
+}
+
+Building* BuildingPool::Get(const BuildingHandle& handle) const
+{
+    if (!handle.isValid() || handle.index >= used_)
+        return nullptr;
+    Slot& slot = GetSlot(handle.index);
+    if (!slot.alive || slot.generation != handle.generation)
+        return nullptr;
+    return slot.Get();
+}
+
+} // namespace beowulf
@@ -0,0 +1,124 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_BUILDINGPOOL_H_INCLUDED
+#define BEOWULF_BUILDINGPOOL_H_INCLUDED
+
+#include "ai/beowulf/Building.h"
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace beowulf {
+
+/**
+ * @brief Reference to a building that detects the removal of the building.
+ *
+ * Every slot of the pool counts its reuses. A handle is only resolved (see
+ * BuildingPool::Get()) as long as the slot was not reused.
+ */
+struct BuildingHandle
+{
+    static const unsigned InvalidIndex = std::numeric_limits<unsigned>::max();
+
+    unsigned index = InvalidIndex;
+    unsigned generation = 0;
+
+    bool isValid() const { return index != InvalidIndex; }
+    bool operator==(const BuildingHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const BuildingHandle& other) const { return !(*this == other); }
+    bool operator<(const BuildingHandle& other) const
+    {
+        return index < other.index || (index == other.index && generation < other.generation);
+    }
+
+    struct Hash
+    {
+        size_t operator()(const BuildingHandle& handle) const
+        {
+            return std::hash<unsigned long long>()((static_cast<unsigned long long>(handle.generation) << 32) | handle.index);
+        }
+    };
+};
+
+/**
+ * @brief Storage of all buildings of a World.
+ *
+ * Buildings live in slabs of SlabSize slots, so they are close together in memory and
+ * their addresses are stable. Slots of removed buildings are reused.
+ */
+class BuildingPool
+{
+public:
+    BuildingPool() = default;
+    BuildingPool(const BuildingPool&) = delete;
+    BuildingPool& operator=(const BuildingPool&) = delete;
+    ~BuildingPool();
+
+    Building* Create(World& world, BuildingType type, Building::State state);
+    void Destroy(Building* building);
+
+    /// Handle of a building of this pool.
+    BuildingHandle GetHandle(const Building* building) const;
+    /// Building of 'handle' or nullptr if it has been removed.
+    Building* Get(const BuildingHandle& handle) const;
+
+    /// Call func(building) for all buildings in the order of their slots.
+    template<typename Func>
+    void ForEach(Func func) const;
+
+    size_t GetSize() const { return size_; }
+
+private:
+    static const unsigned SlabSize = 64;
+
+    struct Slot
+    {
+        typename std::aligned_storage<sizeof(Building), alignof(Building)>::type storage;
+        unsigned generation = 0;
+        bool alive = false;
+
+        Building* Get() { return reinterpret_cast<Building*>(&storage); }
+    };
+
+    Slot& GetSlot(unsigned index) const { return slabs_[index / SlabSize][index % SlabSize]; }
+
+    std::vector<std::unique_ptr<Slot[]>> slabs_;
+    /// Slots of removed buildings.
+    std::vector<unsigned> free_;
+    /// Slots handed out so far.
+    unsigned used_ = 0;
+    /// Buildings alive.
+    size_t size_ = 0;
+};
+
+template<typename Func>
+void BuildingPool::ForEach(Func func) const
+{
+    for (unsigned i = 0; i < used_; ++i) {
+        Slot& slot = GetSlot(i);
+        if (slot.alive)
+            func(slot.Get());
+    }
+}
+
+} // namespace beowulf
+
+#endif //! BEOWULF_BUILDINGPOOL_H_INCLUDED
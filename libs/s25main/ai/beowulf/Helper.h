@@ -24,7 +24,6 @@
 
 #include <utility>
 #include <vector>
-#include <map>
 #include <queue>
 
 namespace beowulf {
@@ -89,81 +88,6 @@ void FloodFill(
     }
 }
 
-/**
- * @brief Search route from 'start' to the first point that matches the 'end' condition.
- */
-template<typename Condition, typename End, typename Heuristic, typename Cost>
-bool FindPath(
-        const MapPoint& start,
-        const MapBase& world,
-        std::vector<Direction>* route,
-        Condition condition,
-        End end,
-        Heuristic heuristic,
-        Cost cost)
-{
-    typedef unsigned distance_t;
-    typedef std::pair<MapPoint, distance_t> front_pos_t;
-
-    struct PosCompare
-    {
-        bool operator()(const front_pos_t& l, const front_pos_t& r) const
-        { return l.second > r.second; }
-    };
-    std::priority_queue<front_pos_t, std::vector<front_pos_t>, PosCompare> frontier;
-    std::map<MapPoint, Direction, MapPointComp> came_from; // @performance: use array?
-    std::map<MapPoint, distance_t, MapPointComp> cost_so_far;
-    cost_so_far[start] = 0;
-    MapPoint dest;
-
-    frontier.push({ start, 0 });
-
-    while (!frontier.empty()) {
-        MapPoint cur = frontier.top().first;
-        frontier.pop();
-
-        if (cur != start && end(cur)) {
-            dest = cur;
-            break;
-        }
-
-        for (const auto dir : helpers::EnumRange<Direction>{}) {
-            if (!condition(cur, dir))
-                continue;
-
-            distance_t new_cost = cost_so_far[cur] + cost(cur, dir);
-            MapPoint next = world.GetNeighbour(cur, dir);
-            if (cost_so_far.find(next) == cost_so_far.end() ||
-                    new_cost < cost_so_far[next])
-            {
-                cost_so_far[next] = new_cost;
-                frontier.push({ next, new_cost + heuristic(next) });
-                came_from[next] = dir;
-            }
-        }
-    }
-
-    if (!dest.isValid())
-        return false;
-
-    if (route) {
-        std::vector<Direction> reverse;
-        MapPoint cur = dest;
-        while (cur != start) {
-            Direction dir = came_from[cur];
-            reverse.push_back(dir);
-            cur = world.GetNeighbour(cur, OppositeDirection(dir));
-        }
-
-        route->clear();
-        route->reserve(reverse.size());
-        for (int i = reverse.size() - 1; i >= 0; --i)
-            route->push_back(reverse[i]);
-    }
-
-    return true;
-}
-
 inline MapPoint GetClosest(
         const MapBase& world,
         const MapPoint& ref,
@@ -113,7 +113,8 @@ double RateSmall(unsigned val, const std::vector<unsigned>& groups)
 bool BuildingPositionCosts::Score(
         std::vector<double>& score,
         const Building* building,
-        const MapPoint& pt)
+        const MapPoint& pt,
+        HumanPathSearch& search)
 {
     RTTR_Assert(!BuildingProperties::IsMilitary(building->GetType()));
 
@@ -132,7 +133,7 @@ bool BuildingPositionCosts::Score(
     const BuildingLocationChecks& checks = S_build_location_checks[building->GetType()];
     if (checks.requiredResources > 0) {
         BResourceType resourceType = REQUIRED_RESOURCES[building->GetType()];
-        unsigned resources = world_.resources.GetReachable(pt, resourceType);
+        unsigned resources = world_.resources.GetReachable(pt, resourceType, true, false, true, &search);
 
         // Only valid if enough resources are available.
         if (resources < checks.requiredResources)
@@ -168,9 +169,9 @@ bool BuildingPositionCosts::Score(
     {
         // Should have a lot of undiscovered area around.
         int undiscovered = 0;
-        aii_.gwb.VisitPointsInRadius(pt, VISUALRANGE_LOOKOUTTOWER,
-                                     [&](const MapPoint& pt)
-        { if (!aii_.IsVisible(pt)) undiscovered++; }, false);
+        world_.VisitPointsInRadius(pt, VISUALRANGE_LOOKOUTTOWER,
+                                   [&](const MapPoint& pt)
+        { if (!world_.CanSee(pt)) undiscovered++; }, false);
 
         if (undiscovered == 0)
             return false;
@@ -192,7 +193,7 @@ bool BuildingPositionCosts::Score(
 
     case BLD_WOODCUTTER:
     {
-        unsigned resources = world_.resources.GetReachable(pt, BResourceWood, true, true);
+        unsigned resources = world_.resources.GetReachable(pt, BResourceWood, true, true, true, &search);
 
         // If it is not part of group it needs wood in range.
         if (building->GetGroup() == InvalidProductionGroup && 0 == resources)
@@ -34,6 +34,7 @@ namespace beowulf {
 
 class Building;
 class World;
+struct HumanPathSearch;
 class Beowulf;
 
 // @todo: Rename
@@ -46,11 +47,14 @@ public:
     /*
      * Calculates a score vector for the given building at given point.
      * returns false if placement is invalid.
+     * Only reads the world and may be called concurrently for different points if every
+     * thread passes its own 'search'.
      */
     bool Score(
             std::vector<double>& score,
             const Building* building,
-            const MapPoint& pt);
+            const MapPoint& pt,
+            HumanPathSearch& search);
 
 private:
     const AIInterface& aii_;
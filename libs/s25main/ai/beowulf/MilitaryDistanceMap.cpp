@@ -0,0 +1,83 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ai/beowulf/MilitaryDistanceMap.h"
+
+#include "RttrForeachPt.h"
+
+#include <algorithm>
+
+namespace beowulf {
+
+void MilitaryDistanceMap::Init(const MapBase& world)
+{
+    distances_.Resize(world.GetSize());
+    Clear();
+}
+
+void MilitaryDistanceMap::Clear()
+{
+    sources_.clear();
+    RTTR_FOREACH_PT(MapPoint, distances_.GetSize()) {
+        distances_[pt] = None;
+    }
+}
+
+void MilitaryDistanceMap::Add(const MapPoint& pt, unsigned radius)
+{
+    RTTR_Assert(radius < None);
+
+    const unsigned idx = distances_.GetIdx(pt);
+    auto it = std::upper_bound(sources_.begin(), sources_.end(), idx,
+        [this](unsigned i, const Source& source) { return i < distances_.GetIdx(source.pt); });
+    sources_.insert(it, { pt, radius });
+
+    distances_.VisitPointsInRadius(pt, radius, [&](const MapPoint& p)
+    {
+        const uint8_t distance = static_cast<uint8_t>(distances_.CalcDistance(pt, p));
+        if (distance < distances_[p])
+            distances_[p] = distance;
+    }, true);
+}
+
+void MilitaryDistanceMap::Remove(const MapPoint& pt, unsigned radius)
+{
+    auto it = std::find_if(sources_.begin(), sources_.end(),
+        [&](const Source& source) { return source.pt == pt && source.radius == radius; });
+    RTTR_Assert(it != sources_.end());
+    sources_.erase(it);
+
+    // Only buildings that overlap with the removed one can cover its nodes.
+    std::vector<Source> overlapping;
+    for (const Source& source : sources_) {
+        if (distances_.CalcDistance(pt, source.pt) <= radius + source.radius)
+            overlapping.push_back(source);
+    }
+
+    distances_.VisitPointsInRadius(pt, radius, [&](const MapPoint& p)
+    {
+        uint8_t closest = None;
+        for (const Source& source : overlapping) {
+            const unsigned distance = distances_.CalcDistance(source.pt, p);
+            if (distance <= source.radius && distance < closest)
+                closest = static_cast<uint8_t>(distance);
+        }
+        distances_[p] = closest;
+    }, true);
+}
+
+} // namespace beowulf
@@ -0,0 +1,70 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_MILITARYDISTANCEMAP_H_INCLUDED
+#define BEOWULF_MILITARYDISTANCEMAP_H_INCLUDED
+
+#include "world/NodeMapBase.h"
+#include "gameTypes/MapCoordinates.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace beowulf {
+
+/**
+ * @brief Distance of every node to the closest military building covering it.
+ *
+ * A building covers all nodes within its military radius. Adding a building only
+ * updates the nodes it covers. Removing one recalculates them from the buildings close by.
+ */
+class MilitaryDistanceMap
+{
+public:
+    static const unsigned NotCovered = std::numeric_limits<unsigned>::max();
+
+    void Init(const MapBase& world);
+
+    void Add(const MapPoint& pt, unsigned radius);
+    void Remove(const MapPoint& pt, unsigned radius);
+    void Clear();
+
+    /// Distance to the closest covering building or NotCovered.
+    unsigned Get(const MapPoint& pt) const
+    {
+        const uint8_t distance = distances_[pt];
+        return distance == None ? NotCovered : distance;
+    }
+
+    /// Buildings ordered by map index.
+    struct Source
+    {
+        MapPoint pt;
+        unsigned radius;
+    };
+    const std::vector<Source>& GetSources() const { return sources_; }
+
+private:
+    static const uint8_t None = 0xFF;
+
+    NodeMapBase<uint8_t> distances_;
+    std::vector<Source> sources_;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_MILITARYDISTANCEMAP_H_INCLUDED
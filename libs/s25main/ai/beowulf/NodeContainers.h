@@ -0,0 +1,297 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_NODECONTAINERS_H_INCLUDED
+#define BEOWULF_NODECONTAINERS_H_INCLUDED
+
+#include "world/MapBase.h"
+#include "gameTypes/MapCoordinates.h"
+
+#include "RTTR_Assert.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace beowulf {
+
+/**
+ * @brief Dense map from node indices (MapBase::GetIdx()) to values, cleared in constant time.
+ *
+ * Every node carries the generation it was last written in. Clear() only starts a new
+ * generation, so the map suits scratch data of searches over large parts of the map.
+ */
+template<typename T>
+class StampedNodeMap
+{
+public:
+    void Resize(size_t numNodes)
+    {
+        values_.assign(numNodes, T());
+        stamps_.assign(numNodes, 0);
+        generation_ = 1;
+    }
+    size_t GetSize() const { return values_.size(); }
+
+    void Clear()
+    {
+        if (++generation_ == 0) {
+            std::fill(stamps_.begin(), stamps_.end(), 0);
+            generation_ = 1;
+        }
+    }
+
+    bool Contains(size_t idx) const { return stamps_[idx] == generation_; }
+    /// Value at 'idx'. Inserted with T() if not yet written in this generation.
+    T& operator[](size_t idx)
+    {
+        if (stamps_[idx] != generation_) {
+            stamps_[idx] = generation_;
+            values_[idx] = T();
+        }
+        return values_[idx];
+    }
+    const T* Find(size_t idx) const { return Contains(idx) ? &values_[idx] : nullptr; }
+
+private:
+    std::vector<T> values_;
+    std::vector<uint32_t> stamps_;
+    uint32_t generation_ = 1;
+};
+
+/**
+ * @brief Dense set of node indices, cleared in constant time (see StampedNodeMap).
+ */
+class StampedNodeSet
+{
+public:
+    void Resize(size_t numNodes)
+    {
+        stamps_.assign(numNodes, 0);
+        generation_ = 1;
+    }
+    size_t GetSize() const { return stamps_.size(); }
+
+    void Clear()
+    {
+        if (++generation_ == 0) {
+            std::fill(stamps_.begin(), stamps_.end(), 0);
+            generation_ = 1;
+        }
+    }
+
+    bool Contains(size_t idx) const { return stamps_[idx] == generation_; }
+    /// Returns false if 'idx' already was in the set.
+    bool Insert(size_t idx)
+    {
+        if (stamps_[idx] == generation_)
+            return false;
+        stamps_[idx] = generation_;
+        return true;
+    }
+
+private:
+    std::vector<uint32_t> stamps_;
+    uint32_t generation_ = 1;
+};
+
+/**
+ * @brief Scratch buffers of a breadth first search for human paths (see World::FindHumanPath()).
+ *
+ * Searches sharing one instance must not run concurrently. Threads use one instance each.
+ */
+struct HumanPathSearch
+{
+    StampedNodeSet visited;
+    std::vector<std::pair<MapPoint, unsigned>> queue;
+};
+
+/**
+ * @brief Sparse map from points to values (open addressing with linear probing).
+ *
+ * Keys are hashed by their node index (MapBase::GetIdx()). Iteration follows the slots,
+ * which is deterministic but unordered. Inserting or erasing invalidates iterators.
+ */
+template<typename T>
+class PointHashMap
+{
+public:
+    typedef std::pair<MapPoint, T> value_type;
+
+private:
+    static const unsigned Empty = std::numeric_limits<unsigned>::max();
+
+    struct Slot
+    {
+        unsigned key = Empty;
+        value_type value;
+    };
+
+    template<typename T_Slot, typename T_Value>
+    class Iterator
+    {
+    public:
+        Iterator(T_Slot* cur, T_Slot* end) : cur_(cur), end_(end) { Skip(); }
+
+        T_Value& operator*() const { return cur_->value; }
+        T_Value* operator->() const { return &cur_->value; }
+        Iterator& operator++()
+        {
+            ++cur_;
+            Skip();
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return cur_ == other.cur_; }
+        bool operator!=(const Iterator& other) const { return cur_ != other.cur_; }
+
+    private:
+        void Skip()
+        {
+            while (cur_ != end_ && cur_->key == Empty)
+                ++cur_;
+        }
+
+        T_Slot* cur_;
+        T_Slot* end_;
+    };
+
+public:
+    typedef Iterator<Slot, value_type> iterator;
+    typedef Iterator<const Slot, const value_type> const_iterator;
+
+    explicit PointHashMap(const MapBase& world) : world_(&world) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear()
+    {
+        slots_.clear();
+        size_ = 0;
+        bits_ = 0;
+    }
+
+    iterator begin() { return iterator(slots_.data(), slots_.data() + slots_.size()); }
+    iterator end() { return iterator(slots_.data() + slots_.size(), slots_.data() + slots_.size()); }
+    const_iterator begin() const { return const_iterator(slots_.data(), slots_.data() + slots_.size()); }
+    const_iterator end() const { return const_iterator(slots_.data() + slots_.size(), slots_.data() + slots_.size()); }
+
+    /// Value of 'pt'. Inserted with T() if not present.
+    T& operator[](const MapPoint& pt)
+    {
+        const unsigned key = world_->GetIdx(pt);
+        size_t pos;
+        if (Lookup(key, pos))
+            return slots_[pos].value.second;
+
+        // Keep the load factor at or below 1/2.
+        if ((size_ + 1) * 2 > slots_.size()) {
+            Grow();
+            Lookup(key, pos);
+        }
+        slots_[pos].key = key;
+        slots_[pos].value = value_type(pt, T());
+        size_++;
+        return slots_[pos].value.second;
+    }
+
+    T* Find(const MapPoint& pt)
+    {
+        size_t pos;
+        return Lookup(world_->GetIdx(pt), pos) ? &slots_[pos].value.second : nullptr;
+    }
+    const T* Find(const MapPoint& pt) const
+    {
+        size_t pos;
+        return Lookup(world_->GetIdx(pt), pos) ? &slots_[pos].value.second : nullptr;
+    }
+
+    /// Returns false if 'pt' was not in the map.
+    bool erase(const MapPoint& pt)
+    {
+        size_t pos;
+        if (!Lookup(world_->GetIdx(pt), pos))
+            return false;
+
+        // Move later entries of the probe sequence into the gap (no tombstones).
+        const size_t mask = slots_.size() - 1;
+        size_t gap = pos;
+        for (size_t next = (gap + 1) & mask; slots_[next].key != Empty; next = (next + 1) & mask) {
+            const size_t home = Home(slots_[next].key);
+            // Entries whose home lies cyclically in (gap, next] have to stay.
+            const bool stays = gap <= next ? (gap < home && home <= next) : (gap < home || home <= next);
+            if (!stays) {
+                slots_[gap] = std::move(slots_[next]);
+                gap = next;
+            }
+        }
+        slots_[gap] = Slot();
+        size_--;
+        return true;
+    }
+
+private:
+    size_t Home(unsigned key) const
+    {
+        // Fibonacci hashing, neighbouring indices end up in different slots.
+        return static_cast<size_t>((key * 2654435769u) >> (32 - bits_));
+    }
+
+    /// Position of 'key' (returns true) or of the empty slot it would be inserted at.
+    bool Lookup(unsigned key, size_t& pos) const
+    {
+        if (slots_.empty()) {
+            pos = 0;
+            return false;
+        }
+        const size_t mask = slots_.size() - 1;
+        for (pos = Home(key); slots_[pos].key != Empty; pos = (pos + 1) & mask) {
+            if (slots_[pos].key == key)
+                return true;
+        }
+        return false;
+    }
+
+    void Grow()
+    {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        bits_ = old.empty() ? 3 : bits_ + 1;
+        RTTR_Assert(bits_ < 32);
+        slots_.resize(size_t(1) << bits_);
+
+        const size_t mask = slots_.size() - 1;
+        for (Slot& slot : old) {
+            if (slot.key == Empty)
+                continue;
+            size_t pos = Home(slot.key);
+            while (slots_[pos].key != Empty)
+                pos = (pos + 1) & mask;
+            slots_[pos] = std::move(slot);
+        }
+    }
+
+    const MapBase* world_;
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+    unsigned bits_ = 0;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_NODECONTAINERS_H_INCLUDED
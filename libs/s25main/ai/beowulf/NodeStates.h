@@ -0,0 +1,99 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_NODESTATES_H_INCLUDED
+#define BEOWULF_NODESTATES_H_INCLUDED
+
+#include "ai/beowulf/Types.h"
+
+#include "RTTR_Assert.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace beowulf {
+
+/**
+ * @brief Flag and road states of every node in compact planes.
+ *
+ * Each node owns the roads to its eastern, south-eastern and south-western neighbours
+ * (see World::GetRoadSlot()).
+ * The flag state and the three road states take two bits each and share one byte.
+ * The plan counters of the flag and the roads of a node are four consecutive bytes.
+ */
+class NodeStates
+{
+public:
+    void Resize(size_t numNodes)
+    {
+        states_.assign(numNodes, 0);
+        planCounts_.assign(numNodes * 4, 0);
+    }
+
+    FlagState GetFlag(size_t idx) const { return static_cast<FlagState>(states_[idx] & 0x3); }
+    void SetFlag(size_t idx, FlagState state) { Set(idx, 0, state); }
+    RoadState GetRoad(size_t idx, unsigned i) const { return static_cast<RoadState>((states_[idx] >> Shift(i + 1)) & 0x3); }
+    void SetRoad(size_t idx, unsigned i, RoadState state) { Set(idx, i + 1, state); }
+
+    bool IsFlagPlanned(size_t idx) const { return planCounts_[idx * 4] > 0; }
+    bool IsRoadPlanned(size_t idx, unsigned i) const { return planCounts_[idx * 4 + i + 1] > 0; }
+    /// Count another plan. Returns the previous count.
+    uint8_t PlanFlag(size_t idx) { return Increase(planCounts_[idx * 4]); }
+    uint8_t PlanRoad(size_t idx, unsigned i) { return Increase(planCounts_[idx * 4 + i + 1]); }
+    /// Undo plans by restoring the count returned by PlanFlag()/PlanRoad().
+    void RestoreFlagPlan(size_t idx, uint8_t count) { planCounts_[idx * 4] = count; }
+    void RestoreRoadPlan(size_t idx, unsigned i, uint8_t count) { planCounts_[idx * 4 + i + 1] = count; }
+
+    /// Requested, finished or planned flag.
+    bool HasFlag(size_t idx) const
+    {
+        const FlagState state = GetFlag(idx);
+        return state == FlagRequested || state == FlagFinished || IsFlagPlanned(idx);
+    }
+    /// Requested, finished or planned road.
+    bool HasRoad(size_t idx, unsigned i) const
+    {
+        const RoadState state = GetRoad(idx, i);
+        return state == RoadRequested || state == RoadFinished || IsRoadPlanned(idx, i);
+    }
+
+private:
+    static unsigned Shift(unsigned slot) { return 2 * slot; }
+
+    void Set(size_t idx, unsigned slot, unsigned state)
+    {
+        RTTR_Assert(state < 4);
+        states_[idx] = static_cast<uint8_t>((states_[idx] & ~(0x3 << Shift(slot))) | (state << Shift(slot)));
+    }
+
+    /// Plans are only counted to find the first one. The counters saturate.
+    static uint8_t Increase(uint8_t& count)
+    {
+        const uint8_t previous = count;
+        if (count < std::numeric_limits<uint8_t>::max())
+            count++;
+        return previous;
+    }
+
+    std::vector<uint8_t> states_;
+    std::vector<uint8_t> planCounts_;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_NODESTATES_H_INCLUDED
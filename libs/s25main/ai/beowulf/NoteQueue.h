@@ -0,0 +1,82 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_NOTEQUEUE_H_INCLUDED
+#define BEOWULF_NOTEQUEUE_H_INCLUDED
+
+#include "notifications/RoadNote.h"
+
+#include <functional>
+#include <vector>
+
+namespace beowulf {
+
+/**
+ * @brief Delivers game notifications to Beowulf or holds them back.
+ *
+ * While Beowulf plans in the background, its state must not change. Notifications
+ * that arrive in the meantime are stored and delivered in their original order once
+ * the planning finished.
+ */
+class NoteQueue
+{
+public:
+    /// Call handler(note) now or, while deferring, on the next Flush().
+    template<class T_Note, class T_Handler>
+    void Dispatch(const T_Note& note, T_Handler handler)
+    {
+        if (deferring_)
+            queue_.push_back([note, handler]() { handler(note); });
+        else
+            handler(note);
+    }
+
+    /// RoadNote only refers to the route of the publisher, which is gone by the next Flush().
+    /// Deferred road notes keep their own copy of the route.
+    template<class T_Handler>
+    void Dispatch(const RoadNote& note, T_Handler handler)
+    {
+        if (deferring_) {
+            queue_.push_back([type = note.type, player = note.player, pos = note.pos, route = note.route, handler]()
+            {
+                handler(RoadNote(type, player, pos, route));
+            });
+        } else {
+            handler(note);
+        }
+    }
+
+    void Defer() { deferring_ = true; }
+    bool IsDeferring() const { return deferring_; }
+
+    /// Deliver all held back notifications and stop deferring.
+    void Flush()
+    {
+        deferring_ = false;
+        // Handlers do not raise notifications themselves.
+        for (const std::function<void()>& handler : queue_)
+            handler();
+        queue_.clear();
+    }
+
+private:
+    bool deferring_ = false;
+    std::vector<std::function<void()>> queue_;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_NOTEQUEUE_H_INCLUDED
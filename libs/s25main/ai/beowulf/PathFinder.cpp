@@ -0,0 +1,61 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ai/beowulf/PathFinder.h"
+
+#include <limits>
+
+namespace beowulf {
+
+void PathFinder::Init(const MapBase& world)
+{
+    RTTR_Assert(!searching_);
+    world_ = &world;
+    currentVisit_ = 0;
+    nodes_.clear();
+    nodes_.resize(world.GetSize().x * world.GetSize().y);
+    buckets_.clear();
+    minBucket_ = 0;
+    maxBucket_ = 0;
+    queued_ = 0;
+}
+
+void PathFinder::IncreaseCurrentVisit()
+{
+    // If the counter reaches its maximum, tidy up.
+    if (currentVisit_ == std::numeric_limits<unsigned>::max()) {
+        for (Node& node : nodes_)
+            node.lastVisited = 0;
+        currentVisit_ = 1;
+    } else {
+        currentVisit_++;
+    }
+}
+
+void PathFinder::ClearQueue()
+{
+    if (buckets_.empty())
+        return;
+
+    for (unsigned i = minBucket_; i <= maxBucket_; ++i)
+        buckets_[i].clear();
+    minBucket_ = 0;
+    maxBucket_ = 0;
+    queued_ = 0;
+}
+
+} // namespace beowulf
@@ -0,0 +1,205 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_PATHFINDER_H_INCLUDED
+#define BEOWULF_PATHFINDER_H_INCLUDED
+
+#include "ai/beowulf/Helper.h"
+
+#include "world/MapBase.h"
+#include "gameTypes/MapCoordinates.h"
+#include "gameTypes/Direction.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace beowulf {
+
+/**
+ * @brief A* search on the map geometry with reusable scratch buffers.
+ *
+ * Node data is kept in a flat array indexed by MapBase::GetIdx() and is invalidated
+ * by increasing a visit counter instead of clearing it. The open list is a bucket
+ * queue over the (small integer) estimated costs.
+ * Once initialized, searches do not allocate memory.
+ * There is one instance per World (World::GetPathFinder()). As it is shared, searches
+ * must not be nested, e.g. by searching again from within a callback.
+ */
+class PathFinder
+{
+public:
+    PathFinder() = default;
+
+    /// Resize the scratch buffers to the size of 'world'. The world must outlive this object.
+    void Init(const MapBase& world);
+
+    /**
+     * @brief Search route from 'start' to the first point that matches the 'end' condition.
+     * Must not be called while another search of this object is running.
+     *
+     * Condition: bool(const MapPoint& pt, Direction dir)  - Can we go from 'pt' in direction 'dir'?
+     * End:       bool(const MapPoint& pt)                 - Is 'pt' a destination?
+     * Heuristic: unsigned(const MapPoint& pt)             - Estimated remaining cost.
+     * Cost:      unsigned(const MapPoint& pt, Direction dir)
+     */
+    template<typename Condition, typename End, typename Heuristic, typename Cost>
+    bool FindPath(
+            const MapPoint& start,
+            std::vector<Direction>* route,
+            Condition condition,
+            End end,
+            Heuristic heuristic,
+            Cost cost);
+
+private:
+    struct Node
+    {
+        /// Node data is only valid if lastVisited == currentVisit_.
+        unsigned lastVisited = 0;
+        /// Cost from start to this node.
+        unsigned cost = 0;
+        /// Cost plus heuristic at the time the node was queued.
+        unsigned estimate = 0;
+        /// Direction we came from.
+        Direction dir;
+    };
+
+    void IncreaseCurrentVisit();
+
+    // Bucket queue
+    void Push(const MapPoint& pt, unsigned key);
+    bool Pop(MapPoint& pt, unsigned& key);
+    void ClearQueue();
+
+    const MapBase* world_ = nullptr;
+    std::vector<Node> nodes_;
+    unsigned currentVisit_ = 0;
+
+    std::vector<std::vector<MapPoint>> buckets_;
+    unsigned minBucket_ = 0;
+    unsigned maxBucket_ = 0;
+    unsigned queued_ = 0;
+
+    // Searches must not be nested (e.g. from within a condition).
+    bool searching_ = false;
+};
+
+template<typename Condition, typename End, typename Heuristic, typename Cost>
+bool PathFinder::FindPath(
+        const MapPoint& start,
+        std::vector<Direction>* route,
+        Condition condition,
+        End end,
+        Heuristic heuristic,
+        Cost cost)
+{
+    RTTR_Assert(world_);
+    RTTR_Assert(!searching_);
+    searching_ = true;
+
+    IncreaseCurrentVisit();
+
+    Node& startNode = nodes_[world_->GetIdx(start)];
+    startNode.lastVisited = currentVisit_;
+    startNode.cost = 0;
+    startNode.estimate = 0;
+    Push(start, 0);
+
+    MapPoint dest = MapPoint::Invalid();
+    MapPoint cur;
+    unsigned key;
+
+    while (Pop(cur, key)) {
+        const Node& node = nodes_[world_->GetIdx(cur)];
+
+        // Skip outdated entries. The node has been queued again with a lower cost.
+        if (key != node.estimate)
+            continue;
+
+        if (cur != start && end(cur)) {
+            dest = cur;
+            break;
+        }
+
+        const unsigned curCost = node.cost;
+
+        for (const auto dir : helpers::EnumRange<Direction>{}) {
+            if (!condition(cur, dir))
+                continue;
+
+            unsigned newCost = curCost + static_cast<unsigned>(cost(cur, dir));
+            MapPoint next = world_->GetNeighbour(cur, dir);
+            Node& nextNode = nodes_[world_->GetIdx(next)];
+            if (nextNode.lastVisited != currentVisit_ || newCost < nextNode.cost) {
+                nextNode.lastVisited = currentVisit_;
+                nextNode.cost = newCost;
+                nextNode.estimate = newCost + static_cast<unsigned>(heuristic(next));
+                nextNode.dir = dir;
+                Push(next, nextNode.estimate);
+            }
+        }
+    }
+
+    ClearQueue();
+    searching_ = false;
+
+    if (!dest.isValid())
+        return false;
+
+    if (route) {
+        route->clear();
+        for (MapPoint pt = dest; pt != start;) {
+            Direction dir = nodes_[world_->GetIdx(pt)].dir;
+            route->push_back(dir);
+            pt = world_->GetNeighbour(pt, OppositeDirection(dir));
+        }
+        std::reverse(route->begin(), route->end());
+    }
+
+    return true;
+}
+
+inline void PathFinder::Push(const MapPoint& pt, unsigned key)
+{
+    if (key >= buckets_.size())
+        buckets_.resize(key + 1);
+    buckets_[key].push_back(pt);
+
+    if (0 == queued_ || key < minBucket_)
+        minBucket_ = key;
+    maxBucket_ = std::max(maxBucket_, key);
+    queued_++;
+}
+
+inline bool PathFinder::Pop(MapPoint& pt, unsigned& key)
+{
+    if (0 == queued_)
+        return false;
+
+    while (buckets_[minBucket_].empty())
+        minBucket_++;
+
+    std::vector<MapPoint>& bucket = buckets_[minBucket_];
+    pt = bucket.back();
+    bucket.pop_back();
+    key = minBucket_;
+    queued_--;
+    return true;
+}
+
+} // namespace beowulf
+
+#endif //! BEOWULF_PATHFINDER_H_INCLUDED
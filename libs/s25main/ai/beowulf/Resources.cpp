@@ -29,12 +29,14 @@
 #include "EventManager.h"
 #include "notifications/BuildingNote.h"
 #include "notifications/ResourceNote.h"
+#include "notifications/NodeNote.h"
+#include "notifications/PlayerNodeNote.h"
+#include "RttrForeachPt.h"
 
-#include <boost/lambda/bind.hpp>
-#include <boost/lambda/if.hpp>
-#include <boost/lambda/lambda.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+
 namespace beowulf {
 
 // Map Resource to BResourceType
@@ -59,6 +61,21 @@ static const unsigned S_resource_radius[BResourceCount] = {
     FISHER_RADIUS, 20, WOODCUTTER_RADIUS, STONEMASON_RADIUS
 };
 
+// Types that Calculate() may guess for.
+static const bool S_resource_guessed[BResourceCount] = {
+    true, true, true, true, false, false, false,
+    true, false, false, false
+};
+
+// Types that need a path check (see IsReachable()). Their sums are upper bounds only.
+static const bool S_resource_needs_path[BResourceCount] = {
+    false, false, false, false, false, false, false,
+    true, true, true, true
+};
+
+// Every point is recalculated at least once in this many calls to Refresh().
+static const unsigned S_refresh_runs = 64;
+
 Resources::Node::Node()
 {
     underground.fill(0);
@@ -72,13 +89,50 @@ Resources::Resources(AIInterface& aii, World& world, bool fow)
 {
     nodes_.Resize(aii.gwb.GetSize());
 
+    const unsigned size = aii.gwb.GetSize().x * aii.gwb.GetSize().y;
+    for (unsigned t = 0; t < BResourceCount; ++t) {
+        Layer& layer = layers_[t];
+        layer.value.resize(size);
+        if (S_resource_guessed[t])
+            layer.guess.resize(size);
+        for (unsigned i = 0; i < layer.sums.size(); ++i) {
+            const bool weighted = (i & 4) != 0;
+            const bool guess = (i & 1) != 0;
+            if (weighted && S_resource_needs_path[t])
+                continue;
+            if (guess && !S_resource_guessed[t])
+                continue;
+            layer.sums[i].resize(size);
+        }
+    }
+
+    RTTR_FOREACH_PT(MapPoint, nodes_.GetSize()) {
+        Refresh(pt);
+    }
+
     NotificationManager& notifications = aii.gwb.GetNotifications();
-    eventSubscriptions_.push_back(notifications.subscribe<BuildingNote>(
-        boost::lambda::if_(boost::lambda::bind(&BuildingNote::player, boost::lambda::_1) == aii_.GetPlayerId())
-                                      [boost::lambda::bind(&Resources::OnBuildingNote, this, boost::lambda::_1)]));
-    eventSubscriptions_.push_back(notifications.subscribe<ResourceNote>(
-        boost::lambda::if_(boost::lambda::bind(&ResourceNote::player, boost::lambda::_1) == aii_.GetPlayerId())
-                                      [boost::lambda::bind(&Resources::OnResourceNote, this, boost::lambda::_1)]));
+    eventSubscriptions_.push_back(notifications.subscribe<BuildingNote>([this](const BuildingNote& note)
+    {
+        if (note.player == aii_.GetPlayerId())
+            world_.notes.Dispatch(note, [this](const BuildingNote& note) { OnBuildingNote(note); });
+    }));
+    eventSubscriptions_.push_back(notifications.subscribe<ResourceNote>([this](const ResourceNote& note)
+    {
+        if (note.player == aii_.GetPlayerId())
+            world_.notes.Dispatch(note, [this](const ResourceNote& note) { OnResourceNote(note); });
+    }));
+    eventSubscriptions_.push_back(notifications.subscribe<NodeNote>([this](const NodeNote& note)
+    {
+        if (note.type == NodeNote::BQ)
+            world_.notes.Dispatch(note, [this](const NodeNote& note) { OnNodeNote(note); });
+    }));
+    if (fow_) {
+        eventSubscriptions_.push_back(notifications.subscribe<PlayerNodeNote>([this](const PlayerNodeNote& note)
+        {
+            if (note.player == aii_.GetPlayerId())
+                world_.notes.Dispatch(note, [this](const PlayerNodeNote& note) { OnPlayerNodeNote(note); });
+        }));
+    }
 }
 
 unsigned Resources::GetReachable(
@@ -86,20 +140,29 @@ unsigned Resources::GetReachable(
         BResourceType type,
         bool weigthDistance,
         bool ignoreOtherBuildings,
-        bool guess)
+        bool guess,
+        HumanPathSearch* search)
 {
-    unsigned ret = 0;
-    const Node& node = nodes_[pt];
+    const unsigned idx = nodes_.GetIdx(pt);
+
+    if (!S_resource_needs_path[type])
+        return GetSums(type, weigthDistance, guess, !ignoreOtherBuildings)[idx];
 
+    // Nothing to search for.
+    if (GetSums(type, false, guess, !ignoreOtherBuildings)[idx] == 0)
+        return 0;
+
+    unsigned ret = 0;
+    const std::vector<unsigned>& values = GetValues(type, guess);
     unsigned radius = S_resource_radius[type];
     nodes_.VisitPointsInRadius(pt, radius, [&](const MapPoint& p)
     {
-        if (!ignoreOtherBuildings && node.harvested[type] > 0)
+        if (!ignoreOtherBuildings && nodes_[p].harvested[type] > 0)
             return;
 
-        unsigned count = Get(p, type, guess);
+        unsigned count = values[nodes_.GetIdx(p)];
         if (count > 0) {
-            if (IsReachable(p, pt, type)) {
+            if (IsReachable(p, pt, type, search ? *search : search_)) {
                 if (weigthDistance) {
                     ret += ((radius + 1) - nodes_.CalcDistance(pt, p)) * count;
                 } else {
@@ -121,25 +184,28 @@ std::array<unsigned, BResourceCount> Resources::GetReachable(
     std::array<unsigned, BResourceCount> ret;
     ret.fill(0);
 
-    const Node& node = nodes_[pt];
+    const MapExtent& mapSize = nodes_.GetSize();
+    if (visited.GetSize() != static_cast<size_t>(mapSize.x) * mapSize.y)
+        visited.Resize(static_cast<size_t>(mapSize.x) * mapSize.y);
 
     for (unsigned t = 0; t < BResourceCount; ++t) {
         BResourceType type = static_cast<BResourceType>(t);
 
+        const std::vector<unsigned>& values = GetValues(type, guess);
         unsigned radius = S_resource_radius[type];
         nodes_.VisitPointsInRadius(pt, radius, [&](const MapPoint& p)
         {
-            std::bitset<BResourceCount>& visitedResource = visited[p];
+            std::bitset<BResourceCount>& visitedResource = visited[nodes_.GetIdx(p)];
             if (visitedResource[type])
                 return;
             visitedResource[type] = true;
 
-            if (!ignoreOtherBuildings && node.harvested[type] > 0)
+            if (!ignoreOtherBuildings && nodes_[p].harvested[type] > 0)
                 return;
 
-            unsigned count = Get(p, type, guess);
+            unsigned count = values[nodes_.GetIdx(p)];
             if (count > 0) {
-                if (IsReachable(p, pt, type)) {
+                if (IsReachable(p, pt, type, search_)) {
                     ret[type] += count;
                 }
             }
@@ -149,9 +215,120 @@ std::array<unsigned, BResourceCount> Resources::GetReachable(
     return ret;
 }
 
-unsigned Resources::Get(const MapPoint& pt, BResourceType type, bool guess)
+unsigned Resources::Get(const MapPoint& pt, BResourceType type, bool guess) const
+{
+    return GetValues(type, guess)[nodes_.GetIdx(pt)];
+}
+
+const std::vector<unsigned>& Resources::GetValues(BResourceType type, bool guess) const
+{
+    const Layer& layer = layers_[type];
+    return guess && S_resource_guessed[type] ? layer.guess : layer.value;
+}
+
+void Resources::Refresh()
+{
+    const MapExtent& mapSize = nodes_.GetSize();
+
+    // Animals move, trees are felled and grow, stones, fish and ores are used up. Changes that
+    // alter the building quality are handled by OnNodeNote() already. This covers the rest in
+    // the areas we care about. Other points follow with the sweep below.
+    for (const auto& workArea : workAreas_) {
+        nodes_.VisitPointsInRadius(workArea.first, S_resource_radius[workArea.second], [&](const MapPoint& p)
+        {
+            Refresh(p, workArea.second);
+        }, true);
+    }
+
+    const unsigned size = mapSize.x * mapSize.y;
+    const unsigned count = (size + S_refresh_runs - 1) / S_refresh_runs;
+    for (unsigned i = 0; i < count; ++i) {
+        if (nextRefresh_ >= size)
+            nextRefresh_ = 0;
+        Refresh(MapPoint(nextRefresh_ % mapSize.x, nextRefresh_ / mapSize.x));
+        nextRefresh_++;
+    }
+}
+
+void Resources::Refresh(const MapPoint& pt)
+{
+    for (unsigned t = 0; t < BResourceCount; ++t)
+        Refresh(pt, static_cast<BResourceType>(t));
+}
+
+void Resources::Refresh(const MapPoint& pt, BResourceType type)
+{
+    unsigned value = Calculate(pt, type, false);
+    unsigned guess = S_resource_guessed[type] ? Calculate(pt, type, true) : value;
+    SetValue(pt, type, value, guess);
+}
+
+void Resources::SetValue(const MapPoint& pt, BResourceType type, unsigned value, unsigned guess)
+{
+    Layer& layer = layers_[type];
+    const unsigned idx = nodes_.GetIdx(pt);
+
+    // Differences are applied modulo 2^32, the sums can't become negative.
+    const unsigned valueDiff = value - layer.value[idx];
+    const unsigned guessDiff = S_resource_guessed[type] ? guess - layer.guess[idx] : 0;
+    if (valueDiff == 0 && guessDiff == 0)
+        return;
+
+    layer.value[idx] = value;
+    if (S_resource_guessed[type])
+        layer.guess[idx] = guess;
+
+    const bool unharvested = nodes_[pt].harvested[type] == 0;
+    AddToSums(pt, type, { valueDiff, guessDiff, unharvested ? valueDiff : 0, unharvested ? guessDiff : 0 });
+}
+
+void Resources::SetHarvested(const MapPoint& pt, BResourceType type, bool harvested)
+{
+    const Layer& layer = layers_[type];
+    const unsigned idx = nodes_.GetIdx(pt);
+
+    const unsigned value = layer.value[idx];
+    const unsigned guess = S_resource_guessed[type] ? layer.guess[idx] : 0;
+    if (harvested)
+        AddToSums(pt, type, { 0, 0, 0 - value, 0 - guess });
+    else
+        AddToSums(pt, type, { 0, 0, value, guess });
+}
+
+void Resources::AddToSums(const MapPoint& pt, BResourceType type, const std::array<unsigned, 4>& diffs)
+{
+    Layer& layer = layers_[type];
+
+    // Every point in radius has 'pt' within its radius as well.
+    const unsigned radius = S_resource_radius[type];
+    nodes_.VisitPointsInRadius(pt, radius, [&](const MapPoint& p)
+    {
+        const unsigned i = nodes_.GetIdx(p);
+        const unsigned weight = (radius + 1) - nodes_.CalcDistance(pt, p);
+        for (unsigned s = 0; s < layer.sums.size(); ++s) {
+            if (layer.sums[s].empty())
+                continue;
+            const unsigned diff = diffs[s & 3];
+            layer.sums[s][i] += (s & 4) ? weight * diff : diff;
+        }
+    }, true);
+}
+
+unsigned Resources::SumIdx(BResourceType type, bool weighted, bool guess, bool unharvested)
+{
+    return (weighted ? 4 : 0) | (unharvested ? 2 : 0) | (guess && S_resource_guessed[type] ? 1 : 0);
+}
+
+const std::vector<unsigned>& Resources::GetSums(BResourceType type, bool weighted, bool guess, bool unharvested) const
 {
-    Node& node = nodes_[pt];
+    const std::vector<unsigned>& sums = layers_[type].sums[SumIdx(type, weighted, guess, unharvested)];
+    RTTR_Assert(!sums.empty());
+    return sums;
+}
+
+unsigned Resources::Calculate(const MapPoint& pt, BResourceType type, bool guess) const
+{
+    const Node& node = nodes_[pt];
 
     const Resource res = aii_.gwb.GetNode(pt).resources;
 
@@ -227,8 +404,35 @@ unsigned Resources::Get(const MapPoint& pt, BResourceType type, bool guess)
     return 0;
 }
 
+BResourceType Resources::GetChangedResource(BuildingType type)
+{
+    switch (type) {
+    case BLD_WOODCUTTER:
+    case BLD_FORESTER:
+        return BResourceWood;
+    case BLD_QUARRY:
+        return BResourceStone;
+    case BLD_FISHERY:
+        return BResourceFish;
+    case BLD_HUNTER:
+        return BResourceHuntableAnimals;
+    case BLD_GRANITEMINE:
+    case BLD_COALMINE:
+    case BLD_IRONMINE:
+    case BLD_GOLDMINE:
+    case BLD_WELL:
+        return REQUIRED_RESOURCES[type];
+    default:
+        return BResourceCount;
+    }
+}
+
 void Resources::Added(const MapPoint& pt, BuildingType type)
 {
+    const BResourceType changedType = GetChangedResource(type);
+    if (changedType != BResourceCount)
+        workAreas_.emplace_back(pt, changedType);
+
     BResourceType resourceType = REQUIRED_RESOURCES[type];
     if (resourceType == BResourceCount)
         return;
@@ -236,12 +440,26 @@ void Resources::Added(const MapPoint& pt, BuildingType type)
     unsigned radius = S_resource_radius[resourceType];
     nodes_.VisitPointsInRadius(pt, radius, [&](const MapPoint& p)
     {
-        nodes_[p].harvested[resourceType]++;
+        if (nodes_[p].harvested[resourceType]++ == 0)
+            SetHarvested(p, resourceType, true);
     }, false);
 }
 
 void Resources::Removed(const MapPoint& pt, BuildingType type)
 {
+    if (!pt.isValid())
+        return;
+
+    const BResourceType changedType = GetChangedResource(type);
+    if (changedType != BResourceCount) {
+        auto it = std::find(workAreas_.begin(), workAreas_.end(), std::make_pair(pt, changedType));
+        RTTR_Assert(it != workAreas_.end());
+        if (it != workAreas_.end()) {
+            *it = workAreas_.back();
+            workAreas_.pop_back();
+        }
+    }
+
     BResourceType resourceType = REQUIRED_RESOURCES[type];
     if (resourceType == BResourceCount)
         return;
@@ -250,22 +468,24 @@ void Resources::Removed(const MapPoint& pt, BuildingType type)
     nodes_.VisitPointsInRadius(pt, radius, [&](const MapPoint& p)
     {
         RTTR_Assert(nodes_[p].harvested[resourceType] > 0);
-        nodes_[p].harvested[resourceType]--;
+        if (--nodes_[p].harvested[resourceType] == 0)
+            SetHarvested(p, resourceType, false);
     }, false);
 }
 
 bool Resources::IsReachable(
         const MapPoint& pt,
         const MapPoint& from,
-        BResourceType type) const
+        BResourceType type,
+        HumanPathSearch& search) const
 {
     if (type == BResourceFish) {
         // Try to find a path to one spot next to the fish.
         for (const auto dir : helpers::EnumRange<Direction>{})  {
             MapPoint fishNeighbour = nodes_.GetNeighbour(pt, dir);
-            if (!aii_.gwb.IsWalkable(fishNeighbour))
+            if (!world_.IsWalkable(fishNeighbour))
                 continue;
-            if (aii_.gwb.FindHumanPath(from, fishNeighbour, 10) != boost::none) {
+            if (world_.FindHumanPath(from, fishNeighbour, 10, search)) {
                 return true;
             }
         }
@@ -275,7 +495,9 @@ bool Resources::IsReachable(
 
     if (type == BResourceHuntableAnimals || type == BResourceWood || type == BResourceStone) {
         unsigned max = type == BResourceHuntableAnimals ? 50 : 20;
-        return from == pt || aii_.gwb.FindHumanPath(from, pt, max) != boost::none;
+        if (from == pt)
+            return true;
+        return world_.FindHumanPath(from, pt, max, search);
     }
 
     return true;
@@ -309,8 +531,10 @@ void Resources::OnBuildingNote(const BuildingNote& note)
         case BLD_FISHERY:
             // We can say for sure that there is no more fish around here.
             for (const MapPoint& p : nodes_.GetPointsInRadius(note.pos, FISHER_RADIUS)) {
-                if (aii_.gwb.IsWaterPoint(p))
+                if (aii_.gwb.IsWaterPoint(p)) {
                     nodes_[p].underground_known = true;
+                    Refresh(p);
+                }
             }
             break;
         case BLD_COALMINE:
@@ -333,6 +557,20 @@ void Resources::OnResourceNote(const ResourceNote& note)
     // Geologist found resource (can be zero)
     Node& node = nodes_[note.pos];
     node.underground_known = true;
+
+    // Guesses of the neighbours depend on this point.
+    nodes_.VisitPointsInRadius(note.pos, 1, [&](const MapPoint& p) { Refresh(p); }, true);
+}
+
+void Resources::OnNodeNote(const NodeNote& note)
+{
+    // Objects at this point changed (trees, stones, fields, roads, ...).
+    Refresh(note.pos);
+}
+
+void Resources::OnPlayerNodeNote(const PlayerNodeNote& note)
+{
+    Refresh(note.pt);
 }
 
 } // namespace beowulf
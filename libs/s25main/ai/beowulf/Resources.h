@@ -19,17 +19,21 @@
 
 #include "ai/beowulf/Types.h"
 #include "ai/beowulf/Helper.h"
+#include "ai/beowulf/NodeContainers.h"
 
 #include "world/NodeMapBase.h"
 #include "gameTypes/Resource.h"
 #include "notifications/Subscription.h"
 
-#include <map>
 #include <bitset>
+#include <utility>
+#include <vector>
 
 class AIInterface;
 class ResourceNote;
 class BuildingNote;
+class NodeNote;
+class PlayerNodeNote;
 
 namespace beowulf {
 
@@ -40,7 +44,11 @@ class World;
  *
  * @todo: Remember visible geologist information from enemies.
  *
- * The resources found will be buffered and kept for 'maxAge' game frames.
+ * Resource values of every point are cached in dense layers together with their sums over
+ * the resource radius. Points are recalculated on notifications about them. Refresh()
+ * recalculates the resources in the work area of our buildings (animals, wood, stone, fish,
+ * ores, ...) on every call. Every other point is recalculated at least every S_refresh_runs
+ * calls.
  */
 class Resources
 {
@@ -54,21 +62,25 @@ public:
      * Returns the total number of resources that is reachable from the given point
      * which is not used by another building.
      * All resources that are not visible due to FOW can be guessed.
+     * Paths are searched with the buffers of 'search' or of this object if it is null.
+     * Threads calling it concurrently need their own 'search'.
      */
     unsigned GetReachable(
             const MapPoint& pt,
             BResourceType type,
             bool weigthDistance = true,
             bool ignoreOtherBuildings = false,
-            bool guess = true);
+            bool guess = true,
+            HumanPathSearch* search = nullptr);
 
     /**
      * For total available resources in a region:
      *
      * Returns the number of resources that are reachable from the given point,
      * ignoring all already visited/reachable points in set.
+     * 'visited' is sized for the map on first use, Clear() starts a new region.
      */
-    typedef std::map<MapPoint, std::bitset<BResourceCount>, MapPointComp> VisitedMap;
+    typedef StampedNodeMap<std::bitset<BResourceCount>> VisitedMap;
     std::array<unsigned, BResourceCount> GetReachable(
             const MapPoint& pt,
             VisitedMap& visited,
@@ -77,18 +89,26 @@ public:
 
     /// Get resources at point.
     /// If guess = true and the resources are not known at that point a qualified guess is returned.
-    unsigned Get(const MapPoint& pt, BResourceType type, bool guess);
+    unsigned Get(const MapPoint& pt, BResourceType type, bool guess) const;
 
     std::array<unsigned, BResourceCount> GetReachableInRegion(const MapPoint& regionPt);
 
     void Added(const MapPoint& pt, BuildingType type);
     void Removed(const MapPoint& pt, BuildingType type);
 
+    /// Recalculate the resource values that change while the game runs and the next part of
+    /// all other values.
+    void Refresh();
+    /// Recalculate the cached resource values at 'pt'.
+    void Refresh(const MapPoint& pt);
+    /// Recalculate the cached value of 'type' at 'pt'.
+    void Refresh(const MapPoint& pt, BResourceType type);
+
 private:
     /// Update the reachable resources at given point for given type.
     void UpdateReachable(const MapPoint& pt, BResourceType type);
 
-    bool IsReachable(const MapPoint& pt, const MapPoint& from, BResourceType type) const;
+    bool IsReachable(const MapPoint& pt, const MapPoint& from, BResourceType type, HumanPathSearch& search) const;
 
 private:
     AIInterface& aii_;
@@ -107,17 +127,50 @@ private:
         // This is not neccessary if we
         std::array<unsigned, BResourceCount> underground;
 
-        // Whether the given resource is already beeing harvested by a building.
+        // Number of buildings harvesting the given resource at this point.
         std::array<unsigned, BResourceCount> harvested;
     };
     NodeMapBase<Node> nodes_;
 
+    /// Dense per point data of one resource type.
+    struct Layer
+    {
+        /// Known resources (Calculate(pt, type, false)).
+        std::vector<unsigned> value;
+        /// Resources including guesses. Empty if the type is never guessed.
+        std::vector<unsigned> guess;
+        /// Sums over the resource radius, indexed by SumIdx(). Empty if not needed for the type.
+        std::array<std::vector<unsigned>, 8> sums;
+    };
+    std::array<Layer, BResourceCount> layers_;
+    /// Next point to be recalculated by Refresh().
+    unsigned nextRefresh_ = 0;
+    /// Positions of buildings that use up or grow resources around them with the type they
+    /// change. Recalculated on every Refresh().
+    std::vector<std::pair<MapPoint, BResourceType>> workAreas_;
+    /// Path search buffers of callers without their own.
+    HumanPathSearch search_;
+
+    static unsigned SumIdx(BResourceType type, bool weighted, bool guess, bool unharvested);
+    const std::vector<unsigned>& GetSums(BResourceType type, bool weighted, bool guess, bool unharvested) const;
+    /// Add differences (indexed by SumIdx() without the weighted flag) to the sums around 'pt'.
+    void AddToSums(const MapPoint& pt, BResourceType type, const std::array<unsigned, 4>& diffs);
+    void SetHarvested(const MapPoint& pt, BResourceType type, bool harvested);
+
+    unsigned Calculate(const MapPoint& pt, BResourceType type, bool guess) const;
+    void SetValue(const MapPoint& pt, BResourceType type, unsigned value, unsigned guess);
+    const std::vector<unsigned>& GetValues(BResourceType type, bool guess) const;
+
     void AddResource(Node& node, const MapPoint& dst, const MapPoint& pt, unsigned radius, BResourceType type, unsigned amount);
     unsigned GuessOre(const MapPoint& pt, Resource::Type type) const;
+    /// Resource type the building of 'type' changes in its work area or BResourceCount.
+    static BResourceType GetChangedResource(BuildingType type);
 
     std::vector<Subscription> eventSubscriptions_;
     void OnBuildingNote(const BuildingNote& note);
     void OnResourceNote(const ResourceNote& note);
+    void OnNodeNote(const NodeNote& note);
+    void OnPlayerNodeNote(const PlayerNodeNote& note);
 };
 
 } // namespace beowulf
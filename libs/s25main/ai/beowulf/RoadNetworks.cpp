@@ -0,0 +1,164 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ai/beowulf/RoadNetworks.h"
+#include "ai/beowulf/World.h"
+
+#include "RttrForeachPt.h"
+
+namespace beowulf {
+
+RoadNetworks::RoadNetworks(const World& world)
+    : world_(world)
+{
+}
+
+void RoadNetworks::Rebuild()
+{
+    RelabelAll();
+}
+
+void RoadNetworks::RelabelAll() const
+{
+    ids_.Resize(world_.GetSize());
+    parent_.clear();
+    dirty_.clear();
+
+    RTTR_FOREACH_PT(MapPoint, world_.GetSize()) {
+        ids_[pt] = InvalidNetwork;
+    }
+
+    RTTR_FOREACH_PT(MapPoint, world_.GetSize()) {
+        if (ids_[pt] == InvalidNetwork && world_.IsOnRoad(pt))
+            Relabel(pt, 0);
+    }
+}
+
+void RoadNetworks::OnSegmentAdded(const MapPoint& pt, Direction dir)
+{
+    MapPoint next = world_.GetNeighbour(pt, dir);
+
+    // Pending removals will flood fill across this segment anyway.
+    if (!dirty_.empty()) {
+        dirty_.push_back(pt);
+        dirty_.push_back(next);
+        return;
+    }
+
+    if (ids_[pt] == InvalidNetwork)
+        ids_[pt] = NewNetwork();
+    if (ids_[next] == InvalidNetwork) {
+        ids_[next] = ids_[pt];
+        return;
+    }
+
+    unsigned a = Find(ids_[pt]);
+    unsigned b = Find(ids_[next]);
+    if (a != b)
+        parent_[b] = a;
+}
+
+void RoadNetworks::OnSegmentRemoved(const MapPoint& pt, Direction dir)
+{
+    dirty_.push_back(pt);
+    dirty_.push_back(world_.GetNeighbour(pt, dir));
+}
+
+unsigned RoadNetworks::GetNetwork(const MapPoint& pt) const
+{
+    Update();
+
+    unsigned id = ids_[pt];
+    return id == InvalidNetwork ? InvalidNetwork : Find(id);
+}
+
+bool RoadNetworks::IsConnected(const MapPoint& src, const MapPoint& dst) const
+{
+    unsigned network = GetNetwork(src);
+    return network != InvalidNetwork && network == GetNetwork(dst);
+}
+
+void RoadNetworks::Update() const
+{
+    if (dirty_.empty())
+        return;
+
+    // Ids of removed networks are never reused. Start over once there are too many of them.
+    if (parent_.size() > 2 * world_.GetSize().x * world_.GetSize().y) {
+        RelabelAll();
+        return;
+    }
+
+    const unsigned firstId = static_cast<unsigned>(parent_.size());
+    for (const MapPoint& pt : dirty_) {
+        unsigned id = ids_[pt];
+        if (id != InvalidNetwork && id >= firstId)
+            continue; // Already relabeled.
+
+        if (world_.IsOnRoad(pt))
+            Relabel(pt, firstId);
+        else
+            ids_[pt] = InvalidNetwork;
+    }
+    dirty_.clear();
+}
+
+void RoadNetworks::Relabel(const MapPoint& pt, unsigned firstId) const
+{
+    const unsigned id = NewNetwork();
+
+    stack_.clear();
+    stack_.push_back(pt);
+    ids_[pt] = id;
+
+    while (!stack_.empty()) {
+        MapPoint cur = stack_.back();
+        stack_.pop_back();
+
+        for (const auto dir : helpers::EnumRange<Direction>{}) {
+            if (!world_.HasRoad(cur, dir))
+                continue;
+
+            MapPoint next = world_.GetNeighbour(cur, dir);
+            unsigned& nextId = ids_[next];
+            if (nextId != InvalidNetwork && nextId >= firstId)
+                continue;
+
+            nextId = id;
+            stack_.push_back(next);
+        }
+    }
+}
+
+unsigned RoadNetworks::NewNetwork() const
+{
+    unsigned id = static_cast<unsigned>(parent_.size());
+    parent_.push_back(id);
+    return id;
+}
+
+unsigned RoadNetworks::Find(unsigned id) const
+{
+    while (parent_[id] != id) {
+        // Path halving
+        parent_[id] = parent_[parent_[id]];
+        id = parent_[id];
+    }
+    return id;
+}
+
+} // namespace beowulf
@@ -0,0 +1,81 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_ROADNETWORKS_H_INCLUDED
+#define BEOWULF_ROADNETWORKS_H_INCLUDED
+
+#include "gameTypes/MapCoordinates.h"
+#include "gameTypes/Direction.h"
+#include "world/NodeMapBase.h"
+
+#include <limits>
+#include <vector>
+
+namespace beowulf {
+
+class World;
+
+/**
+ * @brief Connected components of Beowulfs road graph (existing, requested and planned roads).
+ *
+ * Added segments are merged with a union-find. Removed segments only mark their end points
+ * as dirty. Before the next query the networks around dirty points are flood filled again
+ * and receive new ids.
+ */
+class RoadNetworks
+{
+public:
+    static const unsigned InvalidNetwork = std::numeric_limits<unsigned>::max();
+
+    explicit RoadNetworks(const World& world);
+
+    /// Recalculate all networks from the current world state.
+    void Rebuild();
+
+    /// A segment from 'pt' in 'dir' now has a road.
+    void OnSegmentAdded(const MapPoint& pt, Direction dir);
+    /// The segment from 'pt' in 'dir' does not have a road anymore.
+    void OnSegmentRemoved(const MapPoint& pt, Direction dir);
+
+    /// Id of the network 'pt' belongs to or InvalidNetwork if there is no road at 'pt'.
+    /// Ids are only stable until the road graph changes.
+    unsigned GetNetwork(const MapPoint& pt) const;
+    /// Check if 'src' and 'dst' share a road network.
+    bool IsConnected(const MapPoint& src, const MapPoint& dst) const;
+
+private:
+    void Update() const;
+    void RelabelAll() const;
+    /// Assign a new id to every point reachable from 'pt'.
+    void Relabel(const MapPoint& pt, unsigned firstId) const;
+    unsigned NewNetwork() const;
+    unsigned Find(unsigned id) const;
+
+    const World& world_;
+
+    // Network id of every point. Ids are union-find entries in parent_.
+    mutable NodeMapBase<unsigned> ids_;
+    mutable std::vector<unsigned> parent_;
+
+    // End points of removed segments.
+    mutable std::vector<MapPoint> dirty_;
+    // Scratch stack for Relabel().
+    mutable std::vector<MapPoint> stack_;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_ROADNETWORKS_H_INCLUDED
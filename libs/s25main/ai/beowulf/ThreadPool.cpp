@@ -0,0 +1,106 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ai/beowulf/ThreadPool.h"
+
+namespace beowulf {
+
+ThreadPool::ThreadPool(unsigned numThreads)
+    : nextTask_(0)
+{
+    for (unsigned i = 1; i < numThreads; ++i)
+        workers_.emplace_back(&ThreadPool::Work, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wakeUp_.notify_all();
+    for (std::thread& worker : workers_)
+        worker.join();
+}
+
+void ThreadPool::Run(unsigned numTasks, const std::function<void(unsigned, unsigned)>& task)
+{
+    if (workers_.empty() || numTasks <= 1) {
+        for (unsigned i = 0; i < numTasks; ++i)
+            task(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        numTasks_ = numTasks;
+        nextTask_ = 0;
+        busy_ = static_cast<unsigned>(workers_.size());
+        generation_++;
+    }
+    wakeUp_.notify_all();
+
+    Execute(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return busy_ == 0; });
+    task_ = nullptr;
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::Work(unsigned thread)
+{
+    unsigned generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeUp_.wait(lock, [&]() { return stop_ || generation_ != generation; });
+            if (stop_)
+                return;
+            generation = generation_;
+        }
+
+        Execute(thread);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_--;
+        }
+        done_.notify_one();
+    }
+}
+
+void ThreadPool::Execute(unsigned thread)
+{
+    try {
+        for (unsigned i = nextTask_++; i < numTasks_; i = nextTask_++)
+            (*task_)(i, thread);
+    } catch (...) {
+        // Escaping a worker would terminate the program. Run() rethrows it instead.
+        nextTask_ = numTasks_;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_)
+            error_ = std::current_exception();
+    }
+}
+
+} // namespace beowulf
@@ -0,0 +1,78 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_THREADPOOL_H_INCLUDED
+#define BEOWULF_THREADPOOL_H_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace beowulf {
+
+/**
+ * @brief Fixed set of worker threads for data parallel work.
+ *
+ * Run() distributes tasks over the workers and the calling thread. Tasks are
+ * taken from a shared counter, so idle threads pick up the remaining tasks.
+ */
+class ThreadPool
+{
+public:
+    /// 'numThreads' includes the calling thread. 0 or 1 runs all tasks on the calling thread.
+    explicit ThreadPool(unsigned numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Number of threads executing tasks (including the calling thread).
+    unsigned GetNumThreads() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    /// Call task(i, thread) for every i in [0, numTasks) and wait for all of them.
+    /// 'thread' is in [0, GetNumThreads()) and unique among concurrently running tasks.
+    /// If a task throws, the remaining tasks are skipped and the first exception is rethrown.
+    void Run(unsigned numTasks, const std::function<void(unsigned, unsigned)>& task);
+
+private:
+    void Work(unsigned thread);
+    void Execute(unsigned thread);
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    std::condition_variable done_;
+    bool stop_ = false;
+    // Incremented for every call to Run().
+    unsigned generation_ = 0;
+    // Workers still busy with the current generation.
+    unsigned busy_ = 0;
+
+    const std::function<void(unsigned, unsigned)>* task_ = nullptr;
+    unsigned numTasks_ = 0;
+    std::atomic<unsigned> nextTask_;
+    // First exception thrown by a task of the current generation.
+    std::exception_ptr error_;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_THREADPOOL_H_INCLUDED
@@ -0,0 +1,193 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ai/beowulf/TrafficMap.h"
+#include "ai/beowulf/Building.h"
+#include "ai/beowulf/World.h"
+
+#include "helpers/containerUtils.h"
+
+#include <algorithm>
+
+namespace beowulf {
+
+TrafficMap::TrafficMap(const World& world)
+    : world_(world)
+{
+    flow_.resize(world.GetSize().x * world.GetSize().y * 3, { { 0, 0 } });
+}
+
+unsigned TrafficMap::Update(const Building* building)
+{
+    const BuildingHandle handle = world_.GetHandle(building);
+    Remove(handle);
+
+    if (!building->GetPt().isValid())
+        return 0;
+
+    const Building::TrafficExpected& traffic = building->GetTraffic();
+    std::vector<Leg> legs;
+
+    if (traffic.produced > 0) {
+        const Building* dest = world_.GetGoodsDest(building, building->GetPt());
+        if (!(dest && dest->GetPt().isValid()))
+            dest = GetStorehouse(building);
+        if (dest)
+            Route(building->GetFlag(), dest->GetFlag(), traffic.produced, legs);
+    }
+
+    // Production groups supply their members themselves.
+    if (traffic.consumed > 0 && building->GetGroup() == InvalidProductionGroup) {
+        const Building* src = GetStorehouse(building);
+        if (src)
+            Route(src->GetFlag(), building->GetFlag(), traffic.consumed, legs);
+    }
+
+    if (legs.empty())
+        return 0;
+
+    for (const Leg& leg : legs) {
+        flow_[leg.segment][leg.forward ? 0 : 1] += leg.amount;
+        std::vector<BuildingHandle>& users = users_[leg.segment];
+        if (!helpers::contains(users, handle))
+            users.push_back(handle);
+    }
+
+    const unsigned work = static_cast<unsigned>(legs.size());
+    routes_[handle] = std::move(legs);
+    return work;
+}
+
+void TrafficMap::Remove(const BuildingHandle& building)
+{
+    auto route = routes_.find(building);
+    if (route == routes_.end())
+        return;
+
+    for (const Leg& leg : route->second) {
+        flow_[leg.segment][leg.forward ? 0 : 1] -= leg.amount;
+        auto users = users_.find(leg.segment);
+        if (users == users_.end())
+            continue;
+        users->second.erase(std::remove(users->second.begin(), users->second.end(), building), users->second.end());
+        if (users->second.empty())
+            users_.erase(users);
+    }
+    routes_.erase(route);
+}
+
+const std::vector<BuildingHandle>& TrafficMap::GetUsers(const MapPoint& pt, Direction dir) const
+{
+    static const std::vector<BuildingHandle> noUsers;
+    auto it = users_.find(GetSegment(pt, dir));
+    return it == users_.end() ? noUsers : it->second;
+}
+
+unsigned TrafficMap::GetFlow(const MapPoint& pt, Direction dir) const
+{
+    return flow_[GetSegment(pt, dir)][dir.native_value() >= 3 ? 0 : 1];
+}
+
+unsigned TrafficMap::GetCongestion(const MapPoint& pt, Direction dir) const
+{
+    const std::array<unsigned, 2>& flow = flow_[GetSegment(pt, dir)];
+    return flow[0] + flow[1];
+}
+
+std::vector<std::pair<MapPoint, Direction>> TrafficMap::GetCongestedSegments(unsigned limit) const
+{
+    std::vector<unsigned> segments;
+    for (const auto& it : users_) {
+        const std::array<unsigned, 2>& flow = flow_[it.first];
+        if (flow[0] + flow[1] > limit)
+            segments.push_back(it.first);
+    }
+    std::sort(segments.begin(), segments.end(), [this](unsigned l, unsigned r)
+    {
+        const unsigned lCongestion = flow_[l][0] + flow_[l][1];
+        const unsigned rCongestion = flow_[r][0] + flow_[r][1];
+        if (lCongestion != rCongestion)
+            return lCongestion > rCongestion;
+        return l < r;
+    });
+
+    std::vector<std::pair<MapPoint, Direction>> ret;
+    const unsigned width = world_.GetSize().x;
+    for (unsigned segment : segments) {
+        const unsigned idx = segment / 3;
+        const MapPoint pt(static_cast<MapCoord>(idx % width), static_cast<MapCoord>(idx / width));
+        ret.emplace_back(pt, OppositeDirection(Direction::fromInt(segment % 3)));
+    }
+    return ret;
+}
+
+unsigned TrafficMap::GetSegment(const MapPoint& pt, Direction dir) const
+{
+    if (dir.native_value() >= 3)
+        return world_.GetIdx(pt) * 3 + OppositeDirection(dir).native_value();
+    else
+        return world_.GetIdx(world_.GetNeighbour(pt, dir)) * 3 + dir.native_value();
+}
+
+void TrafficMap::Route(const MapPoint& src, const MapPoint& dst, unsigned amount, std::vector<Leg>& legs) const
+{
+    if (src == dst)
+        return;
+
+    std::vector<Direction> route;
+    bool found = world_.GetPathFinder().FindPath(src, &route,
+    // Condition
+    [&](const MapPoint& pt, Direction dir)
+    {
+        return world_.HasRoad(pt, dir);
+    },
+    // End
+    [&](const MapPoint& pt)
+    {
+        return pt == dst;
+    },
+    // Heuristic
+    [&](const MapPoint& pt)
+    {
+        return world_.CalcDistance(pt, dst);
+    },
+    // Cost
+    [&](const MapPoint&, Direction)
+    {
+        return 1;
+    });
+
+    if (!found)
+        return;
+
+    MapPoint cur = src;
+    for (Direction dir : route) {
+        legs.push_back({ GetSegment(cur, dir), dir.native_value() >= 3, amount });
+        cur = world_.GetNeighbour(cur, dir);
+    }
+}
+
+const Building* TrafficMap::GetStorehouse(const Building* building) const
+{
+    auto nearest = world_.GetNearestBuilding(
+                building->GetPt(),
+                { BLD_HEADQUARTERS, BLD_STOREHOUSE, BLD_HARBORBUILDING },
+                building);
+    return nearest.first.isValid() ? world_.GetBuilding(nearest.first) : nullptr;
+}
+
+} // namespace beowulf
@@ -0,0 +1,91 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_TRAFFICMAP_H_INCLUDED
+#define BEOWULF_TRAFFICMAP_H_INCLUDED
+
+#include "ai/beowulf/BuildingPool.h"
+
+#include "gameTypes/MapCoordinates.h"
+#include "gameTypes/Direction.h"
+
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace beowulf {
+
+class World;
+
+/**
+ * @brief Expected ware flow on every road segment.
+ *
+ * Every building sends its produced wares (Building::GetTraffic()) to its goods destination
+ * (World::GetGoodsDest()) or the closest storehouse. Buildings outside a production group
+ * receive the wares they consume from the closest storehouse. Members of a group get them
+ * from the producers of the group. The flows follow the shortest route over the roads.
+ *
+ * Routes are only updated for single buildings (see Update()), so the map follows
+ * building and road changes incrementally.
+ */
+class TrafficMap
+{
+public:
+    explicit TrafficMap(const World& world);
+
+    /// Route the wares of 'building' over the current roads and replace its earlier routes.
+    /// Returns the number of route segments (as work done).
+    unsigned Update(const Building* building);
+    /// Remove the routes of a building (which may already be removed from the world).
+    void Remove(const BuildingHandle& building);
+
+    /// Buildings whose wares pass the segment from 'pt' in 'dir'.
+    const std::vector<BuildingHandle>& GetUsers(const MapPoint& pt, Direction dir) const;
+    /// Expected wares moving from 'pt' in 'dir'.
+    unsigned GetFlow(const MapPoint& pt, Direction dir) const;
+    /// Expected wares moving in both directions of the segment.
+    unsigned GetCongestion(const MapPoint& pt, Direction dir) const;
+    /// Segments with a congestion above 'limit' (most congested first).
+    /// Segments are returned from the node owning them (see GetSegment()).
+    std::vector<std::pair<MapPoint, Direction>> GetCongestedSegments(unsigned limit) const;
+
+private:
+    struct Leg
+    {
+        unsigned segment;
+        /// Flow goes from the owning node to its neighbour.
+        bool forward;
+        unsigned amount;
+    };
+
+    /// Index of the segment from 'pt' in 'dir'. Every node owns the roads to its eastern, south-eastern and south-western neighbours.
+    unsigned GetSegment(const MapPoint& pt, Direction dir) const;
+    /// Add a flow of 'amount' from 'src' to 'dst' to 'legs'.
+    void Route(const MapPoint& src, const MapPoint& dst, unsigned amount, std::vector<Leg>& legs) const;
+    const Building* GetStorehouse(const Building* building) const;
+
+    const World& world_;
+    std::unordered_map<BuildingHandle, std::vector<Leg>, BuildingHandle::Hash> routes_;
+    /// Only few segments have users.
+    std::unordered_map<unsigned, std::vector<BuildingHandle>> users_;
+    /// Flow of every segment (0 ... from the owning node to the neighbour, 1 ... back).
+    std::vector<std::array<unsigned, 2>> flow_;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_TRAFFICMAP_H_INCLUDED
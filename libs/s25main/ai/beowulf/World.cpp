@@ -31,31 +31,43 @@
 #include "gameData/GameConsts.h"
 #include "gameData/MilitaryConsts.h"
 #include "nodeObjs/noFlag.h"
+#include "pathfinding/PathConditionHuman.h"
 #include "pathfinding/PathConditionRoad.h"
 #include "GlobalGameSettings.h"
 #include "addons/const_addons.h"
 #include "notifications/BuildingNote.h"
 #include "notifications/RoadNote.h"
 #include "notifications/FlagNote.h"
+#include "notifications/NodeNote.h"
 #include "helpers/containerUtils.h"
 
-#include <boost/lambda/lambda.hpp>
-#include <boost/lambda/bind.hpp>
-#include <boost/lambda/if.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <limits>
-#include <set>
 
 namespace beowulf {
 
+// Changing the blocking manner or owner of a node changes the BQ in this radius.
+// Castle extensions block the neighbours of a building. The BQ of a node depends on the
+// blocking manner of its neighbours (and of the neighbours of its flag).
+static const unsigned S_bq_radius = 3;
+
 World::World(Beowulf* beowulf, bool fow)
     : resources(beowulf->GetAII(), *this, fow),
       beowulf_(beowulf),
       aii_(beowulf->GetAII()),
-      fow_(fow)
+      fow_(fow),
+      roadNetworks_(*this)
 {
     Resize(aii_.gwb.GetSize());
-    nodes_.Resize(GetSize());
+    nodeBuildings_.Resize(GetSize());
+    nodeStates_.Resize(GetSize().x * GetSize().y);
+    pathFinder_.Init(*this);
+    buildingIndex_.Init(*this);
+    bqCache_.Init(GetSize().x * GetSize().y);
+    ownMilitary_.Init(*this);
+    enemyMilitary_.Init(*this);
 
     // Set existing buildings.
     const nobHQ* bld = aii_.GetHeadquarter();
@@ -78,7 +90,6 @@ World::World(Beowulf* beowulf, bool fow)
 
     // Set existing roads.
     RTTR_FOREACH_PT(MapPoint, GetSize()) {
-        Node& node = nodes_[pt];
         const noFlag* flagObj = aii_.gwb.GetSpecObj<noFlag>(pt);
         if (flagObj && flagObj->GetPlayer() == aii_.GetPlayerId())
             SetFlagState(pt, FlagFinished);
@@ -87,30 +98,44 @@ World::World(Beowulf* beowulf, bool fow)
                 if (aii_.gwb.GetNO(pt)->GetType() != NOP_BUILDING &&
                         aii_.gwb.GetNO(GetNeighbour(pt, OppositeDirection(toDirection(rdir))))->GetType() != NOP_BUILDING)
                 {
-                    node.roads[static_cast<int>(rdir)] = RoadFinished;
+                    nodeStates_.SetRoad(GetIdx(pt), static_cast<unsigned>(rdir), RoadFinished);
                 }
             }
         }
     }
+    roadNetworks_.Rebuild();
+    RefreshEnemyMilitary();
 
     // Initialize event handling.
     NotificationManager& notifications = aii_.gwb.GetNotifications();
-    eventSubscriptions_.push_back(notifications.subscribe<BuildingNote>(
-        boost::lambda::if_(boost::lambda::bind(&BuildingNote::player, boost::lambda::_1) == aii_.GetPlayerId())
-                                      [boost::lambda::bind(&World::OnBuildingNote, this, boost::lambda::_1)]));
-    eventSubscriptions_.push_back(notifications.subscribe<RoadNote>(
-        boost::lambda::if_(boost::lambda::bind(&RoadNote::player, boost::lambda::_1) == aii_.GetPlayerId())
-                                      [boost::lambda::bind(&World::OnRoadNote, this, boost::lambda::_1)]));
-    eventSubscriptions_.push_back(notifications.subscribe<FlagNote>(
-        boost::lambda::if_(boost::lambda::bind(&FlagNote::player, boost::lambda::_1) == aii_.GetPlayerId())
-                                      [boost::lambda::bind(&World::OnFlagNote, this, boost::lambda::_1)]));
+    eventSubscriptions_.push_back(notifications.subscribe<BuildingNote>([this](const BuildingNote& note)
+    {
+        if (note.player == aii_.GetPlayerId())
+            notes.Dispatch(note, [this](const BuildingNote& note) { OnBuildingNote(note); });
+    }));
+    eventSubscriptions_.push_back(notifications.subscribe<RoadNote>([this](const RoadNote& note)
+    {
+        if (note.player == aii_.GetPlayerId())
+            notes.Dispatch(note, [this](const RoadNote& note) { OnRoadNote(note); });
+    }));
+    eventSubscriptions_.push_back(notifications.subscribe<FlagNote>([this](const FlagNote& note)
+    {
+        if (note.player == aii_.GetPlayerId())
+            notes.Dispatch(note, [this](const FlagNote& note) { OnFlagNote(note); });
+    }));
+    eventSubscriptions_.push_back(notifications.subscribe<NodeNote>([this](const NodeNote& note)
+    {
+        notes.Dispatch(note, [this](const NodeNote& note)
+        {
+            InvalidateBQ(note.pos);
+            // Territory changes when military buildings are finished, captured or destroyed.
+            if (note.type == NodeNote::Owner)
+                enemyMilitaryDirty_ = true;
+        });
+    }));
 }
 
-World::~World()
-{
-    for (Building* building : buildings_)
-        delete building;
-}
+World::~World() = default;
 
 void World::Construct(Building* building, const MapPoint& pt)
 {
@@ -122,7 +147,7 @@ void World::Construct(Building* building, const MapPoint& pt)
 
     ClearPlan();
 
-    aii_.SetBuildingSite(pt, building->GetType());
+    beowulf_->GetAII().SetBuildingSite(pt, building->GetType());
 
     building->state_ = Building::ConstructionRequested;
     SetPoint(building, pt);
@@ -134,9 +159,8 @@ void World::ConstructFlag(const MapPoint& pt)
 {
     ClearPlan();
 
-    Node& node = nodes_[pt];
-    if (node.flag == FlagDoesNotExist) {
-        aii_.SetFlag(pt);
+    if (nodeStates_.GetFlag(GetIdx(pt)) == FlagDoesNotExist) {
+        beowulf_->GetAII().SetFlag(pt);
         SetFlagState(pt, FlagRequested);
     }
 }
@@ -146,13 +170,12 @@ void World::ConstructRoad(const MapPoint& pt, const std::vector<Direction>& rout
     RTTR_Assert(route.size() >= 2);
     ClearPlan();
 
-    const Node& node = nodes_[pt];
-
-    if (!(node.flag == FlagRequested || node.flag == FlagFinished)) {
-        aii_.SetFlag(pt);
+    const FlagState flag = nodeStates_.GetFlag(GetIdx(pt));
+    if (!(flag == FlagRequested || flag == FlagFinished)) {
+        beowulf_->GetAII().SetFlag(pt);
         SetFlagState(pt, FlagRequested);
     }
-    aii_.BuildRoad(pt, false, route);
+    beowulf_->GetAII().BuildRoad(pt, false, route);
     SetRoadState(pt, route, RoadRequested);
 
     MapPoint end = pt;
@@ -169,7 +192,7 @@ void World::Deconstruct(Building* building)
 
     ClearPlan();
 
-    aii_.DestroyBuilding(building->GetPt());
+    beowulf_->GetAII().DestroyBuilding(building->GetPt());
     building->state_ = Building::DestructionRequested;
 }
 
@@ -177,12 +200,9 @@ void World::DeconstructFlag(const MapPoint& pt)
 {
     ClearPlan();
 
-    Node& node = nodes_[pt];
-    RTTR_Assert(node.flag == FlagFinished);
+    RTTR_Assert(nodeStates_.GetFlag(GetIdx(pt)) == FlagFinished);
 
-    const noFlag* nof = aii_.gwb.GetSpecObj<noFlag>(pt);
-    RTTR_Assert(nof);
-    aii_.DestroyFlag(nof);
+    beowulf_->GetAII().DestroyFlag(pt);
 
     // Mark all connected roads as deconstruction requested as well.
     FloodFill(*this, pt,
@@ -203,25 +223,33 @@ void World::DeconstructFlag(const MapPoint& pt)
 
 void World::DeconstructRoad(const MapPoint& pt, const std::vector<Direction>& route)
 {
-    RTTR_Assert(nodes_[pt].flag == FlagRequested || nodes_[pt].flag == FlagFinished);
+    RTTR_Assert(GetFlagState(pt) == FlagRequested || GetFlagState(pt) == FlagFinished);
     RTTR_Assert(!route.empty());
     RTTR_Assert(HasRoad(pt, route.front()));
 
     ClearPlan();
 
-    aii_.DestroyRoad(pt, route.front());
+    beowulf_->GetAII().DestroyRoad(pt, route.front());
     SetRoadState(pt, route, RoadDestructionRequested);
 }
 
 void World::Plan(Building* building, const MapPoint& pt)
 {
-    Node& node = nodes_[pt];
-    RTTR_Assert(node.building == nullptr);
+    RTTR_Assert(nodeBuildings_[pt] == nullptr);
     RTTR_Assert(building);
     RTTR_Assert(building->GetState() == Building::PlanningRequest);
 
-    node.building = building;
+    planLog_.push_back({ PlanChange::PlannedBuilding, 0, 0, pt, building, building->pt_ });
+
+    nodeBuildings_[pt] = building;
+    if (building->pt_.isValid()) {
+        buildingIndex_.Remove(building);
+        RemoveFromTerritory(building);
+    }
     building->pt_ = pt;
+    buildingIndex_.Add(building);
+    InvalidateBQ(pt);
+    AddToTerritory(building);
 
     resources.Added(pt, building->GetType());
 
@@ -232,15 +260,18 @@ void World::Plan(Building* building, const MapPoint& pt)
 
 void World::PlanFlag(const MapPoint& pt)
 {
-    Node& node = nodes_[pt];
-
-    if (node.flag == FlagFinished || node.flag == FlagRequested)
+    const unsigned idx = GetIdx(pt);
+    const FlagState flag = nodeStates_.GetFlag(idx);
+    if (flag == FlagFinished || flag == FlagRequested)
         return;
 
-    node.flagPlanCount++;
+    const uint8_t previousCount = nodeStates_.PlanFlag(idx);
+    planLog_.push_back({ PlanChange::PlannedFlag, 0, previousCount, pt, nullptr, MapPoint::Invalid() });
 
-    if (node.flagPlanCount == 1)
+    if (previousCount == 0) {
         flags_.push_back(pt);
+        InvalidateBQ(pt);
+    }
 
     activePlan_ = true;
 }
@@ -265,27 +296,67 @@ void World::ClearPlan()
     if (!activePlan_)
         return;
 
-    // Clear planned flags.
-    flags_.erase(std::remove_if(flags_.begin(), flags_.end(),
-        [&](const MapPoint& pt) { return nodes_[pt].flagPlanCount > 0; }), flags_.end());
+    // Planned buildings keep their point. The anticipated territory does not change.
+    UndoPlan(0, false);
 
-    // Clear all nodes
-    RTTR_FOREACH_PT(MapPoint, GetSize())
-    {
-        Node& node = nodes_[pt];
+    activePlan_ = false;
+}
 
-        if (node.building && node.building->GetState() == Building::PlanningRequest) {
-            resources.Removed(pt, node.building->GetType());
-            node.building = nullptr;
-        }
+void World::RollbackPlan(PlanSavepoint savepoint)
+{
+    RTTR_Assert(savepoint <= planLog_.size());
+    UndoPlan(savepoint, true);
+    activePlan_ = !planLog_.empty();
+}
 
-        node.flagPlanCount = 0;
-        node.roadPlanCount[0] = 0;
-        node.roadPlanCount[1] = 0;
-        node.roadPlanCount[2] = 0;
-    }
+void World::UndoPlan(size_t size, bool restorePoints)
+{
+    while (planLog_.size() > size) {
+        const PlanChange change = planLog_.back();
+        planLog_.pop_back();
+        const unsigned idx = GetIdx(change.pt);
 
-    activePlan_ = false;
+        switch (change.type) {
+        case PlanChange::PlannedBuilding:
+        {
+            Building* building = change.building;
+            if (nodeBuildings_[idx] == building && building->GetState() == Building::PlanningRequest) {
+                resources.Removed(change.pt, building->GetType());
+                nodeBuildings_[idx] = nullptr;
+                InvalidateBQ(change.pt);
+            }
+            if (restorePoints && building->pt_ != change.previousPt) {
+                buildingIndex_.Remove(building);
+                RemoveFromTerritory(building);
+                building->pt_ = change.previousPt;
+                if (building->pt_.isValid()) {
+                    buildingIndex_.Add(building);
+                    AddToTerritory(building);
+                }
+            }
+        } break;
+        case PlanChange::PlannedFlag:
+        {
+            nodeStates_.RestoreFlagPlan(idx, change.previousCount);
+            if (change.previousCount == 0) {
+                auto it = std::find(flags_.rbegin(), flags_.rend(), change.pt);
+                if (it != flags_.rend())
+                    flags_.erase(std::next(it).base());
+                InvalidateBQ(change.pt);
+            }
+        } break;
+        case PlanChange::PlannedRoad:
+        {
+            nodeStates_.RestoreRoadPlan(idx, change.road, change.previousCount);
+            if (change.previousCount == 0) {
+                const RoadState road = nodeStates_.GetRoad(idx, change.road);
+                if (road != RoadRequested && road != RoadFinished)
+                    roadNetworks_.OnSegmentRemoved(change.pt, OppositeDirection(Direction::fromInt(change.road)));
+                InvalidateBQ(change.pt);
+            }
+        } break;
+        }
+    }
 }
 
 void World::Remove(Building* building)
@@ -299,14 +370,21 @@ void World::Remove(Building* building)
                 group.buildings[i] = nullptr;
     }
 
-    if (building->GetPt().isValid())
-        nodes_[building->GetPt()].building = nullptr;
-
-    resources.Removed(building->GetPt(), building->GetType());
+    if (building->GetPt().isValid()) {
+        // Only buildings on their node (not cleared plans) count for the resources.
+        if (nodeBuildings_[building->GetPt()] == building) {
+            nodeBuildings_[building->GetPt()] = nullptr;
+            resources.Removed(building->GetPt(), building->GetType());
+        }
+        buildingIndex_.Remove(building);
+        InvalidateBQ(building->GetPt());
+        RemoveFromTerritory(building);
+    }
 
     buildings_.erase(std::remove(buildings_.begin(), buildings_.end(), building), buildings_.end());
+    buildingChanges_++;
 
-    delete building;
+    buildingPool_.Destroy(building);
 }
 
 void World::RemoveFlag(const MapPoint& pt)
@@ -331,9 +409,14 @@ Building* World::Create(
 {
     ClearPlan();
 
-    Building* building = new Building(*this, type, state);
+    Building* building = buildingPool_.Create(*this, type, state);
     building->pt_ = pt;
     buildings_.push_back(building);
+    buildingChanges_++;
+    if (pt.isValid()) {
+        buildingIndex_.Add(building);
+        AddToTerritory(building);
+    }
 
     // If the building already comes with a desired destination group we respect that.
     if (group != InvalidProductionGroup) {
@@ -354,8 +437,9 @@ Building* World::Create(
 
 std::vector<Building*> World::GetBuildings(BuildingType type) const
 {
+    // Creation order. Callers taking the first match depend on it, the pool reuses freed slots.
     std::vector<Building*> ret;
-    for (Building* building : GetBuildings()) {
+    for (Building* building : buildings_) {
         if (building->GetType() == type)
             ret.push_back(building);
     }
@@ -365,15 +449,20 @@ std::vector<Building*> World::GetBuildings(BuildingType type) const
 Building* World::GetBuilding(const MapPoint& pt) const
 {
     if (pt.isValid())
-        return nodes_[pt].building;
+        return nodeBuildings_[pt];
     return nullptr;
 }
 
 Building* World::GetHQ() const
 {
+    if (snapshot_) {
+        const MapPoint& hq = snapshot_->GetHQ();
+        return hq.isValid() ? nodeBuildings_[hq] : nullptr;
+    }
+
     const nobHQ* hq = aii_.GetHeadquarter();
     if (hq)
-        return nodes_[hq->GetPos()].building;
+        return nodeBuildings_[hq->GetPos()];
     return nullptr;
 }
 
@@ -389,18 +478,17 @@ void World::SetState(Building* building, Building::State state)
 
 bool World::HasFlag(const MapPoint& pt) const
 {
-    const Node& node = nodes_[pt];
-    return node.flag == FlagRequested || node.flag == FlagFinished || node.flagPlanCount > 0;
+    return nodeStates_.HasFlag(GetIdx(pt));
 }
 
 FlagState World::GetFlagState(const MapPoint& pt) const
 {
-    return nodes_[pt].flag;
+    return nodeStates_.GetFlag(GetIdx(pt));
 }
 
 void World::SetFlagState(const MapPoint& pt, FlagState state)
 {
-    RTTR_Assert(nodes_[pt].flag != state);
+    RTTR_Assert(GetFlagState(pt) != state);
 
     // new flag?
     if (!HasFlag(pt) && (state == FlagFinished || state == FlagRequested)) {
@@ -412,7 +500,8 @@ void World::SetFlagState(const MapPoint& pt, FlagState state)
         flags_.erase(std::find(flags_.begin(), flags_.end(), pt), flags_.end());
     }
 
-    nodes_[pt].flag = state;
+    nodeStates_.SetFlag(GetIdx(pt), state);
+    InvalidateBQ(pt);
 }
 
 bool World::IsPointConnected(const MapPoint& pt) const
@@ -445,22 +534,17 @@ bool World::IsPlayerTerritory(const MapPoint& pt, bool includeAnticipated) const
     return true;
 }
 
-bool World::HasRoad(const MapPoint& pt, Direction dir) const
+std::pair<unsigned, unsigned> World::GetRoadSlot(const MapPoint& pt, Direction dir) const
 {
-    MapPoint nodePt;
-    unsigned idx;
-
-    if (dir.native_value() >= 3) {
-        nodePt = pt;
-        idx = OppositeDirection(dir).native_value();
-    } else {
-        nodePt = GetNeighbour(pt, dir);
-        idx = dir.native_value();
-    }
+    if (dir.native_value() >= 3)
+        return { GetIdx(pt), OppositeDirection(dir).native_value() };
+    return { GetIdx(GetNeighbour(pt, dir)), dir.native_value() };
+}
 
-    const Node& node = nodes_[nodePt];
-    RoadState state = node.roads[idx];
-    return state == RoadRequested || state == RoadFinished || node.roadPlanCount[idx] > 0;
+bool World::HasRoad(const MapPoint& pt, Direction dir) const
+{
+    const std::pair<unsigned, unsigned> slot = GetRoadSlot(pt, dir);
+    return nodeStates_.HasRoad(slot.first, slot.second);
 }
 
 bool World::IsOnRoad(const MapPoint& pt) const
@@ -474,20 +558,24 @@ bool World::IsOnRoad(const MapPoint& pt) const
 
 RoadState World::GetRoadState(const MapPoint& pt, Direction dir) const
 {
-    Direction oppositeDir = OppositeDirection(dir);
-    if (dir.native_value() >= 3)
-        return nodes_[pt].roads[oppositeDir.native_value()];
-    else
-        return nodes_[GetNeighbour(pt, dir)].roads[dir.native_value()];
+    const std::pair<unsigned, unsigned> slot = GetRoadSlot(pt, dir);
+    return nodeStates_.GetRoad(slot.first, slot.second);
 }
 
 void World::SetRoadState(const MapPoint& pt, Direction dir, RoadState state)
 {
-    Direction oppositeDir = OppositeDirection(dir);
-    if (dir.native_value() >= 3)
-        nodes_[pt].roads[oppositeDir.native_value()] = state;
-    else
-        nodes_[GetNeighbour(pt, dir)].roads[dir.native_value()] = state;
+    bool hadRoad = HasRoad(pt, dir);
+
+    const std::pair<unsigned, unsigned> slot = GetRoadSlot(pt, dir);
+    nodeStates_.SetRoad(slot.first, slot.second, state);
+
+    bool hasRoad = HasRoad(pt, dir);
+    if (!hadRoad && hasRoad)
+        roadNetworks_.OnSegmentAdded(pt, dir);
+    else if (hadRoad && !hasRoad)
+        roadNetworks_.OnSegmentRemoved(pt, dir);
+    if (hadRoad != hasRoad)
+        InvalidateBQ(pt);
 }
 
 void World::SetRoadState(
@@ -507,14 +595,93 @@ BuildingQuality World::GetBQ(
         bool includeAnticipated,
         const std::vector<std::pair<MapPoint, BuildingQuality>>& tmps) const
 {
+    // Temporary buildings only change the BQ close to them.
+    const bool cacheable = std::none_of(tmps.begin(), tmps.end(),
+        [&](const std::pair<MapPoint, BuildingQuality>& tmp) { return CalcDistance(pt, tmp.first) <= S_bq_radius; });
+
+    const unsigned idx = GetIdx(pt);
+    BuildingQuality bq;
+    if (cacheable && bqCache_.Get(idx, includeAnticipated, bq))
+        return bq;
+
     BQCalculator2 bqc(*this, beowulf_->GetAII().gwb, tmps);
-    BuildingQuality bq = bqc(pt, [this, pt](const MapPoint& pt2){
+    bq = bqc(pt, [this, pt](const MapPoint& pt2){
         for (const auto dir : helpers::EnumRange<Direction>{})
             if (HasRoad(pt2, dir))
                 return true;
         return false;
     });
-    return AdjustBQ(pt, bq, includeAnticipated);
+    bq = AdjustBQ(pt, bq, includeAnticipated);
+
+    if (cacheable)
+        bqCache_.Set(idx, includeAnticipated, bq);
+    return bq;
+}
+
+void World::InvalidateBQ(const MapPoint& pt)
+{
+    VisitPointsInRadius(pt, S_bq_radius, [this](const MapPoint& p)
+    {
+        bqCache_.Invalidate(GetIdx(p));
+    }, true);
+}
+
+void World::InvalidateAnticipatedBQ(const MapPoint& pt, unsigned radius)
+{
+    VisitPointsInRadius(pt, radius + S_bq_radius, [this](const MapPoint& p)
+    {
+        bqCache_.InvalidateAnticipated(GetIdx(p));
+    }, true);
+}
+
+void World::AddToTerritory(const Building* building)
+{
+    // Other buildings only claim their own point (see IsOwner()).
+    const unsigned radius = GetMilitaryRadius(building->GetType());
+    ownMilitary_.Add(building->GetPt(), radius);
+    InvalidateAnticipatedBQ(building->GetPt(), radius);
+}
+
+void World::RemoveFromTerritory(const Building* building)
+{
+    const unsigned radius = GetMilitaryRadius(building->GetType());
+    ownMilitary_.Remove(building->GetPt(), radius);
+    InvalidateAnticipatedBQ(building->GetPt(), radius);
+}
+
+void World::RefreshEnemyMilitary()
+{
+    if (!enemyMilitaryDirty_)
+        return;
+    enemyMilitaryDirty_ = false;
+
+    std::vector<MilitaryDistanceMap::Source> current;
+    for (const WorldSnapshot::MilitaryBuilding& bld : GetMilitaryBuildings()) {
+        if (bld.player != aii_.GetPlayerId())
+            current.push_back({ bld.pos, bld.radius });
+    }
+    auto less = [this](const MilitaryDistanceMap::Source& l, const MilitaryDistanceMap::Source& r)
+    {
+        if (l.pt != r.pt)
+            return GetIdx(l.pt) < GetIdx(r.pt);
+        return l.radius < r.radius;
+    };
+    std::sort(current.begin(), current.end(), less);
+
+    // Both lists are sorted by map index. Only update the differences.
+    const std::vector<MilitaryDistanceMap::Source> previous = enemyMilitary_.GetSources();
+    std::vector<MilitaryDistanceMap::Source> removed, added;
+    std::set_difference(previous.begin(), previous.end(), current.begin(), current.end(), std::back_inserter(removed), less);
+    std::set_difference(current.begin(), current.end(), previous.begin(), previous.end(), std::back_inserter(added), less);
+
+    for (const MilitaryDistanceMap::Source& source : removed) {
+        enemyMilitary_.Remove(source.pt, source.radius);
+        InvalidateAnticipatedBQ(source.pt, source.radius);
+    }
+    for (const MilitaryDistanceMap::Source& source : added) {
+        enemyMilitary_.Add(source.pt, source.radius);
+        InvalidateAnticipatedBQ(source.pt, source.radius);
+    }
 }
 
 bool World::IsRoadPossible(
@@ -578,6 +745,8 @@ bool World::IsRoadPossible(
     if (!IsPlayerTerritory(dest, includeAnticipated))
         return false;
 
+    if (snapshot_)
+        return snapshot_->IsRoadAvailable(dest);
     return aii_.gwb.IsRoadAvailable(false, dest);
 }
 
@@ -586,7 +755,7 @@ std::vector<Direction> World::GetPath(
         const MapPoint& dst) const
 {
     std::vector<Direction> ret;
-    FindPath(src, *this, &ret,
+    pathFinder_.FindPath(src, &ret,
         [this](const MapPoint &pt, Direction dir) { return HasRoad(pt, dir); }, // Condition
         [&dst](const MapPoint& pt) { return pt == dst; }, // End
         [](const MapPoint&) { return 1; }, // Heuristic
@@ -600,36 +769,15 @@ std::pair<MapPoint, unsigned> World::GetNearestBuilding(
         const Building* self) const
 {
     // shortest euclidean distance.
-    unsigned dist = std::numeric_limits<unsigned>::max();
-    MapPoint closest = MapPoint::Invalid();
-
-    uint64_t query = 0;
-    for (BuildingType type : types)
-        query |= 1ul << static_cast<uint64_t>(type);
-
-    for (const Building* building : GetBuildings()) {
-        // Skip buildings of different type.
-        if (0 == (query & (1ul << static_cast<uint64_t>(building->GetType()))))
-            continue;
-        // Skip buildings that have no position yet.
-        if (!building->GetPt().isValid())
-            continue;
-        if (building == self)
-            continue;
-
-        unsigned d = CalcDistance(pt, building->GetPt());
-        if (d < dist) {
-            closest = building->GetPt();
-            dist = d;
-        }
-    }
-
-    return { closest, dist };
+    auto nearest = buildingIndex_.GetNearest(pt, types, self);
+    if (!nearest.first)
+        return { MapPoint::Invalid(), std::numeric_limits<unsigned>::max() };
+    return { nearest.first->GetPt(), nearest.second };
 }
 
 bool World::CanBuildMilitary(const MapPoint& pt) const
 {
-    if (aii_.gwb.IsMilitaryBuildingNearNode(pt, aii_.GetPlayerId()))
+    if (snapshot_ ? snapshot_->IsMilitaryBuildingNear(pt) : aii_.gwb.IsMilitaryBuildingNearNode(pt, aii_.GetPlayerId()))
         return false;
     for (const Building* bld : buildings_)
         if (BuildingProperties::IsMilitary(bld->GetType()))
@@ -665,6 +813,7 @@ Building* World::GetGoodsDest(
 
 const noBaseBuilding* World::GetBaseBuilding(const Building* building) const
 {
+    RTTR_Assert(!snapshot_); // Game objects must not be accessed while planning on a snapshot.
     if (!building)
         return nullptr;
 
@@ -690,6 +839,8 @@ World::ProductionGroup& World::CreateGroup(
 
 bool World::IsRestricted(const MapPoint& pt) const
 {
+    if (snapshot_)
+        return snapshot_->IsRestricted(pt);
     const auto& restrictions = aii_.gwb.GetPlayer(aii_.GetPlayerId()).GetRestrictedArea();
     return helpers::contains(restrictions, pt);
 }
@@ -698,9 +849,95 @@ bool World::IsVisible(const MapPoint& pt) const
 {
     if (!fow_)
         return true;
+    return CanSee(pt);
+}
+
+bool World::CanSee(const MapPoint& pt) const
+{
+    if (snapshot_)
+        return snapshot_->IsVisible(pt);
     return aii_.IsVisible(pt);
 }
 
+bool World::IsWalkable(const MapPoint& pt) const
+{
+    if (snapshot_)
+        return snapshot_->IsWalkable(pt);
+    return aii_.gwb.IsWalkable(pt);
+}
+
+bool World::FindHumanPath(
+        const MapPoint& start,
+        const MapPoint& dest,
+        unsigned maxLength,
+        HumanPathSearch& search) const
+{
+    const PathConditionHuman human(aii_.gwb);
+
+    if (search.visited.GetSize() != GetSize().x * GetSize().y)
+        search.visited.Resize(GetSize().x * GetSize().y);
+    search.visited.Clear();
+
+    // All edges have the same costs. A breadth first search finds the shortest route.
+    search.queue.clear();
+    search.queue.push_back({ start, 0 });
+    search.visited.Insert(GetIdx(start));
+
+    for (size_t i = 0; i < search.queue.size(); ++i) {
+        const MapPoint pt = search.queue[i].first;
+        const unsigned length = search.queue[i].second;
+        if (length >= maxLength)
+            continue;
+
+        for (const auto dir : helpers::EnumRange<Direction>{}) {
+            if (snapshot_ ? !snapshot_->IsHumanEdgeOk(pt, dir) : !human.IsEdgeOk(pt, dir))
+                continue;
+            const MapPoint next = GetNeighbour(pt, dir);
+            if (next == dest)
+                return true;
+            if (search.visited.Contains(GetIdx(next)))
+                continue;
+            if (snapshot_ ? !snapshot_->IsHumanNodeOk(next) : !human.IsNodeOk(next))
+                continue;
+            search.visited.Insert(GetIdx(next));
+            search.queue.push_back({ next, length + 1 });
+        }
+    }
+
+    return false;
+}
+
+std::vector<MapPoint> World::GetStorehouses() const
+{
+    std::vector<MapPoint> ret;
+    if (snapshot_) {
+        for (const WorldSnapshot::Storehouse& storehouse : snapshot_->GetStorehouses())
+            ret.push_back(storehouse.pos);
+    } else {
+        for (const nobBaseWarehouse* warehouse : aii_.GetStorehouses())
+            ret.push_back(warehouse->GetPos());
+    }
+    return ret;
+}
+
+const Inventory* World::GetInventory(const MapPoint& pt) const
+{
+    if (snapshot_)
+        return snapshot_->GetInventory(pt);
+
+    const nobBaseWarehouse* warehouse = aii_.gwb.GetSpecObj<nobBaseWarehouse>(pt);
+    if (!warehouse || warehouse->GetPlayer() != aii_.GetPlayerId())
+        return nullptr;
+    return &warehouse->GetInventory();
+}
+
+bool World::IsBuildingEnabled(BuildingType type) const
+{
+    if (snapshot_)
+        return snapshot_->IsBuildingEnabled(type);
+    return aii_.CanBuildBuildingtype(type);
+}
+
 bool World::CanConnectBuilding(
         const MapPoint& buildingFlag,
         const MapPoint& dst,
@@ -710,7 +947,7 @@ bool World::CanConnectBuilding(
     if (buildingFlag == dst)
         return true;
 
-    return FindPath(buildingFlag, *this, nullptr,
+    return pathFinder_.FindPath(buildingFlag, nullptr,
     // Condition
     [&](const MapPoint& pt, Direction dir)
     {
@@ -743,29 +980,7 @@ bool World::CanConnectBuilding(
 
 bool World::IsConnected(const MapPoint& src, const MapPoint& dst) const
 {
-    return FindPath(src, *this, nullptr,
-    // Condition
-    [&](const MapPoint& pt, Direction dir)
-    {
-        return HasRoad(pt, dir);
-    },
-    // End
-    [&](const MapPoint& pt)
-    {
-        // The search can end if we found a way to any flag of the destination
-        // road network.
-        return pt == dst;
-    },
-    // Heuristic
-    [&](const MapPoint& pt)
-    {
-        return CalcDistance(pt, dst);
-    },
-    // Cost
-    [&](const MapPoint&, Direction)
-    {
-        return 1;
-    });
+    return roadNetworks_.IsConnected(src, dst);
 }
 
 void World::SetCaptured(Building* building)
@@ -782,16 +997,27 @@ std::vector<const noBaseBuilding*> World::GetEnemyCatapultsInReach(const MapPoin
 
     VisitPointsInRadius(pt, CATAPULT_ATTACK_RANGE, [&](const MapPoint& p)
     {
-        const noBase* obj = aii_.gwb.GetNO(p);
-        if (!(obj->GetType() == NOP_BUILDING || obj->GetType() == NOP_BUILDINGSITE))
-            return;
+        const noBaseBuilding* bld;
+        BuildingType buildingType;
+        if (snapshot_) {
+            const WorldSnapshot::NodeBuilding* nodeBld = snapshot_->GetBuilding(p);
+            if (!nodeBld)
+                return;
+            bld = nodeBld->obj;
+            buildingType = nodeBld->type;
+        } else {
+            const noBase* obj = aii_.gwb.GetNO(p);
+            if (!(obj->GetType() == NOP_BUILDING || obj->GetType() == NOP_BUILDINGSITE))
+                return;
+            bld = static_cast<const noBaseBuilding*>(obj);
+            buildingType = bld->GetBuildingType();
+        }
 
-        BuildingType buildingType = static_cast<const noBaseBuilding*>(obj)->GetBuildingType();
         if (buildingType != BLD_CATAPULT)
             return;
 
-        if (aii_.IsPlayerAttackable(aii_.gwb.GetNode(p).owner))
-            ret.push_back(static_cast<const noBaseBuilding*>(obj));
+        if (IsPlayerAttackable(GetOwner(p)))
+            ret.push_back(bld);
     }, false);
 
     return ret;
@@ -801,18 +1027,17 @@ unsigned World::GetEnemySoldiersInReach(const MapPoint& pt) const
 {
     unsigned ret = 0;
 
-    sortedMilitaryBlds blds = aii_.gwb.LookForMilitaryBuildings(pt, 2);
-    for (const nobBaseMilitary* bld : blds) {
-        if (bld->GetGOT() != GOT_NOB_MILITARY)
+    for (const WorldSnapshot::MilitaryBuilding& bld : GetMilitaryBuildings(pt, 2)) {
+        if (!bld.isMilitary)
             continue;
-        if (!aii_.IsPlayerAttackable(bld->GetPlayer()))
+        if (!IsPlayerAttackable(bld.player))
             continue;
-        if (fow_ && !aii_.IsVisible(bld->GetPos()))
+        if (fow_ && !CanSee(bld.pos))
             continue;
-        if (CalcDistance(pt, bld->GetPos()) >= BASE_ATTACKING_DISTANCE)
+        if (CalcDistance(pt, bld.pos) >= BASE_ATTACKING_DISTANCE)
             continue;
 
-        switch (bld->GetBuildingType()) {
+        switch (bld.type) {
         case BLD_BARRACKS:
             ret += 2 - 1;
             break;
@@ -837,10 +1062,10 @@ bool World::IsEnemyNear(const MapPoint& pt, unsigned radius) const
     return CheckPointsInRadius(pt, radius, [&](const MapPoint& p, unsigned)
     {
         if (fow_)
-            if (!aii_.IsVisible(p))
+            if (!CanSee(p))
                 return false;
 
-        unsigned char owner = aii_.gwb.GetNode(p).owner;
+        unsigned char owner = GetOwner(p);
         if (owner > 0 && owner != (aii_.GetPlayerId() + 1))
             return true;
         return false;
@@ -853,12 +1078,6 @@ void World::PredictExpansionResults(
         std::vector<MapPoint>& additionalTerritory,
         std::vector<const noBaseBuilding*>& destroyed) const
 {
-    /*
-     * enemies = all military buildings of other players close by.
-     * additionalOwned = all points we are now closest to.
-     * additionalTerritory = all points we now own (or did own) that is not a border.
-     */
-
     additionalTerritory.clear();
     destroyed.clear();
 
@@ -866,25 +1085,80 @@ void World::PredictExpansionResults(
     if (0 == radius)
         return;
 
-    // We assume that a military building can be placed here.
-
     // Get enemy military buildings in range.
     // (Largest known military radius + radius of the new building.)
-    std::vector<const nobBaseMilitary*> enemies;
+    std::vector<WorldSnapshot::MilitaryBuilding> enemies;
     unsigned short enemySearchRadius = static_cast<unsigned short>(HQ_RADIUS + radius);
-    for (const nobBaseMilitary* mb : aii_.gwb.LookForMilitaryBuildings(pt, enemySearchRadius)) {
-        if (mb->GetPlayer() != aii_.GetPlayerId() && mb->GetPos() != pt)
+    for (const WorldSnapshot::MilitaryBuilding& mb : GetMilitaryBuildings(pt, enemySearchRadius)) {
+        if (mb.player != aii_.GetPlayerId() && mb.pos != pt)
             enemies.push_back(mb);
     }
 
-    struct Prediction {
-        bool alreadyTerritory = false;
-        bool owned = false;
-        bool additionallyOwned = false;
-        bool destructionChecked = false;
-    };
-    std::map<MapPoint, Prediction, MapPointComp> predictions;
-    std::set<const noBaseBuilding*> destroyedSet;
+    BeginPredictions();
+    PredictExpansion(pt, type, enemies, additionalTerritory, destroyed);
+}
+
+void World::PredictExpansionResults(
+        const std::vector<ExpansionCandidate>& candidates,
+        std::vector<ExpansionResult>& results) const
+{
+    results.resize(candidates.size());
+
+    std::vector<WorldSnapshot::MilitaryBuilding> allEnemies;
+    for (const WorldSnapshot::MilitaryBuilding& mb : GetMilitaryBuildings()) {
+        if (mb.player != aii_.GetPlayerId())
+            allEnemies.push_back(mb);
+    }
+
+    BeginPredictions();
+
+    std::vector<WorldSnapshot::MilitaryBuilding> enemies;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const ExpansionCandidate& candidate = candidates[i];
+        ExpansionResult& result = results[i];
+        result.additionalTerritory.clear();
+        result.destroyed.clear();
+
+        unsigned radius = GetMilitaryRadius(candidate.type);
+        if (0 == radius)
+            continue;
+
+        // Only enemies whose territory overlaps with the new one can keep points.
+        enemies.clear();
+        for (const WorldSnapshot::MilitaryBuilding& mb : allEnemies) {
+            if (mb.pos != candidate.pt && CalcDistance(mb.pos, candidate.pt) <= radius + mb.radius)
+                enemies.push_back(mb);
+        }
+
+        PredictExpansion(candidate.pt, candidate.type, enemies, result.additionalTerritory, result.destroyed);
+    }
+}
+
+void World::PredictExpansion(
+        const MapPoint& pt,
+        BuildingType type,
+        const std::vector<WorldSnapshot::MilitaryBuilding>& enemies,
+        std::vector<MapPoint>& additionalTerritory,
+        std::vector<const noBaseBuilding*>& destroyed) const
+{
+    /*
+     * enemies = all military buildings of other players close by.
+     * additionalOwned = all points we are now closest to.
+     * additionalTerritory = all points we now own (or did own) that is not a border.
+     */
+
+    // We assume that a military building can be placed here.
+    const unsigned radius = GetMilitaryRadius(type);
+
+    // If the counter reaches its maximum, tidy up.
+    if (currentPrediction_ == std::numeric_limits<unsigned>::max()) {
+        for (PredictionNode& node : predictionNodes_)
+            node.prediction = 0;
+        currentPrediction_ = 1;
+    } else {
+        currentPrediction_++;
+    }
+    predictionPoints_.clear();
 
     // Visit every point in military radius + 2 and check for new ownership and existing
     // enemy buildings.
@@ -893,53 +1167,52 @@ void World::PredictExpansionResults(
         if (IsRestricted(p))
             return;
 
-        Prediction& prediction = predictions[p];
+        PredictionNode& prediction = GetPredictionNode(p);
+        predictionPoints_.push_back(p);
 
         // Already player territory or about to become?
         if (IsOwner(p, true)) {
-            prediction.owned = true;
+            prediction.flags |= PredictionNode::Owned;
             if (IsPlayerTerritory(p, true))
-                prediction.alreadyTerritory = true;
+                prediction.flags |= PredictionNode::AlreadyTerritory;
             return;
         }
 
         unsigned distance = CalcDistance(pt, p);
         if (distance <= radius) {
-            if (IsCloserThanEnemy(p, distance, enemies)) {
-                prediction.owned = true;
-                prediction.additionallyOwned = true;
-            }
+            if (IsCloserThanEnemy(p, distance, enemies))
+                prediction.flags |= PredictionNode::Owned | PredictionNode::AdditionallyOwned;
         }
 
         // Destroy all buildings around a point where the owner changed.
-        if (!prediction.additionallyOwned)
+        if (!(prediction.flags & PredictionNode::AdditionallyOwned))
             return;
-        if (aii_.gwb.GetNode(p).owner == aii_.GetPlayerId() + 1)
+        if (GetOwner(p) == aii_.GetPlayerId() + 1)
             return;
 
         VisitPointsInRadius(p, 1, [&](const MapPoint& destroyPt)
         {
-            if (!predictions[destroyPt].destructionChecked) {
-                predictions[destroyPt].destructionChecked = true;
-
-                const noBaseBuilding* bld = GetEnemyBuilding(destroyPt);
-                if (bld && bld->GetPos() != pt)
-                    destroyedSet.insert(bld);
-            }
+            PredictionNode& node = GetPredictionNode(destroyPt);
+            if (node.flags & PredictionNode::DestructionChecked)
+                return;
+            node.flags |= PredictionNode::DestructionChecked;
+
+            // A building and its flag may both be close to owned points.
+            const WorldSnapshot::NodeBuilding* bld = GetPredictedEnemyBuilding(destroyPt, node);
+            if (bld && bld->pos != pt && !helpers::contains(destroyed, bld->obj))
+                destroyed.push_back(bld->obj);
         }, true);
     }, true);
 
     // Filter all border points to create additionalTerritory.
-    for (const auto& prediction : predictions) {
-        if (prediction.second.alreadyTerritory)
+    for (const MapPoint& p : predictionPoints_) {
+        if (predictionNodes_[GetIdx(p)].flags & PredictionNode::AlreadyTerritory)
             continue;
 
-        const MapPoint& p = prediction.first;
-
         bool isBorder = false;
         for (const auto dir : helpers::EnumRange<Direction>{}) {
-            MapPoint neighbour = GetNeighbour(p, dir);
-            if (!predictions[neighbour].owned) {
+            const PredictionNode& neighbour = predictionNodes_[GetIdx(GetNeighbour(p, dir))];
+            if (neighbour.prediction != currentPrediction_ || !(neighbour.flags & PredictionNode::Owned)) {
                 isBorder = true;
                 break;
             }
@@ -947,28 +1220,79 @@ void World::PredictExpansionResults(
         if (!isBorder)
             additionalTerritory.push_back(p);
     }
+}
+
+void World::BeginPredictions() const
+{
+    if (predictionNodes_.empty())
+        predictionNodes_.resize(static_cast<size_t>(GetSize().x) * GetSize().y);
 
-    std::copy(destroyedSet.begin(), destroyedSet.end(), std::back_inserter(destroyed));
+    if (currentBatch_ == std::numeric_limits<unsigned>::max()) {
+        for (PredictionNode& node : predictionNodes_)
+            node.batch = 0;
+        currentBatch_ = 1;
+    } else {
+        currentBatch_++;
+    }
+    predictedBuildings_.clear();
+}
+
+World::PredictionNode& World::GetPredictionNode(const MapPoint& pt) const
+{
+    PredictionNode& node = predictionNodes_[GetIdx(pt)];
+    if (node.prediction != currentPrediction_) {
+        node.prediction = currentPrediction_;
+        node.flags = 0;
+    }
+    return node;
+}
+
+const WorldSnapshot::NodeBuilding* World::GetPredictedEnemyBuilding(const MapPoint& pt, PredictionNode& node) const
+{
+    if (node.batch != currentBatch_) {
+        node.batch = currentBatch_;
+        node.enemyBuilding = -1;
+        const WorldSnapshot::NodeBuilding bld = GetEnemyBuilding(pt);
+        if (bld.obj) {
+            node.enemyBuilding = static_cast<int>(predictedBuildings_.size());
+            predictedBuildings_.push_back(bld);
+        }
+    }
+    return node.enemyBuilding < 0 ? nullptr : &predictedBuildings_[node.enemyBuilding];
 }
 
 void World::PlanSegment(const MapPoint& pt, Direction dir)
 {
-    if (dir.native_value() >= 3)
-        nodes_[pt].roadPlanCount[OppositeDirection(dir).native_value()]++;
-    else
-        nodes_[GetNeighbour(pt, dir)].roadPlanCount[dir.native_value()]++;
+    if (!HasRoad(pt, dir)) {
+        roadNetworks_.OnSegmentAdded(pt, dir);
+        InvalidateBQ(pt);
+    }
+
+    // The road is logged at its owning node (see GetRoadSlot()).
+    const std::pair<unsigned, unsigned> slot = GetRoadSlot(pt, dir);
+    const MapPoint nodePt = dir.native_value() >= 3 ? pt : GetNeighbour(pt, dir);
+    const uint8_t previousCount = nodeStates_.PlanRoad(slot.first, slot.second);
+    planLog_.push_back({ PlanChange::PlannedRoad, static_cast<uint8_t>(slot.second), previousCount,
+                         nodePt, nullptr, MapPoint::Invalid() });
 }
 
 void World::SetPoint(Building* building, const MapPoint& pt)
 {
-    Node& node = nodes_[pt];
-    RTTR_Assert(node.building == nullptr);
+    RTTR_Assert(nodeBuildings_[pt] == nullptr);
 
-    if (building->pt_.isValid())
-        nodes_[building->pt_].building = nullptr;
+    if (building->pt_.isValid()) {
+        nodeBuildings_[building->pt_] = nullptr;
+        buildingIndex_.Remove(building);
+        InvalidateBQ(building->pt_);
+        RemoveFromTerritory(building);
+    }
 
-    node.building = building;
+    nodeBuildings_[pt] = building;
     building->pt_ = pt;
+    buildingIndex_.Add(building);
+    InvalidateBQ(pt);
+    AddToTerritory(building);
+    buildingChanges_++;
 
     resources.Added(pt, building->GetType());
 }
@@ -977,8 +1301,7 @@ BlockingManner World::GetBM(
         const MapPoint& pt,
         const std::vector<std::pair<MapPoint, BuildingQuality>>& tmps) const
 {
-    const Node& node = nodes_[pt];
-    if (node.building)
+    if (nodeBuildings_[pt])
         return BlockingManner::Building;
 
     if (HasFlag(pt))
@@ -986,7 +1309,7 @@ BlockingManner World::GetBM(
 
     // Check for castle extensions
     for (unsigned dir = Direction::EAST; dir < Direction::COUNT; ++dir) {
-        Building* building = nodes_[GetNeighbour(pt, Direction(dir))].building;
+        Building* building = nodeBuildings_[GetNeighbour(pt, Direction(dir))];
         if (building && building->GetQuality() == BQ_CASTLE) {
             return BlockingManner::Single;
         }
@@ -1017,39 +1340,20 @@ BlockingManner World::GetBM(
 bool World::IsOwner(const MapPoint& pt, bool includeAnticipated) const
 {
     // Already owned without planned buildings?
-    if (aii_.gwb.GetNode(pt).owner == aii_.GetPlayerId() + 1)
+    if (GetOwner(pt) == aii_.GetPlayerId() + 1)
         return true;
 
     if (!includeAnticipated)
         return false;
 
-    // @performance: Buffer pressure of our buildings in nodes_.
-
-    // Calculate distance of our buildings to the point.
-    unsigned ourDistance = std::numeric_limits<unsigned>::max();
-
-    for (const Building* bld : buildings_) {
-        if (!bld->GetPt().isValid())
-            continue;
-        unsigned distance = CalcDistance(bld->GetPt(), pt);
-        if (distance > GetMilitaryRadius(bld->GetType()))
-            continue;
-        ourDistance = std::min(distance, ourDistance);
-    }
-
-    if (std::numeric_limits<unsigned>::max() == ourDistance)
+    // Closest of our buildings whose military radius covers 'pt'.
+    const unsigned ourDistance = ownMilitary_.Get(pt);
+    if (MilitaryDistanceMap::NotCovered == ourDistance)
         return false;
 
-    // Get enemy military buildings in range (largest known military radius).
-    for (const nobBaseMilitary* bld : aii_.gwb.LookForMilitaryBuildings(pt, HQ_RADIUS)) {
-        if (bld->GetPlayer() == aii_.GetPlayerId())
-            continue;
-        unsigned distance = CalcDistance(bld->GetPos(), pt);
-        if (distance > bld->GetMilitaryRadius())
-            continue;
-        if (distance < ourDistance)
-            return false;
-    }
+    // Enemy military buildings that are closer keep the point.
+    if (enemyMilitary_.Get(pt) < ourDistance)
+        return false;
 
     // @todo: Filter out GamePlayer::GetRestrictedArea.
 
@@ -1222,11 +1526,14 @@ void World::OnFlagNote(const FlagNote& note)
     }
 }
 
-bool World::IsCloserThanEnemy(const MapPoint& pt, unsigned distance, std::vector<const nobBaseMilitary*> enemies) const
+bool World::IsCloserThanEnemy(
+        const MapPoint& pt,
+        unsigned distance,
+        const std::vector<WorldSnapshot::MilitaryBuilding>& enemies) const
 {
-    for (const nobBaseMilitary* bld : enemies) {
-        unsigned enemyDistance = CalcDistance(bld->GetPos(), pt);
-        if (enemyDistance > bld->GetMilitaryRadius())
+    for (const WorldSnapshot::MilitaryBuilding& bld : enemies) {
+        unsigned enemyDistance = CalcDistance(bld.pos, pt);
+        if (enemyDistance > bld.radius)
             continue;
         if (enemyDistance < distance)
             return false;
@@ -1235,20 +1542,99 @@ bool World::IsCloserThanEnemy(const MapPoint& pt, unsigned distance, std::vector
     return true;
 }
 
-const noBaseBuilding* World::GetEnemyBuilding(const MapPoint& pt) const
+WorldSnapshot::NodeBuilding World::GetEnemyBuilding(const MapPoint& pt) const
 {
-    const MapNode& node = aii_.gwb.GetNode(pt);
-    if (node.owner == aii_.GetPlayerId() + 1 || node.owner == 0)
-        return nullptr;
-    noBase* no = node.obj;
+    WorldSnapshot::NodeBuilding ret{ nullptr, pt, BuildingType() };
+
+    const unsigned char owner = GetOwner(pt);
+    if (owner == aii_.GetPlayerId() + 1 || owner == 0)
+        return ret;
+
+    if (snapshot_) {
+        const NodalObjectType noType = snapshot_->GetNOType(pt);
+        if (noType == NOP_BUILDING || noType == NOP_BUILDINGSITE)
+            return *snapshot_->GetBuilding(pt);
+        if (noType == NOP_FLAG)
+            return GetEnemyBuilding(GetNeighbour(pt, Direction::NORTHWEST));
+        return ret;
+    }
+
+    noBase* no = aii_.gwb.GetNode(pt).obj;
     if (nullptr == no)
-        return nullptr;
+        return ret;
     const NodalObjectType noType = no->GetType();
-    if (noType == NOP_BUILDING || noType == NOP_BUILDINGSITE)
-        return static_cast<const noBaseBuilding*>(no);
+    if (noType == NOP_BUILDING || noType == NOP_BUILDINGSITE) {
+        ret.obj = static_cast<const noBaseBuilding*>(no);
+        ret.type = ret.obj->GetBuildingType();
+        return ret;
+    }
     if (noType == NOP_FLAG)
         return GetEnemyBuilding(GetNeighbour(pt, Direction::NORTHWEST));
-    return nullptr;
+    return ret;
+}
+
+unsigned char World::GetOwner(const MapPoint& pt) const
+{
+    if (snapshot_)
+        return snapshot_->GetOwner(pt);
+    return aii_.gwb.GetNode(pt).owner;
+}
+
+BlockingManner World::GetNodeBM(const MapPoint& pt) const
+{
+    if (snapshot_)
+        return snapshot_->GetBM(pt);
+    return aii_.gwb.GetNO(pt)->GetBM();
+}
+
+unsigned char World::GetAltitude(const MapPoint& pt) const
+{
+    if (snapshot_)
+        return snapshot_->GetAltitude(pt);
+    return aii_.gwb.GetNode(pt).altitude;
+}
+
+bool World::IsHarborPoint(const MapPoint& pt) const
+{
+    if (snapshot_)
+        return snapshot_->IsHarborPoint(pt);
+    return aii_.gwb.GetNode(pt).harborId != 0;
+}
+
+bool World::IsPlayerAttackable(unsigned char player) const
+{
+    if (snapshot_)
+        return snapshot_->IsPlayerAttackable(player);
+    return aii_.IsPlayerAttackable(player);
+}
+
+std::vector<WorldSnapshot::MilitaryBuilding> World::GetMilitaryBuildings() const
+{
+    if (snapshot_)
+        return snapshot_->GetMilitaryBuildings();
+
+    std::vector<WorldSnapshot::MilitaryBuilding> ret;
+    for (unsigned i = 0; i < aii_.gwb.GetNumPlayers(); ++i) {
+        const BuildingRegister& buildings = aii_.gwb.GetPlayer(i).GetBuildingRegister();
+        for (const nobMilitary* bld : buildings.GetMilitaryBuildings())
+            ret.push_back({ bld, bld->GetPos(), bld->GetBuildingType(), bld->GetPlayer(), bld->GetMilitaryRadius(), true });
+        for (const nobBaseWarehouse* bld : buildings.GetStorehouses())
+            ret.push_back({ bld, bld->GetPos(), bld->GetBuildingType(), bld->GetPlayer(), bld->GetMilitaryRadius(), false });
+    }
+    return ret;
+}
+
+std::vector<WorldSnapshot::MilitaryBuilding> World::GetMilitaryBuildings(const MapPoint& pt, unsigned short radius) const
+{
+    if (snapshot_)
+        return snapshot_->GetMilitaryBuildings(pt, radius);
+
+    std::vector<WorldSnapshot::MilitaryBuilding> ret;
+    for (const nobBaseMilitary* bld : aii_.gwb.LookForMilitaryBuildings(pt, radius)) {
+        ret.push_back({ bld, bld->GetPos(), bld->GetBuildingType(), bld->GetPlayer(),
+                        bld->GetMilitaryRadius(), bld->GetGOT() == GOT_NOB_MILITARY });
+    }
+    return ret;
 }
 
 std::pair<MapPoint, unsigned>
@@ -1262,8 +1648,9 @@ World::GroupMemberDistance(
     if (group == InvalidProductionGroup)
         return ret;
 
-    for (const Building* bld : buildings_) {
-        if (bld->GetType() != type || bld->GetGroup() != group)
+    // Groups only have a handful of members.
+    for (const Building* bld : groups[group].buildings) {
+        if (!bld || bld->GetType() != type || !bld->GetFlag().isValid())
             continue;
         unsigned dist = CalcDistance(bld->GetFlag(), pt);
         if (dist < ret.second) {
@@ -1285,8 +1672,8 @@ unsigned World::GetMaxGroupMemberDistance(
 
     unsigned ret = std::numeric_limits<unsigned>::max();
 
-    for (const Building* bld : buildings_) {
-        if (bld->GetType() != type || bld->GetGroup() != group || !bld->GetFlag().isValid())
+    for (const Building* bld : groups[group].buildings) {
+        if (!bld || bld->GetType() != type || !bld->GetFlag().isValid())
             continue;
         unsigned dist = CalcDistance(bld->GetFlag(), pt);
         if (dist > ret || dist == std::numeric_limits<unsigned>::max())
@@ -1301,7 +1688,22 @@ BlockingManner World::BQCalculator2::GetBM(const MapPoint& pt) const
     BlockingManner bm = world2.GetBM(pt, tmps_);
     if (bm != BlockingManner::None)
         return bm;
-    return world.GetNO(pt)->GetBM();
+    return GetNodeBM(pt);
+}
+
+BlockingManner World::BQCalculator2::GetNodeBM(const MapPoint& pt) const
+{
+    return world2.GetNodeBM(pt);
+}
+
+unsigned char World::BQCalculator2::GetAltitude(const MapPoint& pt) const
+{
+    return world2.GetAltitude(pt);
+}
+
+bool World::BQCalculator2::IsHarborPoint(const MapPoint& pt) const
+{
+    return world2.IsHarborPoint(pt);
 }
 
 } // namespace beowulf
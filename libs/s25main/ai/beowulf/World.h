@@ -19,7 +19,17 @@
 
 #include "ai/beowulf/Types.h"
 #include "ai/beowulf/Building.h"
+#include "ai/beowulf/BuildingPool.h"
 #include "ai/beowulf/Resources.h"
+#include "ai/beowulf/PathFinder.h"
+#include "ai/beowulf/RoadNetworks.h"
+#include "ai/beowulf/BQCache.h"
+#include "ai/beowulf/BuildingIndex.h"
+#include "ai/beowulf/MilitaryDistanceMap.h"
+#include "ai/beowulf/NodeStates.h"
+#include "ai/beowulf/NodeContainers.h"
+#include "ai/beowulf/NoteQueue.h"
+#include "ai/beowulf/WorldSnapshot.h"
 
 #include "ai/AIInterface.h"
 #include "gameTypes/MapCoordinates.h"
@@ -27,12 +37,14 @@
 #include "world/BQCalculator.h"
 #include "notifications/Subscription.h"
 
+#include <cstdint>
 #include <vector>
 #include <utility> /* pair */
 
 class BuildingNote;
 class RoadNote;
 class FlagNote;
+struct Inventory;
 
 namespace beowulf {
 
@@ -46,6 +58,11 @@ class Beowulf;
  *
  * What makes Buildings especially complex is that while the planner is running, the world can change.
  * Therefore, every change of the world (building/flag/roadsegment added or removed) will clear the plan.
+ * Every planning operation is recorded in a log. Clearing the plan (or rolling back to a savepoint)
+ * only undoes the logged changes.
+ *
+ * While a snapshot is set (see SetSnapshot()), all reads of the game state go to the snapshot
+ * instead of the game world.
  */
 class World : public MapBase
 {
@@ -53,6 +70,8 @@ public:
     World(Beowulf* beowulf, bool fow);
     virtual ~World();
 
+    /// All notifications for Beowulf go through this queue (see NoteQueue).
+    NoteQueue notes;
     Resources resources;
 
     struct ProductionGroup
@@ -84,7 +103,14 @@ public:
     void Plan(Building* building, const MapPoint& pt);
     void PlanFlag(const MapPoint& pt); // Ignored if already has plan at 'pt'.
     void PlanRoad(const MapPoint& pt, const std::vector<Direction>& route);
+    /// Undo the whole plan. Planned buildings keep their point but are removed from their node.
     void ClearPlan();
+    /// Position in the plan log. Plans made afterwards can be undone with RollbackPlan().
+    typedef size_t PlanSavepoint;
+    PlanSavepoint SavePlan() const { return planLog_.size(); }
+    /// Undo all plans made after 'savepoint' (e.g. to try alternatives).
+    /// Planned buildings return to the point they had before.
+    void RollbackPlan(PlanSavepoint savepoint);
 
     // Remove (remove the object from our data structure)
     void Remove(Building* building);
@@ -94,8 +120,13 @@ public:
     // Buildings
     Building* Create(BuildingType type, Building::State state, unsigned group = InvalidProductionGroup, const MapPoint& pt = MapPoint::Invalid());
     const std::vector<Building*>& GetBuildings() const { return buildings_; }
+    /// Increased whenever a building is created, removed or placed on its node (not by plans).
+    unsigned GetBuildingChanges() const { return buildingChanges_; }
     std::vector<Building*> GetBuildings(BuildingType type) const;
     Building* GetBuilding(const MapPoint& pt) const;
+    /// Building of 'handle' or nullptr if it has been removed in the meantime.
+    Building* GetBuilding(const BuildingHandle& handle) const { return buildingPool_.Get(handle); }
+    BuildingHandle GetHandle(const Building* building) const { return buildingPool_.GetHandle(building); }
     Building* GetHQ() const;
     const MapPoint& GetHQFlag() const { return hqFlag_; }
     bool HasBuilding(const MapPoint& pt) const;
@@ -122,7 +153,12 @@ public:
     bool IsRoadPossible(const MapPoint& pt, Direction dir, bool includeAnticipated, const std::vector<std::pair<MapPoint, BuildingQuality>>& tmps = {}) const;
     std::vector<Direction> GetPath(const MapPoint& src, const MapPoint& dst) const;
     bool CanConnectBuilding(const MapPoint& buildingFlag, const MapPoint& dst, bool includeAnticipated, const std::vector<std::pair<MapPoint, BuildingQuality>>& tmps = {}) const;
+    /// Check if 'src' and 'dst' are part of the same road network (including planned roads).
     bool IsConnected(const MapPoint& src, const MapPoint& dst) const;
+    /// Road network 'pt' belongs to or RoadNetworks::InvalidNetwork. Only valid until the roads change.
+    unsigned GetRoadNetwork(const MapPoint& pt) const { return roadNetworks_.GetNetwork(pt); }
+    /// Path search engine with buffers sized for this world. Searches must not be nested.
+    PathFinder& GetPathFinder() const { return pathFinder_; }
 
     // Border/Territory
     bool IsBorder(const MapPoint& pt, bool includeAnticipated) const;
@@ -130,8 +166,15 @@ public:
     /// Check if the given point is part of player territory or will become
     /// part of it once a military building finishes.
     bool IsOwner(const MapPoint& pt, bool includeAnticipated) const;
+    /// Update the known enemy military buildings if the territory changed since the last update.
+    /// Should be done before planning, since new military buildings only change the territory once occupied.
+    void RefreshEnemyMilitary();
+    /// Distance to the closest known enemy military building covering 'pt' (see MilitaryDistanceMap::Get()).
+    unsigned GetEnemyMilitaryDistance(const MapPoint& pt) const { return enemyMilitary_.Get(pt); }
 
     // Building Quality
+    /// BQs without 'tmps' (or far from them) are cached until a change of plans, roads, flags
+    /// or the game world close to 'pt'.
     BuildingQuality GetBQ(const MapPoint& pt, bool includeAnticipated, const std::vector<std::pair<MapPoint, BuildingQuality>>& tmps = {}) const;
 
     // Helper
@@ -146,6 +189,8 @@ public:
     std::pair<MapPoint, unsigned> GroupMemberDistance(const MapPoint& pt, unsigned group, BuildingType type) const;
     unsigned GetMaxGroupMemberDistance(const MapPoint& pt, unsigned group, BuildingType type) const;
     std::pair<MapPoint, unsigned> GetNearestBuilding(const MapPoint& pt, const std::vector<BuildingType>& types, const Building* self = nullptr) const;
+    /// Spatial index of all buildings with a point (k-nearest and radius queries).
+    const BuildingIndex& GetBuildingIndex() const { return buildingIndex_; }
     bool CanBuildMilitary(const MapPoint& pt) const;
 
     /// Predict the results of a territory expansion.
@@ -155,24 +200,92 @@ public:
             std::vector<MapPoint>& additionalTerritory,
             std::vector<const noBaseBuilding*>& destroyed) const;
 
+    struct ExpansionCandidate
+    {
+        MapPoint pt;
+        BuildingType type;
+    };
+    struct ExpansionResult
+    {
+        std::vector<MapPoint> additionalTerritory;
+        std::vector<const noBaseBuilding*> destroyed;
+    };
+    /// PredictExpansionResults() for many candidates. The enemy military buildings and the
+    /// enemy buildings on nodes are looked up once for all of them.
+    /// 'results' has the order of 'candidates'.
+    void PredictExpansionResults(const std::vector<ExpansionCandidate>& candidates, std::vector<ExpansionResult>& results) const;
+
     bool IsPlanning() const { return activePlan_; }
 
     bool IsRestricted(const MapPoint& pt) const;
     bool IsVisible(const MapPoint& pt) const;
+    /// Whether the player sees 'pt' right now (regardless of Beowulf using FOW).
+    bool CanSee(const MapPoint& pt) const;
+    bool IsWalkable(const MapPoint& pt) const;
+    /// GameWorldBase::FindHumanPath() without the route. Uses the buffers of 'search' instead
+    /// of the game worlds path finder, so threads with their own 'search' may run it in parallel.
+    bool FindHumanPath(const MapPoint& start, const MapPoint& dest, unsigned maxLength, HumanPathSearch& search) const;
+
+    /// Positions of our storehouses (including HQ and harbors).
+    std::vector<MapPoint> GetStorehouses() const;
+    /// Inventory of our storehouse at 'pt' or nullptr.
+    const Inventory* GetInventory(const MapPoint& pt) const;
+    bool IsBuildingEnabled(BuildingType type) const;
+
+    /// Read the game state from 'snapshot' instead of the game world (nullptr to read the game world again).
+    /// The snapshot must outlive its use.
+    void SetSnapshot(const WorldSnapshot* snapshot) { snapshot_ = snapshot; }
+    const WorldSnapshot* GetSnapshot() const { return snapshot_; }
 
 private:
     void SetRoadState(const MapPoint& pt, Direction dir, RoadState state);
+    /// Node owning the road from 'pt' in 'dir' and the index of the road at that node (see NodeStates).
+    std::pair<unsigned, unsigned> GetRoadSlot(const MapPoint& pt, Direction dir) const;
     void PlanSegment(const MapPoint& pt, Direction dir);
+    /// Undo the logged plans after 'size'.
+    void UndoPlan(size_t size, bool restorePoints);
     BlockingManner GetBM(const MapPoint& pt, const std::vector<std::pair<MapPoint, BuildingQuality>>& tmps = {}) const;
     BuildingQuality AdjustBQ(const MapPoint pt, BuildingQuality nodeBQ, bool includeAnticipated) const;
+    /// Invalidate cached BQs after the blocking manner, roads or owner at 'pt' changed.
+    void InvalidateBQ(const MapPoint& pt);
+    /// Invalidate cached anticipated BQs after the territory in 'radius' around 'pt' changed.
+    void InvalidateAnticipatedBQ(const MapPoint& pt, unsigned radius);
+    /// Keep the anticipated territory of our buildings (called whenever their point changes).
+    void AddToTerritory(const Building* building);
+    void RemoveFromTerritory(const Building* building);
 
     void OnBuildingNote(const BuildingNote& note);
     void OnRoadNote(const RoadNote& note);
     void OnFlagNote(const FlagNote& note);
 
-    bool IsCloserThanEnemy(const MapPoint& pt, unsigned distance, std::vector<const nobBaseMilitary*> enemies) const;
-
-    const noBaseBuilding* GetEnemyBuilding(const MapPoint& pt) const;
+    bool IsCloserThanEnemy(const MapPoint& pt, unsigned distance, const std::vector<WorldSnapshot::MilitaryBuilding>& enemies) const;
+    /// Prediction of a single candidate. 'enemies' are the enemy military buildings that may cover its territory.
+    void PredictExpansion(
+            const MapPoint& pt, BuildingType type,
+            const std::vector<WorldSnapshot::MilitaryBuilding>& enemies,
+            std::vector<MapPoint>& additionalTerritory,
+            std::vector<const noBaseBuilding*>& destroyed) const;
+    /// Start a new batch of predictions (invalidates the cached enemy buildings).
+    void BeginPredictions() const;
+    /// Scratch data of 'pt' for the current prediction.
+    struct PredictionNode;
+    PredictionNode& GetPredictionNode(const MapPoint& pt) const;
+    /// GetEnemyBuilding() cached for the current batch of predictions. nullptr if there is none.
+    const WorldSnapshot::NodeBuilding* GetPredictedEnemyBuilding(const MapPoint& pt, PredictionNode& node) const;
+
+    /// Enemy building (or building site) at 'pt' or at the building point of a flag at 'pt'. 'obj' is nullptr if there is none.
+    WorldSnapshot::NodeBuilding GetEnemyBuilding(const MapPoint& pt) const;
+
+    // Reading the game state (from the game world or the snapshot).
+    unsigned char GetOwner(const MapPoint& pt) const;
+    BlockingManner GetNodeBM(const MapPoint& pt) const;
+    unsigned char GetAltitude(const MapPoint& pt) const;
+    bool IsHarborPoint(const MapPoint& pt) const;
+    bool IsPlayerAttackable(unsigned char player) const;
+    /// Military buildings in 'radius' military squares around 'pt' (see GameWorldBase::LookForMilitaryBuildings()).
+    std::vector<WorldSnapshot::MilitaryBuilding> GetMilitaryBuildings(const MapPoint& pt, unsigned short radius) const;
+    /// Military buildings of all players.
+    std::vector<WorldSnapshot::MilitaryBuilding> GetMilitaryBuildings() const;
 
 private:
     Beowulf* beowulf_;
@@ -183,14 +296,8 @@ private:
     /*
      * Additional Beowulf data on every map point.
      */
-    struct Node {
-        Building* building          = nullptr;
-        FlagState flag              = FlagDoesNotExist;
-        unsigned flagPlanCount      = 0;
-        RoadState roads[3]          = { RoadDoesNotExist, RoadDoesNotExist, RoadDoesNotExist };
-        unsigned roadPlanCount[3]   = { 0, 0, 0 };
-    };
-    NodeMapBase<Node> nodes_;
+    NodeMapBase<Building*> nodeBuildings_;
+    NodeStates nodeStates_;
 
     /**
      * Adding a layer of planned buildings to the BQCalculator.
@@ -204,6 +311,9 @@ private:
 
     private:
         BlockingManner GetBM(const MapPoint& pt) const override;
+        BlockingManner GetNodeBM(const MapPoint& pt) const override;
+        unsigned char GetAltitude(const MapPoint& pt) const override;
+        bool IsHarborPoint(const MapPoint& pt) const override;
         const World& world2;
 
         // Theoretical buildings to be considered. (used for CanConnect())
@@ -211,10 +321,80 @@ private:
     };
 
     std::vector<MapPoint> flags_;
+    BuildingPool buildingPool_;
+    // All buildings in the order of creation.
     std::vector<Building*> buildings_;
+    unsigned buildingChanges_ = 0;
+    BuildingIndex buildingIndex_;
+    mutable BQCache bqCache_;
 
+    // Distances to the closest of our buildings (planned or not) and of the known enemy
+    // military buildings covering a point. Used to anticipate the territory (see IsOwner()).
+    MilitaryDistanceMap ownMilitary_;
+    MilitaryDistanceMap enemyMilitary_;
+    // Set on owner changes. Consumed by the next RefreshEnemyMilitary().
+    bool enemyMilitaryDirty_ = true;
+
+    /*
+     * Undo log of the plan.
+     */
+    struct PlanChange
+    {
+        enum Type : uint8_t
+        {
+            PlannedBuilding,
+            PlannedFlag,
+            PlannedRoad
+        };
+        Type type;
+        /// Road index at the node (PlannedRoad).
+        uint8_t road;
+        /// Plan counter before the change (PlannedFlag, PlannedRoad).
+        uint8_t previousCount;
+        MapPoint pt;
+        /// Building and its point before the change (PlannedBuilding).
+        Building* building;
+        MapPoint previousPt;
+    };
+    std::vector<PlanChange> planLog_;
     bool activePlan_ = false;
     MapPoint hqFlag_;
+
+    mutable PathFinder pathFinder_;
+
+    /*
+     * Reusable scratch grid of PredictExpansionResults(). Entries are only valid if their
+     * stamps match the current prediction (or batch) and are invalidated by increasing the
+     * counters instead of clearing the grid. Predictions must not run concurrently.
+     */
+    struct PredictionNode
+    {
+        enum Flags : uint8_t
+        {
+            Owned = 1 << 0,
+            AlreadyTerritory = 1 << 1,
+            AdditionallyOwned = 1 << 2,
+            DestructionChecked = 1 << 3
+        };
+
+        /// 'flags' are only valid if prediction == currentPrediction_.
+        unsigned prediction = 0;
+        /// 'enemyBuilding' is only valid if batch == currentBatch_.
+        unsigned batch = 0;
+        /// Index into predictedBuildings_ or -1.
+        int enemyBuilding = -1;
+        uint8_t flags = 0;
+    };
+    mutable std::vector<PredictionNode> predictionNodes_;
+    /// Points visited by the current prediction.
+    mutable std::vector<MapPoint> predictionPoints_;
+    /// Enemy buildings found in the current batch.
+    mutable std::vector<WorldSnapshot::NodeBuilding> predictedBuildings_;
+    mutable unsigned currentPrediction_ = 0;
+    mutable unsigned currentBatch_ = 0;
+    RoadNetworks roadNetworks_;
+
+    const WorldSnapshot* snapshot_ = nullptr;
 };
 
 } // namespace beowulf
@@ -0,0 +1,167 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ai/beowulf/WorldSnapshot.h"
+
+#include "RttrForeachPt.h"
+#include "ai/AIInterface.h"
+#include "buildings/noBaseBuilding.h"
+#include "buildings/nobBaseMilitary.h"
+#include "buildings/nobBaseWarehouse.h"
+#include "buildings/nobHQ.h"
+#include "gameData/BuildingProperties.h"
+#include "gameData/MilitaryConsts.h"
+#include "pathfinding/PathConditionHuman.h"
+#include "world/GameWorldBase.h"
+#include "helpers/EnumRange.h"
+
+#include <algorithm>
+
+namespace beowulf {
+
+/// Whether the military square 'square' is one of the 'numSquares' (wrapping) squares visited
+/// around 'center' by MilitarySquares::CheckSquaresInRange().
+static bool IsSquareInRange(int square, int center, int offset, int numSquares)
+{
+    offset = std::min(offset, (numSquares + 1) / 2);
+    const int count = std::min(offset * 2 + 1, numSquares);
+    int diff = (square - (center - offset)) % numSquares;
+    if (diff < 0)
+        diff += numSquares;
+    return diff < count;
+}
+
+void WorldSnapshot::Capture(const AIInterface& aii)
+{
+    const GameWorldBase& gwb = aii.gwb;
+    const unsigned char player = aii.GetPlayerId();
+    const PathConditionHuman human(gwb);
+
+    if (nodes_.GetSize() != gwb.GetSize())
+        nodes_.Resize(gwb.GetSize());
+    buildings_.clear();
+    military_.clear();
+    storehouses_.clear();
+
+    std::vector<MapPoint> ownMilitary;
+
+    RTTR_FOREACH_PT(MapPoint, nodes_.GetSize()) {
+        const noBase* obj = gwb.GetNO(pt);
+        Node& node = nodes_[pt];
+        const MapNode& mapNode = gwb.GetNode(pt);
+        node.owner = mapNode.owner;
+        node.bm = obj->GetBM();
+        node.noType = obj->GetType();
+        node.altitude = mapNode.altitude;
+        node.flags = 0;
+        if (mapNode.harborId)
+            node.flags |= Harbor;
+        if (aii.IsVisible(pt))
+            node.flags |= Visible;
+        if (gwb.IsRoadAvailable(false, pt))
+            node.flags |= RoadAvailable;
+        if (gwb.IsWalkable(pt))
+            node.flags |= Walkable;
+        if (human.IsNodeOk(pt))
+            node.flags |= HumanNodeOk;
+        node.humanEdges = 0;
+        for (const auto dir : helpers::EnumRange<Direction>{}) {
+            if (human.IsEdgeOk(pt, dir))
+                node.humanEdges |= 1 << dir.native_value();
+        }
+
+        node.building = -1;
+        if (node.noType != NOP_BUILDING && node.noType != NOP_BUILDINGSITE)
+            continue;
+
+        const noBaseBuilding* bld = static_cast<const noBaseBuilding*>(obj);
+        const BuildingType type = bld->GetBuildingType();
+        node.building = static_cast<int32_t>(buildings_.size());
+        buildings_.push_back({ bld, pt, type });
+
+        // See GameWorldBase::IsMilitaryBuildingOnNode()
+        if (node.owner == player + 1 && (BuildingProperties::IsMilitary(type) || type == BLD_HEADQUARTERS || type == BLD_HARBORBUILDING))
+            ownMilitary.push_back(pt);
+
+        // Buildings registered in the military squares (see GameWorldBase::LookForMilitaryBuildings()).
+        if (node.noType == NOP_BUILDING && (BuildingProperties::IsMilitary(type) || BuildingProperties::IsWareHouse(type))) {
+            const nobBaseMilitary* mil = static_cast<const nobBaseMilitary*>(obj);
+            military_.push_back({ mil, pt, type, mil->GetPlayer(), mil->GetMilitaryRadius(), mil->GetGOT() == GOT_NOB_MILITARY });
+        }
+    }
+
+    // Newest first, like GameWorldBase::LookForMilitaryBuildings().
+    std::sort(military_.begin(), military_.end(), [](const MilitaryBuilding& l, const MilitaryBuilding& r)
+    {
+        return *l.obj < *r.obj;
+    });
+
+    for (const MapPoint& pt : ownMilitary) {
+        nodes_.VisitPointsInRadius(pt, 4, [this](const MapPoint& p)
+        {
+            nodes_[p].flags |= MilitaryNear;
+        }, true);
+    }
+
+    for (const MapPoint& pt : gwb.GetPlayer(player).GetRestrictedArea())
+        nodes_[pt].flags |= Restricted;
+
+    for (const nobBaseWarehouse* warehouse : aii.GetStorehouses())
+        storehouses_.push_back({ warehouse->GetPos(), warehouse->GetInventory() });
+
+    const nobHQ* hq = aii.GetHeadquarter();
+    hq_ = hq ? hq->GetPos() : MapPoint::Invalid();
+
+    for (unsigned i = 0; i < NUM_BUILDING_TYPES; ++i)
+        buildingEnabled_[i] = aii.CanBuildBuildingtype(static_cast<BuildingType>(i));
+    for (unsigned i = 0; i < MAX_PLAYERS; ++i)
+        attackable_[i] = i < gwb.GetNumPlayers() && aii.IsPlayerAttackable(static_cast<unsigned char>(i));
+}
+
+const WorldSnapshot::NodeBuilding* WorldSnapshot::GetBuilding(const MapPoint& pt) const
+{
+    const int32_t idx = nodes_[pt].building;
+    return idx < 0 ? nullptr : &buildings_[idx];
+}
+
+std::vector<WorldSnapshot::MilitaryBuilding> WorldSnapshot::GetMilitaryBuildings(const MapPoint& pt, unsigned short radius) const
+{
+    const MapExtent size = nodes_.GetSize();
+    const int numSquaresX = (size.x + MILITARY_SQUARE_SIZE - 1) / MILITARY_SQUARE_SIZE;
+    const int numSquaresY = (size.y + MILITARY_SQUARE_SIZE - 1) / MILITARY_SQUARE_SIZE;
+    const int centerX = pt.x / MILITARY_SQUARE_SIZE;
+    const int centerY = pt.y / MILITARY_SQUARE_SIZE;
+
+    std::vector<MilitaryBuilding> ret;
+    for (const MilitaryBuilding& bld : military_) {
+        if (IsSquareInRange(bld.pos.x / MILITARY_SQUARE_SIZE, centerX, radius, numSquaresX) &&
+                IsSquareInRange(bld.pos.y / MILITARY_SQUARE_SIZE, centerY, radius, numSquaresY))
+            ret.push_back(bld);
+    }
+    return ret;
+}
+
+const Inventory* WorldSnapshot::GetInventory(const MapPoint& pt) const
+{
+    for (const Storehouse& storehouse : storehouses_) {
+        if (storehouse.pos == pt)
+            return &storehouse.inventory;
+    }
+    return nullptr;
+}
+
+} // namespace beowulf
@@ -0,0 +1,157 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BEOWULF_WORLDSNAPSHOT_H_INCLUDED
+#define BEOWULF_WORLDSNAPSHOT_H_INCLUDED
+
+#include "world/NodeMapBase.h"
+#include "gameTypes/BuildingType.h"
+#include "gameTypes/Direction.h"
+#include "gameTypes/Inventory.h"
+#include "gameTypes/MapCoordinates.h"
+#include "gameData/MaxPlayers.h"
+#include "nodeObjs/noBase.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class AIInterface;
+class noBaseBuilding;
+class nobBaseMilitary;
+
+namespace beowulf {
+
+/**
+ * @brief Read-only copy of the game state Beowulfs planners depend on.
+ *
+ * Captured on the simulation thread, so planning can run on another thread while the
+ * game continues. Contains per node: owner, blocking manner, object type, visibility,
+ * altitude (building sites level the ground), harbor points and whether roads/humans may
+ * pass. Additionally all military buildings, all buildings on nodes (for enemy and catapult
+ * checks) and our storehouses with their inventory.
+ *
+ * Terrain is not copied. It does not change during a game.
+ * Pointers to game objects are only kept as identities and must not be dereferenced.
+ */
+class WorldSnapshot
+{
+public:
+    struct MilitaryBuilding
+    {
+        const nobBaseMilitary* obj;
+        MapPoint pos;
+        BuildingType type;
+        unsigned char player;
+        unsigned radius;
+        /// GOT_NOB_MILITARY (not a warehouse, harbor or HQ).
+        bool isMilitary;
+    };
+
+    struct NodeBuilding
+    {
+        const noBaseBuilding* obj;
+        MapPoint pos;
+        BuildingType type;
+    };
+
+    struct Storehouse
+    {
+        MapPoint pos;
+        Inventory inventory;
+    };
+
+    /// Copy the current state of the game as seen by the player of 'aii'.
+    void Capture(const AIInterface& aii);
+
+    const MapBase& GetMap() const { return nodes_; }
+
+    /// Owner of 'pt' (player + 1 or 0).
+    unsigned char GetOwner(const MapPoint& pt) const { return nodes_[pt].owner; }
+    BlockingManner GetBM(const MapPoint& pt) const { return nodes_[pt].bm; }
+    NodalObjectType GetNOType(const MapPoint& pt) const { return nodes_[pt].noType; }
+    unsigned char GetAltitude(const MapPoint& pt) const { return nodes_[pt].altitude; }
+    bool IsHarborPoint(const MapPoint& pt) const { return Is(pt, Harbor); }
+    /// AIInterface::IsVisible()
+    bool IsVisible(const MapPoint& pt) const { return Is(pt, Visible); }
+    /// GameWorldBase::IsRoadAvailable() for land roads.
+    bool IsRoadAvailable(const MapPoint& pt) const { return Is(pt, RoadAvailable); }
+    bool IsWalkable(const MapPoint& pt) const { return Is(pt, Walkable); }
+    /// GameWorldBase::IsMilitaryBuildingNearNode() for our player.
+    bool IsMilitaryBuildingNear(const MapPoint& pt) const { return Is(pt, MilitaryNear); }
+    bool IsRestricted(const MapPoint& pt) const { return Is(pt, Restricted); }
+
+    /// Building or building site on 'pt' (any player).
+    const NodeBuilding* GetBuilding(const MapPoint& pt) const;
+    /// All military buildings (newest first).
+    const std::vector<MilitaryBuilding>& GetMilitaryBuildings() const { return military_; }
+    /// Military buildings in 'radius' military squares around 'pt' (see GameWorldBase::LookForMilitaryBuildings()).
+    std::vector<MilitaryBuilding> GetMilitaryBuildings(const MapPoint& pt, unsigned short radius) const;
+
+    /// Our storehouses (including HQ and harbors) in the order of the building register.
+    const std::vector<Storehouse>& GetStorehouses() const { return storehouses_; }
+    const Inventory* GetInventory(const MapPoint& pt) const;
+    /// Position of our HQ or MapPoint::Invalid() if it was destroyed.
+    const MapPoint& GetHQ() const { return hq_; }
+
+    bool IsBuildingEnabled(BuildingType type) const { return buildingEnabled_[type]; }
+    bool IsPlayerAttackable(unsigned char player) const { return attackable_[player]; }
+
+    /// PathConditionHuman::IsNodeOk()
+    bool IsHumanNodeOk(const MapPoint& pt) const { return Is(pt, HumanNodeOk); }
+    /// PathConditionHuman::IsEdgeOk()
+    bool IsHumanEdgeOk(const MapPoint& pt, Direction dir) const { return (nodes_[pt].humanEdges & (1 << dir.native_value())) != 0; }
+
+private:
+    enum Flags : uint8_t
+    {
+        Visible       = 1 << 0,
+        RoadAvailable = 1 << 1,
+        Walkable      = 1 << 2,
+        MilitaryNear  = 1 << 3,
+        Restricted    = 1 << 4,
+        /// PathConditionHuman::IsNodeOk()
+        HumanNodeOk   = 1 << 5,
+        Harbor        = 1 << 6,
+    };
+
+    struct Node
+    {
+        unsigned char owner = 0;
+        BlockingManner bm = BlockingManner::None;
+        NodalObjectType noType = NOP_NOTHING;
+        unsigned char altitude = 0;
+        uint8_t flags = 0;
+        /// PathConditionHuman::IsEdgeOk() for every direction.
+        uint8_t humanEdges = 0;
+        /// Index into buildings_ or -1.
+        int32_t building = -1;
+    };
+
+    bool Is(const MapPoint& pt, Flags flag) const { return (nodes_[pt].flags & flag) != 0; }
+
+    NodeMapBase<Node> nodes_;
+    std::vector<NodeBuilding> buildings_;
+    std::vector<MilitaryBuilding> military_;
+    std::vector<Storehouse> storehouses_;
+    MapPoint hq_;
+    std::array<bool, NUM_BUILDING_TYPES> buildingEnabled_;
+    std::array<bool, MAX_PLAYERS> attackable_;
+};
+
+} // namespace beowulf
+
+#endif //! BEOWULF_WORLDSNAPSHOT_H_INCLUDED
@@ -41,7 +41,7 @@ AttackPlanner::AttackPlanner(Beowulf* beowulf)
     beowulf_->GetAII().ChangeMilitary(data);
 }
 
-void AttackPlanner::OnRun()
+unsigned AttackPlanner::OnRun()
 {
     /*
      * - Should we attack all enemies at once, or kill them one by one?
@@ -67,9 +67,11 @@ void AttackPlanner::OnRun()
      */
 
     std::vector<const nobBaseMilitary*> targets = GetPotentialTargets();
+    // Every military building searched for targets, every target for attackers.
+    unsigned work = static_cast<unsigned>(beowulf_->GetAII().GetMilitaryBuildings().size() + targets.size());
 
     if (targets.empty())
-        return;
+        return work;
 
     // Try to find a HQ and attack that first.
     for (const nobBaseMilitary* target : targets) {
@@ -77,7 +79,7 @@ void AttackPlanner::OnRun()
             unsigned attackers = GetAttackersCount(GetAvailableAttackers(target->GetPos()), target->GetPlayer());
             if (attackers > 0) {
                 beowulf_->GetAII().Attack(target->GetPos(), attackers, true);
-                return;
+                return work;
             }
         }
     }
@@ -88,33 +90,35 @@ void AttackPlanner::OnRun()
             unsigned attackers = GetAttackersCount(GetAvailableAttackers(target->GetPos()), target->GetPlayer());
             if (attackers > 0) {
                 beowulf_->GetAII().Attack(target->GetPos(), attackers, true);
-                return;
+                return work;
             }
         }
     }
 
     // Try to find building that would destroy enemy catapults or other things upon capturing.
-    std::vector<MapPoint> additionalTerritory;
-    std::vector<const noBaseBuilding*> destroyed;
-
-    unsigned highestDestruction = 0;
-    MapPoint bestTargetPt = MapPoint::Invalid();
-    unsigned bestTargetAttackers = 0;
-
+    std::vector<World::ExpansionCandidate> candidates;
+    std::vector<unsigned> candidateAttackers;
     for (const nobBaseMilitary* target : targets) {
         // Do not attack with less than the power of two most simple soldiers.
         unsigned attackers = GetAttackersCount(GetAvailableAttackers(target->GetPos()), target->GetPlayer());
         if (attackers < 2)
             continue;
+        candidates.push_back({ target->GetPos(), target->GetBuildingType() });
+        candidateAttackers.push_back(attackers);
+    }
+
+    // Targets along a front share most of their surroundings.
+    std::vector<World::ExpansionResult> results;
+    beowulf_->world.PredictExpansionResults(candidates, results);
 
-        beowulf_->world.PredictExpansionResults(
-                    target->GetPos(),
-                    target->GetBuildingType(),
-                    additionalTerritory,
-                    destroyed);
+    unsigned highestDestruction = 0;
+    MapPoint bestTargetPt = MapPoint::Invalid();
+    unsigned bestTargetAttackers = 0;
 
-        unsigned destruction = BUILDING_SIZE[target->GetBuildingType()];
-        for (const noBaseBuilding* building : destroyed) {
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        work += static_cast<unsigned>(results[i].additionalTerritory.size() + results[i].destroyed.size());
+        unsigned destruction = BUILDING_SIZE[candidates[i].type];
+        for (const noBaseBuilding* building : results[i].destroyed) {
             switch (BUILDING_SIZE[building->GetBuildingType()]) {
             case BQ_HUT:
                 destruction += 2;
@@ -136,13 +140,14 @@ void AttackPlanner::OnRun()
 
         if (destruction > highestDestruction) {
             highestDestruction = destruction;
-            bestTargetPt = target->GetPos();
-            bestTargetAttackers = attackers;
+            bestTargetPt = candidates[i].pt;
+            bestTargetAttackers = candidateAttackers[i];
         }
     }
 
     if (bestTargetPt.isValid())
         beowulf_->GetAII().Attack(bestTargetPt, bestTargetAttackers, true);
+    return work;
 }
 
 std::vector<const nobBaseMilitary*> AttackPlanner::GetPotentialTargets() const
@@ -180,18 +185,16 @@ std::array<unsigned, 5> AttackPlanner::GetAvailableAttackers(const MapPoint& pt)
     std::array<unsigned, 5> ret;
     ret.fill(0);
 
-    for(const nobBaseMilitary* otherMilBld : beowulf_->gwb.LookForMilitaryBuildings(pt, 2)) {
-        if (otherMilBld->GetPlayer() != beowulf_->GetPlayerId())
-            continue;
-
+    const unsigned playerMask = 1u << beowulf_->GetPlayerId();
+    beowulf_->gwb.VisitMilitaryBuildings(pt, 2, playerMask, [&ret, pt](const nobBaseMilitary* otherMilBld) {
         const nobMilitary* myMil = dynamic_cast<const nobMilitary*>(otherMilBld);
         if (!myMil || myMil->IsUnderAttack())
-            continue;
+            return;
 
         for (const nofPassiveSoldier* soldier : myMil->GetSoldiersForAttack(pt)) {
             ret[soldier->GetRank()]++;
         }
-    }
+    });
 
     return ret;
 }
@@ -30,7 +30,7 @@ class AttackPlanner : public RecurrentBase
 public:
     AttackPlanner(Beowulf* beowulf);
 
-    void OnRun() override;
+    unsigned OnRun() override;
 
 private:
     // Filters targets that are already under attack
@@ -17,20 +17,25 @@
 
 #include "ai/beowulf/recurrent/BuildingPlanner.h"
 #include "ai/beowulf/Beowulf.h"
+#include "ai/beowulf/Budget.h"
 #include "ai/beowulf/Debug.h"
 
 #include "ai/AIInterface.h"
 #include "gameData/BuildingProperties.h"
 #include "notifications/BuildingNote.h"
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
 #include "gameData/BuildingConsts.h"
 
 namespace beowulf {
 
 BuildingPlanner::BuildingPlanner(Beowulf* beowulf)
     : RecurrentBase(beowulf, 1, 0),
-      costs_(beowulf->GetAII(), beowulf->world)
+      costs_(beowulf->GetAII(), beowulf->world),
+      scoringPool_(new ThreadPool(1)),
+      requests_(beowulf->world)
 {
     // Change build order so that sawmills have highest priority.
 //    BuildOrders order = beowulf_->player.GetStandardBuildOrder();
@@ -46,43 +51,58 @@ BuildingPlanner::~BuildingPlanner()
 {
 }
 
-void BuildingPlanner::OnRun()
+unsigned BuildingPlanner::OnRun()
+{
+    Budget budget;
+    while (!OnStep(budget)) {}
+    return budget.GetSpent();
+}
+
+bool BuildingPlanner::OnStep(Budget& budget)
 {
     if (current_.requests.empty()) {
         for (const auto& reqs : requests_) {
-            const std::vector<Building*>& vec = reqs.second;
+            const std::vector<BuildingHandle>& vec = reqs.second;
             if (!vec.empty()) {
                 current_.dest = reqs.first;
                 current_.requests = vec;
+                current_.next = 0;
                 current_.searches = 0;
-                requests_.erase(reqs.first);
+                requests_.erase(current_.dest);
                 break;
             }
         }
     }
 
     if (!current_.requests.empty()) {
-        if (current_.searches < 1) {
+        if (current_.searches < 1)
             Search();
-            Execute();
-        }
+        // The buildings may have been removed in the meantime.
+        if (current_.requests.empty())
+            return true;
+        return Execute(budget);
     }
+
+    return true;
 }
 
 void BuildingPlanner::Request(Building* building, const MapPoint& regionPt)
 {
     // Heuristic cannot evaluate military building positions.
     RTTR_Assert(!BuildingProperties::IsMilitary(building->GetType()) || building->GetPt().isValid());
-    requests_[regionPt].push_back(building);
+    requests_[regionPt].push_back(beowulf_->world.GetHandle(building));
 
     //std::cout << "Request(" << BUILDING_NAMES[building->GetType()] << ")" << std::endl;
 }
 
 unsigned BuildingPlanner::GetRequestCount() const
 {
-    unsigned ret = static_cast<unsigned>(current_.requests.size());
+    const World& world = beowulf_->world;
+    auto isAlive = [&world](const BuildingHandle& handle) { return world.GetBuilding(handle) != nullptr; };
+
+    unsigned ret = static_cast<unsigned>(std::count_if(current_.requests.begin() + current_.next, current_.requests.end(), isAlive));
     for (const auto& req : requests_)
-        ret += req.second.size();
+        ret += static_cast<unsigned>(std::count_if(req.second.begin(), req.second.end(), isAlive));
     return ret;
 }
 
@@ -90,30 +110,40 @@ unsigned BuildingPlanner::GetRequestCount(
         const std::vector<BuildingType>&& types,
         const MapPoint& regionPt) const
 {
+    const World& world = beowulf_->world;
     unsigned ret = 0;
 
     for (const auto& req : requests_) {
-        const std::vector<Building*>& buildings = req.second;
+        const std::vector<BuildingHandle>& buildings = req.second;
         ret += std::count_if(buildings.begin(), buildings.end(),
-                             [&](const Building* bld)
+                             [&](const BuildingHandle& handle)
         {
-            return std::find(types.begin(), types.end(), bld->GetType()) != types.end()
-                    && beowulf_->world.CanConnectBuilding(regionPt, req.first, false);
+            const Building* bld = world.GetBuilding(handle);
+            return bld && std::find(types.begin(), types.end(), bld->GetType()) != types.end()
+                    && world.CanConnectBuilding(regionPt, req.first, false);
         });
     }
 
-    if (!beowulf_->world.CanConnectBuilding(regionPt, current_.dest, true))
+    if (!world.CanConnectBuilding(regionPt, current_.dest, true))
         return ret;
 
-    ret += std::count_if(current_.requests.begin(), current_.requests.end(),
-                         [types](const Building* bld)
+    ret += std::count_if(current_.requests.begin() + current_.next, current_.requests.end(),
+                         [&](const BuildingHandle& handle)
     {
-        return std::find(types.begin(), types.end(), bld->GetType()) != types.end() ;
+        const Building* bld = world.GetBuilding(handle);
+        return bld && std::find(types.begin(), types.end(), bld->GetType()) != types.end() ;
     });
 
     return ret;
 }
 
+void BuildingPlanner::SetScoringThreads(unsigned numThreads)
+{
+    if (numThreads == 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    scoringPool_.reset(new ThreadPool(numThreads));
+}
+
 void BuildingPlanner::Search()
 {
     /*
@@ -164,14 +194,22 @@ void BuildingPlanner::Search()
         15, // BLD_DONKEYBREEDER
         1,  // BLD_HARBORBUILDING
     };
+    // Drop requests for buildings removed in the meantime.
+    const World& world = beowulf_->world;
+    current_.requests.erase(std::remove_if(current_.requests.begin(), current_.requests.end(),
+                                           [&](const BuildingHandle& handle) { return !world.GetBuilding(handle); }),
+                            current_.requests.end());
+
     std::stable_sort(current_.requests.begin(), current_.requests.end(),
-              [&](const Building* l, const Building* r)
+              [&](const BuildingHandle& lh, const BuildingHandle& rh)
     {
-        return c_buildingOrder[l->GetType()] < c_buildingOrder[r->GetType()];
+        return c_buildingOrder[world.GetBuilding(lh)->GetType()] < c_buildingOrder[world.GetBuilding(rh)->GetType()];
     });
     std::stable_sort(current_.requests.begin(), current_.requests.end(),
-              [&](const Building* l, const Building* r)
+              [&](const BuildingHandle& lh, const BuildingHandle& rh)
     {
+        const Building* l = world.GetBuilding(lh);
+        const Building* r = world.GetBuilding(rh);
         if (l->GetPt().isValid() && !r->GetPt().isValid())
             return true;
         if (!l->GetPt().isValid() && r->GetPt().isValid())
@@ -188,14 +226,26 @@ void BuildingPlanner::Search()
     current_.searches++;
 }
 
-void BuildingPlanner::Execute()
+bool BuildingPlanner::Execute(Budget& budget)
 {
+    // Locations are calculated again when resuming, the world may have changed since.
     BuildLocations locations(beowulf_->world, false);
     locations.Calculate(current_.dest);
-    for (Building* building : current_.requests) {
-        Place(building, locations);
-    }
+    budget.Spend(locations.GetSize());
+
+    // Place at least one building per step.
+    do {
+        Building* building = beowulf_->world.GetBuilding(current_.requests[current_.next++]);
+        if (building)
+            Place(building, locations, budget);
+    } while (current_.next < current_.requests.size() && !budget.IsExhausted());
+
+    if (current_.next < current_.requests.size())
+        return false;
+
     current_.requests.clear();
+    current_.next = 0;
+    return true;
 }
 
 double HyperVolume(const std::vector<double>& vec);
@@ -207,9 +257,23 @@ double HyperVolume(const std::vector<double>& vec)
     return ret;
 }
 
+bool BuildingPlanner::IsBetterPosition(
+        double score,
+        const MapPoint& pt,
+        double otherScore,
+        const MapPoint& otherPt) const
+{
+    if (!otherPt.isValid())
+        return true;
+    if (score != otherScore)
+        return score > otherScore;
+    return beowulf_->world.GetIdx(pt) < beowulf_->world.GetIdx(otherPt);
+}
+
 bool BuildingPlanner::Place(
         Building* building,
-        BuildLocations& locations)
+        BuildLocations& locations,
+        Budget& budget)
 {
     // Is this building type already known to not be placeable at the moment?
     if (blacklist_[building->GetType()])
@@ -225,7 +289,7 @@ bool BuildingPlanner::Place(
         }
         pt = building->GetPt();
     } else {
-        if (!FindBestPosition(building, pt, HyperVolume, locations)) {
+        if (!FindBestPosition(building, pt, HyperVolume, locations, budget)) {
             std::cout << "No viable position found for a " << BUILDING_NAMES[building->GetType()] << " (no location with positive score)" << std::endl;
             blacklist_[building->GetType()] = true;
             return false;
@@ -22,11 +22,17 @@
 #include "ai/beowulf/Heuristics.h"
 #include "ai/beowulf/BuildLocations.h"
 #include "ai/beowulf/Building.h"
+#include "ai/beowulf/BuildingPool.h"
+#include "ai/beowulf/NodeContainers.h"
 #include "ai/beowulf/Helper.h"
+#include "ai/beowulf/ThreadPool.h"
+#include "ai/beowulf/Budget.h"
 
+#include <algorithm>
 #include <vector>
 #include <limits>
 #include <bitset>
+#include <memory>
 
 class AIInterface;
 
@@ -40,29 +46,47 @@ public:
     BuildingPlanner(Beowulf* beowulf);
     ~BuildingPlanner() override;
 
-    void OnRun() override;
+    unsigned OnRun() override;
 
     void Request(Building* building, const MapPoint& regionPt);
     unsigned GetRequestCount(const std::vector<BuildingType>&& types, const MapPoint& regionPt) const;
     unsigned GetRequestCount() const;
 
+    /// Number of threads scoring build locations (0 = one per hardware thread, 1 = serial).
+    /// The chosen positions do not depend on the number of threads.
+    void SetScoringThreads(unsigned numThreads);
+
 private:
+    /// Place the current requests. Resumable: returns false if requests are left after 'budget' is exhausted.
+    bool OnStep(Budget& budget) override;
+
     void Search();
-    void Execute();
+    bool Execute(Budget& budget);
 
-    bool Place(Building* building, BuildLocations& locations);
+    bool Place(Building* building, BuildLocations& locations, Budget& budget);
 
     template<typename Score>
-    bool FindBestPosition(const Building* building, MapPoint& pt, Score scoreFunc, BuildLocations& locations);
+    bool FindBestPosition(const Building* building, MapPoint& pt, Score scoreFunc, BuildLocations& locations, Budget& budget);
     bool FindBestRoute(const MapPoint& start, const MapPoint& goodsDest, std::vector<Direction>& route);
+    /// Strict ordering of scored positions. Equal scores are ordered by map index.
+    bool IsBetterPosition(double score, const MapPoint& pt, double otherScore, const MapPoint& otherPt) const;
 
     void OnBuildingNote(const BuildingNote& note) override;
     void OnNodeNote(const NodeNote& note) override;
 
     BuildingPositionCosts costs_;
 
+    std::unique_ptr<ThreadPool> scoringPool_;
+    // One score vector and path search per scoring thread.
+    std::vector<std::vector<double>> scoreVecs_;
+    std::vector<HumanPathSearch> pathSearches_;
+
+    // Requested buildings may be removed before they are placed (see BuildingHandle).
     struct {
-        std::vector<Building*> requests;
+        std::vector<BuildingHandle> requests;
+
+        // Index of the next request to place.
+        size_t next = 0;
 
         // One flag as startposition for build location search.
         MapPoint dest;
@@ -74,7 +98,7 @@ private:
     std::bitset<NUM_BUILDING_TYPES> blacklist_;
 
     // First field is idx of dest, second is array of buildings to place.
-    std::map<MapPoint, std::vector<Building*>, MapPointComp> requests_;
+    PointHashMap<std::vector<BuildingHandle>> requests_;
 };
 
 template<typename Score>
@@ -82,25 +106,59 @@ bool BuildingPlanner::FindBestPosition(
         const Building* building,
         MapPoint& pt,
         Score scoreFunc,
-        BuildLocations& locations)
+        BuildLocations& locations,
+        Budget& budget)
 {
-    std::vector<double> score_vec;
-    double bestScore = -std::numeric_limits<double>::max();
-
-    for (const MapPoint& location : locations.Get(building->GetQuality())) {
-        score_vec.clear();
-
-        if (!costs_.Score(score_vec, building, location))
-            continue;
-
-        double score = scoreFunc(score_vec);
-        if (score > bestScore) {
-            bestScore = score;
-            pt = location;
+    // Number of locations scored by one task.
+    static const unsigned c_chunkSize = 32;
+
+    struct Candidate {
+        double score = -std::numeric_limits<double>::max();
+        MapPoint pt = MapPoint::Invalid();
+    };
+
+    const std::vector<MapPoint> candidates = locations.Get(building->GetQuality());
+    budget.Spend(static_cast<unsigned>(candidates.size()));
+    const unsigned numChunks = static_cast<unsigned>((candidates.size() + c_chunkSize - 1) / c_chunkSize);
+
+    // Every chunk finds its best location. The results are reduced in chunk order below,
+    // so the result is the same for any number of threads.
+    std::vector<Candidate> chunkBest(numChunks);
+    scoreVecs_.resize(scoringPool_->GetNumThreads());
+    pathSearches_.resize(scoringPool_->GetNumThreads());
+
+    scoringPool_->Run(numChunks, [&](unsigned chunk, unsigned thread)
+    {
+        std::vector<double>& score_vec = scoreVecs_[thread];
+        Candidate& best = chunkBest[chunk];
+        const size_t end = std::min(candidates.size(), static_cast<size_t>(chunk + 1) * c_chunkSize);
+
+        for (size_t i = static_cast<size_t>(chunk) * c_chunkSize; i < end; ++i) {
+            const MapPoint& location = candidates[i];
+            score_vec.clear();
+
+            if (!costs_.Score(score_vec, building, location, pathSearches_[thread]))
+                continue;
+
+            double score = scoreFunc(score_vec);
+            if (IsBetterPosition(score, location, best.score, best.pt)) {
+                best.score = score;
+                best.pt = location;
+            }
         }
+    });
+
+    Candidate best;
+    for (const Candidate& candidate : chunkBest) {
+        if (candidate.pt.isValid() && IsBetterPosition(candidate.score, candidate.pt, best.score, best.pt))
+            best = candidate;
     }
 
-    return bestScore != -std::numeric_limits<double>::max();
+    if (!best.pt.isValid())
+        return false;
+
+    pt = best.pt;
+    return true;
 }
 
 } // namespace beowulf
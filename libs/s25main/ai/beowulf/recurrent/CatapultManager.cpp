@@ -26,9 +26,9 @@ CatapultManager::CatapultManager(Beowulf* beowulf)
 
 }
 
-void CatapultManager::OnRun()
+unsigned CatapultManager::OnRun()
 {
-
+    return 0;
 }
 
 } // namespace beowulf
@@ -26,7 +26,7 @@ class CatapultManager : public RecurrentBase
 public:
     CatapultManager(Beowulf* beowulf);
 
-    void OnRun() override;
+    unsigned OnRun() override;
 };
 
 } // namespace beowulf
@@ -31,26 +31,25 @@ CoinManager::CoinManager(Beowulf* beowulf)
 
 }
 
-void CoinManager::OnRun()
+unsigned CoinManager::OnRun()
 {
     // Do nothing until we have coins.
     if (beowulf_->produce.GetTotalProduction(BGD_COIN) == 0)
-        return;
+        return 1;
 
     // Place a fortress in the HQ region for spending coins.
-    if (!academy_) {
-        RequestAcademy();
-        return;
+    const Building* academy = beowulf_->world.GetBuilding(academy_);
+    if (!academy) {
+        return RequestAcademy();
     } else if (0 == beowulf_->build.GetRequestCount({ BLD_FORTRESS }, beowulf_->world.GetHQFlag())) {
         // If building failed we have to try again.
-        RequestAcademy();
-        return;
+        return RequestAcademy();
     }
 
-    if (academy_->GetState() != Building::Finished)
-        return;
+    if (academy->GetState() != Building::Finished)
+        return 1;
 
-    const nobMilitary* acad = beowulf_->GetAII().gwb.GetSpecObj<nobMilitary>(academy_->GetPt());
+    const nobMilitary* acad = beowulf_->GetAII().gwb.GetSpecObj<nobMilitary>(academy->GetPt());
     RTTR_Assert(acad);
 
     // Enable/Disable coins for academy based on the number of soldiers that can be trained.
@@ -62,17 +61,18 @@ void CoinManager::OnRun()
 
     if (soldiers < 3) {
         if (!acad->IsGoldDisabled())
-            beowulf_->GetAII().SetCoinsAllowed(academy_->GetPt(), false);
+            beowulf_->GetAII().SetCoinsAllowed(academy->GetPt(), false);
     } else {
         if (acad->IsGoldDisabled())
-            beowulf_->GetAII().SetCoinsAllowed(academy_->GetPt(), true);
+            beowulf_->GetAII().SetCoinsAllowed(academy->GetPt(), true);
     }
 
     // Send generals away.
     if (acad->HasMaxRankSoldier())
-        beowulf_->GetAII().SendSoldiersHome(academy_->GetPt());
+        beowulf_->GetAII().SendSoldiersHome(academy->GetPt());
     if (acad->GetTroops().size() < acad->GetMaxTroopsCt())
-        beowulf_->GetAII().OrderNewSoldiers(academy_->GetPt());
+        beowulf_->GetAII().OrderNewSoldiers(academy->GetPt());
+    return 1;
 }
 
 void CoinManager::OnBuildingNote(const BuildingNote& note)
@@ -80,7 +80,7 @@ void CoinManager::OnBuildingNote(const BuildingNote& note)
     switch (note.type) {
     case BuildingNote::SetBuildingSiteFailed:
     {
-        academy_ = nullptr;
+        academy_ = BuildingHandle();
     } break;
 
     // The construction of a building finished.
@@ -96,8 +96,9 @@ void CoinManager::OnBuildingNote(const BuildingNote& note)
     // A building was destroyed.
     case BuildingNote::Destroyed:
     {
-        if (academy_ && note.pos == academy_->GetPt()) {
-            academy_ = nullptr;
+        const Building* academy = beowulf_->world.GetBuilding(academy_);
+        if (academy && note.pos == academy->GetPt()) {
+            academy_ = BuildingHandle();
         }
     } break;
 
@@ -107,7 +108,7 @@ void CoinManager::OnBuildingNote(const BuildingNote& note)
     }
 }
 
-void CoinManager::RequestAcademy()
+unsigned CoinManager::RequestAcademy()
 {
     MapPoint regionPt = beowulf_->world.GetHQFlag();
 
@@ -125,17 +126,20 @@ void CoinManager::RequestAcademy()
     }
 
     if (bestLocation.isValid()) {
-        if (!academy_) {
-            academy_ = beowulf_->world.Create(
+        Building* academy = beowulf_->world.GetBuilding(academy_);
+        if (!academy) {
+            academy = beowulf_->world.Create(
                         BLD_FORTRESS,
                         Building::ConstructionRequested,
                         InvalidProductionGroup,
                         bestLocation);
+            academy_ = beowulf_->world.GetHandle(academy);
         } else {
-            beowulf_->world.SetPoint(academy_, bestLocation);
+            beowulf_->world.SetPoint(academy, bestLocation);
         }
-        beowulf_->build.Request(academy_, regionPt);
+        beowulf_->build.Request(academy, regionPt);
     }
+    return locations.GetSize();
 }
 
 } // namespace beowulf
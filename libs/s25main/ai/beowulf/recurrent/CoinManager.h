@@ -18,24 +18,25 @@
 #define BEOWULF_RECURRENT_COINMANAGER_H_INCLUDED
 
 #include "ai/beowulf/recurrent/RecurrentBase.h"
+#include "ai/beowulf/BuildingPool.h"
 
 namespace beowulf {
 
-class Building;
-
 class CoinManager : public RecurrentBase
 {
 public:
     CoinManager(Beowulf* beowulf);
 
-    void OnRun() override;
+    unsigned OnRun() override;
 
     void OnBuildingNote(const BuildingNote& note) override;
 
 private:
-    Building* academy_ = nullptr;
+    // Invalid once the academy is removed.
+    BuildingHandle academy_;
 
-    void RequestAcademy();
+    /// Returns the work done.
+    unsigned RequestAcademy();
 };
 
 } // namespace beowulf
@@ -23,7 +23,6 @@
 
 #include "ai/AIInterface.h"
 #include "buildings/noBuildingSite.h"
-#include "buildings/nobBaseWarehouse.h"
 #include "buildings/nobMilitary.h"
 #include "gameData/BuildingProperties.h"
 #include "gameData/MilitaryConsts.h"
@@ -60,7 +59,7 @@ ExpansionPlanner::ExpansionPlanner(Beowulf* beowulf)
 
 }
 
-void ExpansionPlanner::OnRun()
+unsigned ExpansionPlanner::OnRun()
 {
     // @todo: Try the following loop that deconstructs unused military buildings.
 //    for (const nobMilitary* building : beowulf_->GetAII().GetMilitaryBuildings()) {
@@ -70,14 +69,15 @@ void ExpansionPlanner::OnRun()
 //    }
 
     // Check whether we actually want to expand.
+    unsigned work = static_cast<unsigned>(beowulf_->world.GetBuildings().size());
     if (!ShouldExpand())
-        return;
+        return work;
 
     // Get list of expandable territories.
     std::vector<MapPoint> starts;
-    for (nobBaseWarehouse* warehouse : beowulf_->GetAII().GetStorehouses()) {
+    for (const MapPoint& warehouse : beowulf_->world.GetStorehouses()) {
         // Check for enough soldiers, builders and materials.
-        const Inventory& inventory = warehouse->GetInventory();
+        const Inventory& inventory = *beowulf_->world.GetInventory(warehouse);
         unsigned soldiers = inventory[JOB_PRIVATE] + inventory[JOB_PRIVATEFIRSTCLASS] + inventory[JOB_SERGEANT] + inventory[JOB_OFFICER] + inventory[JOB_GENERAL];
         if (soldiers < minSoldiers_)
             continue;
@@ -87,11 +87,14 @@ void ExpansionPlanner::OnRun()
         if (inventory[GD_BOARDS] < cost.boards || inventory[GD_STONES] < cost.stones)
             continue;
 
+        work += static_cast<unsigned>(starts.size());
+
         // Check that this warehouse is not connected to another warehouse.
         // (We only want to add one military building for every region).
         bool skip = false;
+        const MapPoint flag = beowulf_->world.GetNeighbour(warehouse, Direction::SOUTHEAST);
         for (const MapPoint& start : starts) {
-            if (!beowulf_->world.GetPath(warehouse->GetFlagPos(), start).empty()) {
+            if (beowulf_->world.IsConnected(flag, start)) {
                 skip = true;
                 break;
             }
@@ -101,14 +104,15 @@ void ExpansionPlanner::OnRun()
 
         // @todo: Keep track of which region is currently building a new military building.
 
-        starts.push_back(warehouse->GetFlagPos());
+        starts.push_back(flag);
     }
 
     for (const MapPoint& start : starts)
-        Expand(start);
+        work += Expand(start);
+    return work;
 }
 
-void ExpansionPlanner::Expand(const MapPoint& pt)
+unsigned ExpansionPlanner::Expand(const MapPoint& pt)
 {
     /*
      * # For every possible military location:
@@ -134,16 +138,16 @@ void ExpansionPlanner::Expand(const MapPoint& pt)
     // Get all possible military locations and search for the best rated position.
     BuildLocations locations(beowulf_->world, false);
     locations.Calculate(pt);
-
-    unsigned bestRating = 0;
-    MapPoint bestPoint = MapPoint::Invalid();
-    BuildingType bestType = BLD_NOTHING2;
-
-    std::vector<MapPoint> additionalTerritory;
-    std::vector<const noBaseBuilding*> destroyed;
+    unsigned work = locations.GetSize();
 
     World& world = beowulf_->world;
 
+    // The threat around 'pt' is the same for all locations.
+    const unsigned enemies = world.GetEnemySoldiersInReach(pt);
+    const bool enemyNear = enemies <= 1 && world.IsEnemyNear(pt, MAX_MILITARY_DISTANCE_NEAR);
+    const std::vector<const noBaseBuilding*> catapults = world.GetEnemyCatapultsInReach(pt);
+
+    std::vector<World::ExpansionCandidate> candidates;
     for (const MapPoint& loc : locations.Get(BQ_HUT)) {
         BuildingType type = BLD_GUARDHOUSE;
 
@@ -153,20 +157,32 @@ void ExpansionPlanner::Expand(const MapPoint& pt)
             continue;
 
         // check if the enemy is close:
-        unsigned enemies = world.GetEnemySoldiersInReach(pt);
         if (enemies > 1) {
             TryImprove(type, locations.Get(loc));
             if (enemies > 5) {
                 TryImprove(type, locations.Get(loc));
             }
         } else {
-            if (world.IsEnemyNear(pt, MAX_MILITARY_DISTANCE_NEAR))
+            if (enemyNear)
                 TryImprove(type, locations.Get(loc));
         }
 
-        world.PredictExpansionResults(loc, type, additionalTerritory, destroyed);
+        candidates.push_back({ loc, type });
+    }
+
+    // Predict all candidates at once. They share most of their surroundings.
+    std::vector<World::ExpansionResult> results;
+    world.PredictExpansionResults(candidates, results);
+
+    unsigned bestRating = 0;
+    MapPoint bestPoint = MapPoint::Invalid();
+    BuildingType bestType = BLD_NOTHING2;
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const std::vector<MapPoint>& additionalTerritory = results[i].additionalTerritory;
+        const std::vector<const noBaseBuilding*>& destroyed = results[i].destroyed;
+        work += static_cast<unsigned>(additionalTerritory.size());
 
-        std::vector<const noBaseBuilding*> catapults = world.GetEnemyCatapultsInReach(pt);
         bool catapultsRemaining = false;
         for (const noBaseBuilding* catapult : catapults) {
             if (!helpers::contains(destroyed, catapult)) {
@@ -194,8 +210,8 @@ void ExpansionPlanner::Expand(const MapPoint& pt)
         unsigned rating = (ores * 2u) + stones + plantspace + (static_cast<unsigned>(destroyed.size()) * 2u);
         if (rating > bestRating) {
             bestRating = rating;
-            bestPoint = loc;
-            bestType = type;
+            bestPoint = candidates[i].pt;
+            bestType = candidates[i].type;
         }
     }
 
@@ -203,6 +219,7 @@ void ExpansionPlanner::Expand(const MapPoint& pt)
         Building* building = world.Create(bestType, Building::PlanningRequest, InvalidProductionGroup, bestPoint);
         beowulf_->build.Request(building, pt);
     }
+    return work;
 }
 
 bool ExpansionPlanner::ShouldExpand() const
@@ -242,15 +259,15 @@ bool ExpansionPlanner::ShouldExpand() const
 
 bool ExpansionPlanner::TryImprove(BuildingType& type, BuildingQuality bq) const
 {
-    if (type == BLD_BARRACKS && beowulf_->GetAII().CanBuildBuildingtype(BLD_GUARDHOUSE)) {
+    if (type == BLD_BARRACKS && beowulf_->world.IsBuildingEnabled(BLD_GUARDHOUSE)) {
         type = BLD_GUARDHOUSE;
         return true;
     }
-    if (type == BLD_GUARDHOUSE && beowulf_->GetAII().CanBuildBuildingtype(BLD_WATCHTOWER) && bq >= BQ_HOUSE) {
+    if (type == BLD_GUARDHOUSE && beowulf_->world.IsBuildingEnabled(BLD_WATCHTOWER) && bq >= BQ_HOUSE) {
         type = BLD_WATCHTOWER;
         return true;
     }
-    if (type == BLD_WATCHTOWER && beowulf_->GetAII().CanBuildBuildingtype(BLD_FORTRESS) && bq >= BQ_CASTLE) {
+    if (type == BLD_WATCHTOWER && beowulf_->world.IsBuildingEnabled(BLD_FORTRESS) && bq >= BQ_CASTLE) {
         type = BLD_FORTRESS;
         return true;
     }
@@ -36,10 +36,11 @@ class ExpansionPlanner : public RecurrentBase
 public:
     ExpansionPlanner(Beowulf* beowulf);
 
-    void OnRun() override;
+    unsigned OnRun() override;
 
 private:
-    void Expand(const MapPoint& pt);
+    /// Returns the work done.
+    unsigned Expand(const MapPoint& pt);
     bool ShouldExpand() const;
     bool TryImprove(BuildingType& type, BuildingQuality bq) const;
 
@@ -26,9 +26,9 @@ GeologistManager::GeologistManager(Beowulf* beowulf)
 
 }
 
-void GeologistManager::OnRun()
+unsigned GeologistManager::OnRun()
 {
-
+    return 0;
 }
 
 } // namespace beowulf
@@ -26,7 +26,7 @@ class GeologistManager : public RecurrentBase
 public:
     GeologistManager(Beowulf* beowulf);
 
-    void OnRun() override;
+    unsigned OnRun() override;
 };
 
 } // namespace beowulf
@@ -32,14 +32,15 @@ MetalworksManager::MetalworksManager(Beowulf* beowulf)
     CheckMetalworksExists();
 }
 
-void MetalworksManager::OnRun()
+unsigned MetalworksManager::OnRun()
 {
     if (CheckMetalworksExists()) {
         if (isWorking_)
-            return;
+            return 1;
 
         PlaceNextOrder();
     }
+    return 1;
 }
 
 bool MetalworksManager::JobOrToolOrQueueSpace(Job job, bool addMetalworksRequest, unsigned maxQueueLength)
@@ -39,7 +39,7 @@ class MetalworksManager : public RecurrentBase
 public:
     MetalworksManager(Beowulf* beowulf);
 
-    void OnRun() override;
+    unsigned OnRun() override;
 
     void Request(GoodType type) { requests_.push(type); }
     unsigned GetRequestQueueLength() const { return requests_.size(); }
@@ -17,6 +17,7 @@
 
 #include "ai/beowulf/recurrent/ProductionPlanner.h"
 #include "ai/beowulf/Beowulf.h"
+#include "ai/beowulf/Budget.h"
 #include "ai/beowulf/Heuristics.h"
 
 #include "gameData/BuildingConsts.h"
@@ -24,6 +25,10 @@
 #include "gameData/JobConsts.h"
 #include "buildings/noBuildingSite.h"
 #include "helpers/containerUtils.h"
+#include "helpers/EnumRange.h"
+#include "notifications/BuildingNote.h"
+#include "notifications/RoadNote.h"
+#include "notifications/NodeNote.h"
 
 #include <boost/foreach.hpp>
 
@@ -40,20 +45,21 @@ namespace beowulf {
  *
  * Only the HQ will try to build soldiers.
  * Every other network will try to provide resources to the HQ (ores, stone, wood, food).
+ *
+ * Regions are kept up to date incrementally. Buildings are only reassigned after building or
+ * road notes and the resources of a region are only summed up again after changes close to
+ * its build locations (or after S_resources_refresh_runs runs, to catch changed resources).
  */
 
+static const unsigned S_resources_refresh_runs = 10;
+
 ProductionPlanner::Region::Region()
 {
     resources.fill(0);
 }
 
-ProductionPlanner::Region::Region(
-        const Building* building,
-        const MapPoint& flag,
-        bool main)
-    : isMain(main),
-      regionFlag(flag),
-      buildings{ building }
+ProductionPlanner::Region::Region(const MapPoint& flag)
+    : regionFlag(flag)
 {
     resources.fill(0);
 }
@@ -94,17 +100,40 @@ unsigned ProductionPlanner::Region::CountBuildings(
 ProductionPlanner::ProductionPlanner(Beowulf* beowulf)
     : RecurrentBase(beowulf, 15, 0) // Plan only every 15*16 gf.
 {
+    locationRegion_.resize(beowulf->world.GetSize().x * beowulf->world.GetSize().y, MapPoint::Invalid());
 }
 
-void ProductionPlanner::OnRun()
+unsigned ProductionPlanner::OnRun()
 {
-    CalculateRegions();
+    Budget budget;
+    while (!OnStep(budget)) {}
+    return budget.GetSpent();
+}
 
-    for (auto& it : regions_) {
-        const MapPoint regionPt = it.first;
-        Region& region = it.second;
+bool ProductionPlanner::OnStep(Budget& budget)
+{
+    budget.Spend(UpdateRegions());
+
+    // Continue with the first region not yet planned in this run.
+    auto it = nextRegion_.isValid() ? regions_.lower_bound(nextRegion_) : regions_.begin();
+    while (it != regions_.end()) {
+        const MapPoint regionPt = it->first;
+        Region& region = it->second;
         Plan(regionPt, region);
+        budget.Spend(1 + static_cast<unsigned>(region.buildings.size()));
+        ++it;
+
+        if (budget.IsExhausted())
+            break;
+    }
+
+    if (it == regions_.end()) {
+        nextRegion_ = MapPoint::Invalid();
+        return true;
     }
+
+    nextRegion_ = it->first;
+    return false;
 }
 
 unsigned ProductionPlanner::GetTotalProduction(BGoodType type) const
@@ -400,101 +429,221 @@ int ProductionPlanner::GetOvercapacity(const ProductionPlanner::Region &region,
     }
 }
 
-void ProductionPlanner::CalculateRegions()
+void ProductionPlanner::OnBuildingNote(const BuildingNote& note)
+{
+    membersDirty_ = true;
+    SetResourcesDirty(note.pos);
+}
+
+void ProductionPlanner::OnRoadNote(const RoadNote& note)
+{
+    membersDirty_ = true;
+    MapPoint cur = note.pos;
+    SetResourcesDirty(cur);
+    for (Direction dir : note.route) {
+        cur = beowulf_->world.GetNeighbour(cur, dir);
+        SetResourcesDirty(cur);
+    }
+}
+
+void ProductionPlanner::OnNodeNote(const NodeNote& note)
 {
-    regions_.clear();
+    // Only the build locations change. Members follow building and road notes.
+    SetResourcesDirty(note.pos);
+}
+
+void ProductionPlanner::SetResourcesDirty(const MapPoint& pt)
+{
+    const World& world = beowulf_->world;
+    auto it = regions_.find(locationRegion_[world.GetIdx(pt)]);
+    if (it != regions_.end()) {
+        it->second.resourcesDirty = true;
+        return;
+    }
+
+    // New locations extend the regions of the known locations next to them.
+    for (const Direction dir : helpers::EnumRange<Direction>{}) {
+        auto neighbour = regions_.find(locationRegion_[world.GetIdx(world.GetNeighbour(pt, dir))]);
+        if (neighbour != regions_.end())
+            neighbour->second.resourcesDirty = true;
+    }
+}
 
+unsigned ProductionPlanner::UpdateRegions()
+{
     const World& world = beowulf_->world;
-    std::set<const Building*> considered;
+    unsigned work = 0;
 
+    // The HQ and every harbor not connected to a previous one start a region.
+    std::vector<std::pair<MapPoint, unsigned>> roots;
     Building* hq = world.GetHQ();
-    if (hq) {
-        considered.insert(hq);
-        regions_[hq->GetFlag()] = Region(hq, hq->GetFlag(), true);
-        CalculateRegion(hq->GetFlag(), considered);
+    if (hq)
+        roots.emplace_back(hq->GetFlag(), world.GetRoadNetwork(hq->GetFlag()));
+    for (const Building* bld : world.GetBuildings(BLD_HARBORBUILDING)) {
+        if (!bld->GetPt().isValid() || world.GetBuilding(bld->GetPt()) != bld)
+            continue;
+        const MapPoint flag = bld->GetFlag();
+        const unsigned network = world.GetRoadNetwork(flag);
+        bool connected = false;
+        for (const auto& root : roots)
+            connected |= root.first == flag || (network != RoadNetworks::InvalidNetwork && root.second == network);
+        if (!connected)
+            roots.emplace_back(flag, network);
     }
 
-    for (const Building* bld : world.GetBuildings()) {
-        if (bld->GetType() == BLD_HARBORBUILDING) {
-            if (considered.find(bld) != considered.end())
-                continue;
-            if (considered.insert(bld).second) {
-                regions_[bld->GetFlag()] = Region(bld, bld->GetFlag());
-                CalculateRegion(hq->GetFlag(), considered);
+    // Drop regions without a root and add the new ones.
+    bool rootsChanged = roots.size() != regions_.size();
+    for (auto it = regions_.begin(); it != regions_.end();) {
+        const MapPoint regionPt = it->first;
+        if (std::none_of(roots.begin(), roots.end(), [&](const std::pair<MapPoint, unsigned>& root) { return root.first == regionPt; })) {
+            for (auto& member : members_) {
+                if (member.second.region == regionPt) {
+                    RemoveMember(regionPt, member.second.type, member.second.building);
+                    member.second.region = MapPoint::Invalid();
+                }
             }
+            it = regions_.erase(it);
+            rootsChanged = true;
+        } else {
+            ++it;
         }
     }
+    for (const auto& root : roots) {
+        if (regions_.find(root.first) == regions_.end())
+            regions_.emplace(root.first, Region(root.first));
+    }
+
+    // Construction sites at flags already connected show up without a building or road note.
+    if (membersDirty_ || rootsChanged || world.GetBuildingChanges() != buildingChanges_)
+        work += UpdateMembers(roots);
+
+    // If there was no more HQ, make the first region with industry the main region.
+    for (auto& it : regions_)
+        it.second.isMain = hq && it.first == hq->GetFlag();
+    if (!hq && !regions_.empty()) {
+        auto main = std::find_if(regions_.begin(), regions_.end(), [](const std::pair<const MapPoint, Region>& it)
+        {
+            return it.second.CountBuildings({ BLD_METALWORKS, BLD_ARMORY, BLD_IRONSMELTER }) > 0;
+        });
+        if (main == regions_.end())
+            main = regions_.begin();
+        main->second.isMain = true;
+    }
 
-    // If there was no more HQ, make the firs region with industry the main region.
-    if (nullptr == hq) {
-        bool found = false;
-        for (auto& it : regions_) {
-            Region& region = it.second;
-            for (const Building* bld : region.buildings) {
-                if (bld->GetType() == BLD_METALWORKS || bld->GetType() == BLD_ARMORY || bld->GetType() == BLD_IRONSMELTER) {
-                    region.isMain = true;
-                    found = true;
+    for (auto& it : regions_) {
+        Region& region = it.second;
+        if (++region.resourcesAge >= S_resources_refresh_runs)
+            region.resourcesDirty = true;
+        if (region.resourcesDirty)
+            work += CalculateResources(it.first, region);
+    }
+
+    return work;
+}
+
+unsigned ProductionPlanner::UpdateMembers(const std::vector<std::pair<MapPoint, unsigned>>& roots)
+{
+    const World& world = beowulf_->world;
+    currentScan_++;
+    membersDirty_ = false;
+    buildingChanges_ = world.GetBuildingChanges();
+
+    for (const Building* bld : world.GetBuildings()) {
+        // Only buildings on the map (not just planned) count for a region.
+        MapPoint regionPt = MapPoint::Invalid();
+        if (bld->GetPt().isValid() && world.GetBuilding(bld->GetPt()) == bld) {
+            const MapPoint flag = bld->GetFlag();
+            const unsigned network = world.GetRoadNetwork(flag);
+            for (const auto& root : roots) {
+                if (root.first == flag || (network != RoadNetworks::InvalidNetwork && root.second == network)) {
+                    regionPt = root.first;
                     break;
                 }
             }
-            if (found)
-                break;
         }
 
-        if (!found) {
-            // Make first region main.
-            auto it = regions_.begin();
-            Region& region = (*it).second;
-            region.isMain = true;
+        const BuildingHandle handle = world.GetHandle(bld);
+        auto it = members_.find(handle);
+        if (it == members_.end()) {
+            members_[handle] = { regionPt, bld->GetType(), bld, currentScan_ };
+            if (regionPt.isValid())
+                AddMember(regionPt, bld->GetType(), bld);
+            continue;
         }
+
+        Member& member = it->second;
+        member.lastSeen = currentScan_;
+        if (member.region == regionPt)
+            continue;
+        if (member.region.isValid())
+            RemoveMember(member.region, member.type, bld);
+        member.region = regionPt;
+        if (regionPt.isValid())
+            AddMember(regionPt, member.type, bld);
     }
+
+    // Buildings removed from the world.
+    for (auto it = members_.begin(); it != members_.end();) {
+        if (it->second.lastSeen != currentScan_) {
+            if (it->second.region.isValid())
+                RemoveMember(it->second.region, it->second.type, it->second.building);
+            it = members_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return static_cast<unsigned>(world.GetBuildings().size());
 }
 
-void ProductionPlanner::CalculateRegion(
-        const MapPoint& flag,
-        std::set<const Building*>& considered)
+void ProductionPlanner::AddMember(const MapPoint& regionPt, BuildingType type, const Building* building)
 {
-    World& world = beowulf_->world;
-    Region& region = regions_[flag];
+    Region& region = regions_[regionPt];
+    region.buildings.push_back(building);
 
-    // Find all buildings.
-    FloodFill(world, flag,
-    // Condition
-    [&](const MapPoint& pt, Direction dir)
-    {
-        return world.HasRoad(pt, dir);
-    },
-    // Action
-    [&](const MapPoint& pt)
-    {
-        if (world.HasFlag(pt)) {
-            MapPoint buildingPt = world.GetNeighbour(pt, Direction::NORTHWEST);
-            const Building* bld = world.GetBuilding(buildingPt);
-            if (bld) {
-                if (considered.find(bld) != considered.end())
-                    return;
-
-                region.buildings.push_back(bld);
-                considered.insert(bld);
-
-                const ProductionStats& prod = PRODUCTION[bld->GetType()];
-                if (prod.production != BGD_NONE) {
-                    region.production[prod.production].produced += prod.speed;
-                    globalProduction_[prod.production].produced += prod.speed;
-                }
-                for (BGoodType type : prod.consumption) {
-                    region.production[type].consumed += prod.speed;
-                    globalProduction_[type].consumed += prod.speed;
-                }
-            }
-        }
-    });
+    const ProductionStats& prod = PRODUCTION[type];
+    if (prod.production != BGD_NONE) {
+        region.production[prod.production].produced += prod.speed;
+        globalProduction_[prod.production].produced += prod.speed;
+    }
+    for (BGoodType good : prod.consumption) {
+        region.production[good].consumed += prod.speed;
+        globalProduction_[good].consumed += prod.speed;
+    }
+}
+
+void ProductionPlanner::RemoveMember(const MapPoint& regionPt, BuildingType type, const Building* building)
+{
+    Region& region = regions_[regionPt];
+    // Only one entry: a new building can reuse the address of a removed one (see BuildingPool).
+    auto it = std::find(region.buildings.begin(), region.buildings.end(), building);
+    if (it != region.buildings.end())
+        region.buildings.erase(it);
+
+    const ProductionStats& prod = PRODUCTION[type];
+    if (prod.production != BGD_NONE) {
+        region.production[prod.production].produced -= prod.speed;
+        globalProduction_[prod.production].produced -= prod.speed;
+    }
+    for (BGoodType good : prod.consumption) {
+        region.production[good].consumed -= prod.speed;
+        globalProduction_[good].consumed -= prod.speed;
+    }
+}
+
+unsigned ProductionPlanner::CalculateResources(const MapPoint& regionPt, Region& region)
+{
+    World& world = beowulf_->world;
+    region.resources.fill(0);
+    region.resourcesDirty = false;
+    region.resourcesAge = 0;
 
     // Find all resources.
     BuildLocations bl(world, false);
-    bl.Calculate(flag);
+    bl.Calculate(regionPt);
 
     for (const MapPoint& pt : bl.Get()) {
+        locationRegion_[world.GetIdx(pt)] = regionPt;
         BuildingQuality bq = bl.Get(pt);
 
         if (bq == BQ_MINE) {
@@ -514,6 +663,8 @@ void ProductionPlanner::CalculateRegion(
             region.resources[BResourcePlantSpace_2] += world.resources.GetReachable(pt, BResourcePlantSpace_2);
         }
     }
+
+    return 1 + bl.GetSize();
 }
 
 }  // namespace beowulf
@@ -20,6 +20,7 @@
 #include "ai/beowulf/recurrent/RecurrentBase.h"
 #include "ai/beowulf/Types.h"
 #include "ai/beowulf/Helper.h"
+#include "ai/beowulf/BuildingPool.h"
 
 #include "gameTypes/BuildingType.h"
 #include "gameTypes/GoodTypes.h"
@@ -27,7 +28,8 @@
 
 #include <string>
 #include <map>
-#include <set>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 class AIInterface;
@@ -49,7 +51,7 @@ class ProductionPlanner : public RecurrentBase
 
     struct Region {
         Region();
-        Region(const Building* building, const MapPoint& flag, bool main = false);
+        explicit Region(const MapPoint& flag);
 
         // Whether this is the main region where we want to produce weapons and beer.
         bool isMain = false;
@@ -62,6 +64,10 @@ class ProductionPlanner : public RecurrentBase
 
         // Available resources (except for wood and stone, only the resources not yet harvested).
         std::array<unsigned, BResourceCount> resources;
+        // Resources have to be recalculated (BQ, roads or buildings changed in the region).
+        bool resourcesDirty = true;
+        // Runs since the last calculation of the resources.
+        unsigned resourcesAge = 0;
 
         unsigned GetTotalJobs(Job job) const;
         unsigned GetTotalGoods(GoodType good) const;
@@ -71,13 +77,29 @@ class ProductionPlanner : public RecurrentBase
 public:
     ProductionPlanner(Beowulf* beowulf);
 
-    void OnRun() override;
+    unsigned OnRun() override;
 
     unsigned GetTotalProduction(BGoodType type) const;
 
 private:
-    void CalculateRegions();
-    void CalculateRegion(const MapPoint& flag, std::set<const Building*>& considered);
+    /// Plan the regions one by one. Resumable: returns false if regions are left after 'budget' is exhausted.
+    bool OnStep(Budget& budget) override;
+
+    void OnBuildingNote(const BuildingNote& note) override;
+    void OnRoadNote(const RoadNote& note) override;
+    void OnNodeNote(const NodeNote& note) override;
+
+    /// Bring the regions up to date with the changes since the last call.
+    /// Returns the work done.
+    unsigned UpdateRegions();
+    /// Move buildings between regions and adjust the production of the regions.
+    unsigned UpdateMembers(const std::vector<std::pair<MapPoint, unsigned>>& roots);
+    void AddMember(const MapPoint& regionPt, BuildingType type, const Building* building);
+    void RemoveMember(const MapPoint& regionPt, BuildingType type, const Building* building);
+    /// Sum the resources of all build locations of the region. Returns the work done.
+    unsigned CalculateResources(const MapPoint& regionPt, Region& region);
+    /// The resources of the region containing 'pt' (or of the known locations next to it) have to be recalculated.
+    void SetResourcesDirty(const MapPoint& pt);
 
     void Plan(const MapPoint& regionPt, Region& region);
 
@@ -87,6 +109,27 @@ private:
 
     std::map<MapPoint, Region, MapPointComp> regions_;
     std::array<Production, BGD_COUNT> globalProduction_;
+
+    // Region every building is counted for (invalid if none).
+    struct Member
+    {
+        MapPoint region;
+        BuildingType type;
+        // The address may already be reused once the building is removed.
+        const Building* building;
+        unsigned lastSeen;
+    };
+    std::unordered_map<BuildingHandle, Member, BuildingHandle::Hash> members_;
+    unsigned currentScan_ = 0;
+    // Buildings or roads changed since the last scan of the members.
+    bool membersDirty_ = true;
+    // World::GetBuildingChanges() at the last scan of the members.
+    unsigned buildingChanges_ = 0;
+    // Region flag of every build location at the last calculation of the resources.
+    std::vector<MapPoint> locationRegion_;
+
+    // Region to continue planning with in the next step (invalid if all were planned).
+    MapPoint nextRegion_ = MapPoint::Invalid();
 };
 
 } // namespace beowulf
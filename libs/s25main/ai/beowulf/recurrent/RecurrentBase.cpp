@@ -17,6 +17,7 @@
 
 #include "ai/beowulf/recurrent/RecurrentBase.h"
 #include "ai/beowulf/Beowulf.h"
+#include "ai/beowulf/Budget.h"
 
 #include "notifications/NotificationManager.h"
 #include "notifications/BuildingNote.h"
@@ -24,10 +25,6 @@
 #include "notifications/ToolNote.h"
 #include "notifications/NodeNote.h"
 
-#include <boost/lambda/lambda.hpp>
-#include <boost/lambda/bind.hpp>
-#include <boost/lambda/if.hpp>
-
 namespace beowulf {
 
 RecurrentBase::RecurrentBase(Beowulf* beowulf, unsigned interval, unsigned intervalCounter)
@@ -41,38 +38,60 @@ RecurrentBase::RecurrentBase(Beowulf* beowulf, unsigned interval, unsigned inter
 
     NotificationManager& notifications = beowulf_->GetAII().gwb.GetNotifications();
 
-    events_.push_back(notifications.subscribe<BuildingNote>([this](const BuildingNote& note)
+    // Notes are delivered through the world's queue, so they are held back while planning
+    // in the background. The territory filter refers to the time the note was raised.
+    NoteQueue& queue = beowulf_->world.notes;
+
+    events_.push_back(notifications.subscribe<BuildingNote>([this, &queue](const BuildingNote& note)
     {
-        if (note.player == beowulf_->GetPlayerId()) OnBuildingNote(note);
+        if (note.player == beowulf_->GetPlayerId())
+            queue.Dispatch(note, [this](const BuildingNote& note) { OnBuildingNote(note); });
     }));
 
-    events_.push_back(notifications.subscribe<RoadNote>([this](const RoadNote& note)
+    events_.push_back(notifications.subscribe<RoadNote>([this, &queue](const RoadNote& note)
     {
-        if (note.player == beowulf_->GetPlayerId()) OnRoadNote(note);
+        if (note.player == beowulf_->GetPlayerId())
+            queue.Dispatch(note, [this](const RoadNote& note) { OnRoadNote(note); });
     }));
 
-    events_.push_back(notifications.subscribe<ToolNote>([this](const ToolNote& note)
+    events_.push_back(notifications.subscribe<ToolNote>([this, &queue](const ToolNote& note)
     {
-        if (note.player == beowulf_->GetPlayerId()) OnToolNote(note);
+        if (note.player == beowulf_->GetPlayerId())
+            queue.Dispatch(note, [this](const ToolNote& note) { OnToolNote(note); });
     }));
 
-    events_.push_back(notifications.subscribe<NodeNote>([this](const NodeNote& note)
+    events_.push_back(notifications.subscribe<NodeNote>([this, &queue](const NodeNote& note)
     {
-        if (note.type == NodeNote::BQ && beowulf_->GetAII().gwb.IsPlayerTerritory(note.pos)) OnNodeNote(note);
+        if (note.type == NodeNote::BQ && beowulf_->GetAII().gwb.IsPlayerTerritory(note.pos))
+            queue.Dispatch(note, [this](const NodeNote& note) { OnNodeNote(note); });
     }));
 }
 
-void RecurrentBase::RunGf()
+void RecurrentBase::RunGf(Budget& budget)
 {
     if (!enabled_)
         return;
 
-    if (0 == intervalCounter_) {
-        OnRun();
-        intervalCounter_ = interval_;
-    } else {
+    if (!IsDue()) {
         intervalCounter_--;
+        return;
+    }
+
+    if (budget.IsExhausted()) {
+        deferred_++;
+        return;
     }
+
+    deferred_ = 0;
+    pending_ = !OnStep(budget);
+    if (!pending_)
+        intervalCounter_ = interval_;
+}
+
+bool RecurrentBase::OnStep(Budget& budget)
+{
+    budget.Spend(OnRun());
+    return true;
 }
 
 void RecurrentBase::OnToolNote(const ToolNote& note)
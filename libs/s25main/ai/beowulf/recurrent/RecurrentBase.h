@@ -30,6 +30,7 @@ class NodeNote;
 namespace beowulf {
 
 class Beowulf;
+class Budget;
 
 class RecurrentBase
 {
@@ -42,14 +43,30 @@ public:
     virtual ~RecurrentBase() {}
 
     // Called by Beowulf only after network synchronization frames occured.
-    void RunGf();
+    // A due recurrent is deferred to the next call if 'budget' is exhausted.
+    void RunGf(Budget& budget);
+
+    // Whether the next call to RunGf() will run the recurrent.
+    bool IsDue() const { return enabled_ && (pending_ || 0 == intervalCounter_); }
+
+    // Recurrents with a higher priority run first. Every deferred run raises the priority by one.
+    void SetPriority(unsigned priority) { priority_ = priority; }
+    unsigned GetPriority() const { return priority_ + deferred_; }
 
     void Enable() { enabled_ = true; }
     void Disable() { enabled_ = false; }
 
 protected:
-    // Implement me.
-    virtual void OnRun() = 0;
+    // Implement me. Returns the work done in the units of Budget.
+    virtual unsigned OnRun() = 0;
+
+    /*
+     * Run (part of) the recurrent and spend the work done from 'budget'.
+     * Returns false if the work is not finished. It is then resumed on the next
+     * run of Beowulf regardless of the interval.
+     * The default runs OnRun() to completion and spends the work it reports.
+     */
+    virtual bool OnStep(Budget& budget);
 
     virtual void OnToolNote(const ToolNote& note);
     virtual void OnBuildingNote(const BuildingNote& note);
@@ -66,6 +83,12 @@ private:
 
     unsigned interval_;
     unsigned intervalCounter_;
+
+    unsigned priority_ = 0;
+    // Number of runs deferred due to an exhausted budget.
+    unsigned deferred_ = 0;
+    // The last OnStep() did not finish.
+    bool pending_ = false;
 };
 
 } // namespace beowulf
@@ -23,24 +23,73 @@
 #include "ai/beowulf/ProductionConsts.h"
 #include "ai/beowulf/BuildLocations.h"
 #include "ai/beowulf/Debug.h"
+#include "ai/beowulf/Budget.h"
 
 #include "notifications/BuildingNote.h"
 #include "notifications/RoadNote.h"
 #include "helpers/containerUtils.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace beowulf {
 
+// The heuristic of Connect() is exact up to this distance beyond the start. Points further
+// away from the destination are rarely expanded and share a lower bound.
+static const unsigned S_goal_distance_margin = 8;
+
 RoadManager::RoadManager(Beowulf* beowulf)
-    : RecurrentBase(beowulf)
+    : RecurrentBase(beowulf, 10), // refresh the traffic every 10*16 gf
+      traffic_(beowulf->world)
+{
+    const unsigned numNodes = beowulf->world.GetSize().x * beowulf->world.GetSize().y;
+    farmLand_.resize(numNodes, false);
+    goalDistances_.resize(numNodes);
+}
+
+unsigned RoadManager::OnRun()
 {
-    nodes_.Resize(beowulf->world.GetSize());
+    Budget budget;
+    while (!OnStep(budget)) {}
+    return budget.GetSpent();
+}
+
+bool RoadManager::OnStep(Budget& budget)
+{
+    // Routes change with new roads and flags, so keep refreshing them.
+    const std::vector<Building*>& buildings = beowulf_->world.GetBuildings();
+    while (nextBuilding_ < buildings.size()) {
+        const Building* building = buildings[nextBuilding_++];
+        if (connected.find(beowulf_->world.GetHandle(building)) != connected.end())
+            budget.Spend(1 + traffic_.Update(building));
+
+        if (budget.IsExhausted() && nextBuilding_ < buildings.size())
+            return false;
+    }
+
+    nextBuilding_ = 0;
+    SplitCongestedRoad();
+    return true;
 }
 
-void RoadManager::OnRun()
+bool RoadManager::SplitCongestedRoad()
 {
-    /*
-     * @todo: Try to connect a different building every time.
-     */
+    World& world = beowulf_->world;
+    for (const auto& segment : traffic_.GetCongestedSegments(UPPER_TRAFFIC_LIMIT)) {
+        if (world.GetRoadState(segment.first, segment.second) != RoadFinished)
+            continue;
+
+        // A flag at either end of the segment halves the road it belongs to.
+        for (const MapPoint& pt : { segment.first, world.GetNeighbour(segment.first, segment.second) }) {
+            if (world.HasFlag(pt))
+                continue;
+            if (beowulf_->GetAII().GetBuildingQuality(pt) == BQ_NOTHING)
+                continue;
+            world.ConstructFlag(pt);
+            return true;
+        }
+    }
+    return false;
 }
 
 bool RoadManager::Connect(const Building* building, BuildLocations* buildLocations)
@@ -58,29 +107,55 @@ bool RoadManager::Connect(const Building* building, BuildLocations* buildLocatio
             return false;
     }
 
-    // Find a suitable path.
-    std::vector<Direction> route;
+    World& world = beowulf_->world;
     MapPoint start = building->GetFlag();
     MapPoint dest = destBuilding->GetFlag();
-    bool ret = FindPath(start, beowulf_->world, &route,
+
+    // Any flag of the destination's road network will do.
+    const unsigned destNetwork = world.GetRoadNetwork(dest);
+    if (destNetwork != RoadNetworks::InvalidNetwork && world.GetRoadNetwork(start) == destNetwork) {
+        AddConnected(building);
+        traffic_.Update(building);
+        return true;
+    }
+    std::vector<MapPoint> goals;
+    if (destNetwork == RoadNetworks::InvalidNetwork) {
+        goals.push_back(dest);
+    } else {
+        for (const MapPoint& flag : world.GetFlags()) {
+            if (world.GetRoadNetwork(flag) == destNetwork)
+                goals.push_back(flag);
+        }
+        if (goals.empty())
+            goals.push_back(dest);
+    }
+    unsigned startDistance = std::numeric_limits<unsigned>::max();
+    for (const MapPoint& goal : goals)
+        startDistance = std::min(startDistance, world.CalcDistance(start, goal));
+    CalcGoalDistances(goals, startDistance + S_goal_distance_margin);
+
+    // Find a suitable path.
+    std::vector<Direction> route;
+    bool ret = world.GetPathFinder().FindPath(start, &route,
     // Condition
     [&](const MapPoint& pt, Direction dir)
     {
         if (pt == start && dir == Direction::NORTHWEST)
             return false;
-        return beowulf_->world.HasRoad(pt, dir) || beowulf_->world.IsRoadPossible(pt, dir, false);
+        return world.HasRoad(pt, dir) || world.IsRoadPossible(pt, dir, false);
     },
     // End
     [&](const MapPoint& pt)
     {
-        // The search can end if we found a way to any flag of the destination
-        // road network.
-        return pt == dest;
+        if (destNetwork == RoadNetworks::InvalidNetwork)
+            return pt == dest;
+        return world.GetRoadNetwork(pt) == destNetwork && world.HasFlag(pt);
     },
     // Heuristic
     [&](const MapPoint& pt)
     {
-        return beowulf_->world.CalcDistance(pt, dest);
+        // Every step costs at least 1. The distance to the closest goal is admissible.
+        return GetGoalDistance(pt);
     },
     // Cost
     [&](const MapPoint& pt, Direction dir)
@@ -88,12 +163,15 @@ bool RoadManager::Connect(const Building* building, BuildLocations* buildLocatio
         unsigned ret = 1;
         if (beowulf_->world.HasRoad(pt, dir)) {
             // Check if we exceed the upper traffic limit.
-            if (building->GetTraffic().consumed > 0) {
-                if ((GetTraffic(pt, dir, 0) + building->GetTraffic().consumed) > UPPER_TRAFFIC_LIMIT)
+            // Produced wares leave along the route, consumed ones come back.
+            const Building::TrafficExpected& traffic = building->GetTraffic();
+            if (traffic.produced > 0) {
+                if ((traffic_.GetFlow(pt, dir) + traffic.produced) > UPPER_TRAFFIC_LIMIT)
                     ret += 10; // punish
             }
-            if (building->GetTraffic().produced > 0) {
-                if ((GetTraffic(pt, dir, 1) + building->GetTraffic().consumed) > UPPER_TRAFFIC_LIMIT)
+            if (traffic.consumed > 0) {
+                const MapPoint next = beowulf_->world.GetNeighbour(pt, dir);
+                if ((traffic_.GetFlow(next, OppositeDirection(dir)) + traffic.consumed) > UPPER_TRAFFIC_LIMIT)
                     ret += 10; // punish
             }
         } else {
@@ -102,7 +180,7 @@ bool RoadManager::Connect(const Building* building, BuildLocations* buildLocatio
 
             // Building on farmland is also not good.
             MapPoint to = beowulf_->world.GetNeighbour(pt, dir);
-            if (nodes_[to].isFarmLand)
+            if (farmLand_[beowulf_->world.GetIdx(to)])
                 ret += 10;
         }
         return ret;
@@ -127,7 +205,7 @@ bool RoadManager::Connect(const Building* building, BuildLocations* buildLocatio
                 subpath.clear();
             }
         }
-        cur = nodes_.GetNeighbour(cur, dir);
+        cur = beowulf_->world.GetNeighbour(cur, dir);
     }
 
     if (!subpath.empty()) {
@@ -136,13 +214,85 @@ bool RoadManager::Connect(const Building* building, BuildLocations* buildLocatio
             buildLocations->Update(subpathStart, subpath.size() + 2);
     }
 
-    connected.insert(building);
+    AddConnected(building);
+    traffic_.Update(building);
     return true;
 }
 
+void RoadManager::AddConnected(const Building* building)
+{
+    const World& world = beowulf_->world;
+    const BuildingHandle handle = world.GetHandle(building);
+    const unsigned flagIdx = world.GetIdx(building->GetFlag());
+    connected[handle] = flagIdx;
+    connectedFlags_[flagIdx] = handle;
+}
+
+void RoadManager::RemoveConnected(const BuildingHandle& handle)
+{
+    auto it = connected.find(handle);
+    if (it == connected.end())
+        return;
+    auto flagIt = connectedFlags_.find(it->second);
+    if (flagIt != connectedFlags_.end() && flagIt->second == handle)
+        connectedFlags_.erase(flagIt);
+    connected.erase(it);
+}
+
+void RoadManager::CalcGoalDistances(const std::vector<MapPoint>& goals, unsigned maxDistance)
+{
+    const World& world = beowulf_->world;
+
+    // If the counter reaches its maximum, tidy up.
+    if (goalStamp_ == std::numeric_limits<unsigned>::max()) {
+        for (GoalDistance& node : goalDistances_)
+            node.stamp = 0;
+        goalStamp_ = 1;
+    } else {
+        goalStamp_++;
+    }
+    goalDistanceLimit_ = maxDistance;
+
+    std::vector<MapPoint> current;
+    std::vector<MapPoint> next;
+    for (const MapPoint& goal : goals) {
+        GoalDistance& node = goalDistances_[world.GetIdx(goal)];
+        if (node.stamp == goalStamp_)
+            continue;
+        node.stamp = goalStamp_;
+        node.distance = 0;
+        current.push_back(goal);
+    }
+
+    // Each ring of neighbours is one step further away (same as World::CalcDistance()).
+    for (unsigned distance = 1; distance <= maxDistance && !current.empty(); ++distance) {
+        for (const MapPoint& pt : current) {
+            for (const Direction dir : helpers::EnumRange<Direction>{}) {
+                const MapPoint neighbour = world.GetNeighbour(pt, dir);
+                GoalDistance& node = goalDistances_[world.GetIdx(neighbour)];
+                if (node.stamp == goalStamp_)
+                    continue;
+                node.stamp = goalStamp_;
+                node.distance = distance;
+                next.push_back(neighbour);
+            }
+        }
+        current.swap(next);
+        next.clear();
+    }
+}
+
+unsigned RoadManager::GetGoalDistance(const MapPoint& pt) const
+{
+    const GoalDistance& node = goalDistances_[beowulf_->world.GetIdx(pt)];
+    if (node.stamp != goalStamp_)
+        return goalDistanceLimit_ + 1;
+    return node.distance;
+}
+
 bool RoadManager::IsConnected(const MapPoint& src, const MapPoint& dst) const
 {
-    return FindPath(src, beowulf_->world, nullptr,
+    return beowulf_->world.GetPathFinder().FindPath(src, nullptr,
     // Condition
     [&](const MapPoint& pt, Direction dir)
     {
@@ -178,37 +328,16 @@ void RoadManager::OnBuildingNote(const BuildingNote& note)
     case BuildingNote::SetBuildingSiteFailed:
     case BuildingNote::Destroyed:
     {
-        Building* bld = nullptr;
         RTTR_Assert(!beowulf_->world.GetBuilding(note.pos));
 
-        /*
-         * The exact building is not known.
-         * But there is a way we can find out which one it was.
-         *
-         * We check all users on roads attached to the flag position.
-         * The one that occurs only once is the correct building.
-         * We can even validate that by the building type provided in 'note'.
-         */
-        MapPoint flag = nodes_.GetNeighbour(note.pos, Direction::SOUTHEAST);
-        std::map<const Building*, unsigned> users_counts;
-        for (const auto dir : helpers::EnumRange<Direction>{}) {
-            for (const Building* user : GetUsers(flag, dir)) {
-                if (users_counts.find(user) == users_counts.end())
-                    users_counts[user] = 1;
-                else
-                    users_counts[user]++;
-            }
-        }
-
-        for (const auto& it : users_counts) {
-            if (it.second == 1) {
-                RTTR_Assert(bld == nullptr);
-                bld = const_cast<Building*>(it.first);
-            }
+        // The building is gone, but its flag tells which one it was.
+        const MapPoint flag = beowulf_->world.GetNeighbour(note.pos, Direction::SOUTHEAST);
+        auto it = connectedFlags_.find(beowulf_->world.GetIdx(flag));
+        if (it != connectedFlags_.end()) {
+            const BuildingHandle bld = it->second;
+            RemoveConnected(bld);
+            traffic_.Remove(bld);
         }
-
-        if (bld)
-            UnsetUsage(bld);
     } break;
     case BuildingNote::Captured:
     {
@@ -236,16 +365,20 @@ void RoadManager::OnRoadNote(const RoadNote& note)
     case RoadNote::Destroyed:
     {
         // Find all buildings that used this road and try to create new connections.
-        std::set<const Building*> buildings;
+        std::set<BuildingHandle> buildings;
         MapPoint cur = note.pos;
         for (Direction dir : note.route) {
-            for (const Building* bld : GetUsers(cur, dir))
+            for (const BuildingHandle& bld : traffic_.GetUsers(cur, dir))
                 buildings.insert(bld);
-            cur = nodes_.GetNeighbour(cur, dir);
+            cur = beowulf_->world.GetNeighbour(cur, dir);
         }
-        for (const Building* bld : buildings) {
-            connected.erase(bld);
-            UnsetUsage(bld);
+        for (const BuildingHandle& handle : buildings) {
+            RemoveConnected(handle);
+            traffic_.Remove(handle);
+            // Skip buildings removed in the meantime.
+            const Building* bld = beowulf_->world.GetBuilding(handle);
+            if (!bld)
+                continue;
             if (!Connect(bld)) {
                 // destroy the construction site
                 if (bld->GetState() == Building::UnderConstruction)
@@ -268,64 +401,4 @@ void RoadManager::OnRoadNote(const RoadNote& note)
     }
 }
 
-void RoadManager::SetUsage(const Building* building, const std::vector<Direction>& route)
-{
-    MapPoint cur = building->GetFlag();
-    for (Direction dir : route) {
-        SetUsage(building, cur, dir);
-        cur = nodes_.GetNeighbour(cur, dir);
-    }
-}
-
-void RoadManager::SetUsage(const Building* building, const MapPoint& pt, Direction dir)
-{
-    Direction oppositeDir = OppositeDirection(dir);
-    const Building::TrafficExpected& traffic = building->GetTraffic();
-    if (dir.native_value() >= 3) {
-        Node& node = nodes_[pt];
-        node.users[oppositeDir.native_value()].push_back(building);
-        node.usage[oppositeDir.native_value()][0] += traffic.produced;
-        node.usage[oppositeDir.native_value()][1] += traffic.consumed;
-    } else {
-        Node& node = nodes_[nodes_.GetNeighbour(pt, dir)];
-        node.users[dir.native_value()].push_back(building);
-        node.usage[dir.native_value()][1] += traffic.produced;
-        node.usage[dir.native_value()][0] += traffic.consumed;
-    }
-}
-
-void RoadManager::UnsetUsage(const Building* building)
-{
-    MapPoint cur = building->GetFlag();
-    bool found = true;
-    while (found) {
-        found = false;
-        for (const auto dir : helpers::EnumRange<Direction>{}) {
-            std::vector<const Building*>& users = GetUsers(cur, dir);
-            if (helpers::contains(users, building)) {
-                users.erase(std::remove(users.begin(), users.end(), building), users.end());
-                cur = nodes_.GetNeighbour(cur, dir);
-                found = true;
-                break;
-            }
-        }
-    }
-}
-
-std::vector<const Building*>& RoadManager::GetUsers(const MapPoint& pt, Direction dir)
-{
-    if (dir.native_value() >= 3)
-        return nodes_[pt].users[OppositeDirection(dir).native_value()];
-    else
-        return nodes_[nodes_.GetNeighbour(pt, dir)].users[dir.native_value()];
-}
-
-unsigned RoadManager::GetTraffic(const MapPoint& pt, Direction dir, unsigned char d) const
-{
-    if (dir.native_value() >= 3)
-        return nodes_[pt].usage[OppositeDirection(dir).native_value()][d];
-    else
-        return nodes_[nodes_.GetNeighbour(pt, dir)].usage[dir.native_value()][d];
-}
-
 } // namespace beowulf
@@ -18,11 +18,14 @@
 #define BEOWULF_RECURRENT_ROADMANAGER_H_INCLUDED
 
 #include "ai/beowulf/recurrent/RecurrentBase.h"
+#include "ai/beowulf/TrafficMap.h"
 
-#include "world/NodeMapBase.h"
+#include "gameTypes/MapCoordinates.h"
+#include "gameTypes/Direction.h"
 
-#include <vector>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace beowulf {
 
@@ -34,7 +37,7 @@ class RoadManager : public RecurrentBase
 public:
     RoadManager(Beowulf* beowulf);
 
-    void OnRun() override;
+    unsigned OnRun() override;
 
     // Can optionally update a buildLocations object.
     bool Connect(const Building* building, BuildLocations* buildLocations = nullptr);
@@ -43,24 +46,51 @@ public:
 
     bool IsConnected(const MapPoint& src, const MapPoint& dst) const;
 
+    /// Expected ware flow of all connected buildings.
+    const TrafficMap& GetTrafficMap() const { return traffic_; }
+
 private:
+    /// Refresh the ware routes of the buildings one by one and relieve the most congested road.
+    /// Resumable: returns false if buildings are left after 'budget' is exhausted.
+    bool OnStep(Budget& budget) override;
+
     void OnBuildingNote(const BuildingNote& note) override;
     void OnRoadNote(const RoadNote& note) override;
 
-    void SetUsage(const Building* building, const std::vector<Direction>& route);
-    void SetUsage(const Building* building, const MapPoint& pt, Direction dir);
-    void UnsetUsage(const Building* building);
-    unsigned GetTraffic(const MapPoint& pt, Direction dir, unsigned char d) const;
-    std::vector<const Building*>& GetUsers(const MapPoint& pt, Direction dir);
+    /// Place a flag on a congested road, so more carriers (and donkeys) share its load.
+    /// Returns true if a flag was placed.
+    bool SplitCongestedRoad();
+
+    /// Breadth-first search from all 'goals' up to 'maxDistance' for the heuristic of Connect().
+    void CalcGoalDistances(const std::vector<MapPoint>& goals, unsigned maxDistance);
+    /// Distance of 'pt' to the closest goal. Points out of reach get a lower bound.
+    unsigned GetGoalDistance(const MapPoint& pt) const;
+
+    void AddConnected(const Building* building);
+    void RemoveConnected(const BuildingHandle& handle);
+
+    /// Connected buildings with the map index of their flag and the reverse lookup, since
+    /// notes of destroyed buildings only provide the position.
+    std::unordered_map<BuildingHandle, unsigned, BuildingHandle::Hash> connected;
+    std::unordered_map<unsigned, BuildingHandle> connectedFlags_;
 
-    std::set<const Building*> connected;
+    TrafficMap traffic_;
+    /// Next building to refresh in OnStep().
+    size_t nextBuilding_ = 0;
+    std::vector<bool> farmLand_;
 
-    struct Node {
-        std::vector<const Building*> users[3];
-        bool isFarmLand = false;
-        unsigned usage[3][2] = { { 0 } }; // Usage is directional (0 ... from here to neighbour, 1 ... from neighbour to here)
+    /*
+     * Reusable distance field of CalcGoalDistances(). Entries are only valid if their stamp
+     * matches 'goalStamp_' and are invalidated by increasing it instead of clearing the grid.
+     */
+    struct GoalDistance
+    {
+        unsigned stamp = 0;
+        unsigned distance = 0;
     };
-    NodeMapBase<Node> nodes_;
+    std::vector<GoalDistance> goalDistances_;
+    unsigned goalStamp_ = 0;
+    unsigned goalDistanceLimit_ = 0;
 };
 
 } // namespace beowulf
@@ -26,9 +26,9 @@ ScoutManager::ScoutManager(Beowulf* beowulf)
 
 }
 
-void ScoutManager::OnRun()
+unsigned ScoutManager::OnRun()
 {
-
+    return 0;
 }
 
 } // namespace beowulf
@@ -26,7 +26,7 @@ class ScoutManager : public RecurrentBase
 public:
     ScoutManager(Beowulf* beowulf);
 
-    void OnRun() override;
+    unsigned OnRun() override;
 };
 
 } // namespace beowulf
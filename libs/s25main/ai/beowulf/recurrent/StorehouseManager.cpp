@@ -26,9 +26,9 @@ StorehouseManager::StorehouseManager(Beowulf* beowulf)
 
 }
 
-void StorehouseManager::OnRun()
+unsigned StorehouseManager::OnRun()
 {
-
+    return 0;
 }
 
 } // namespace beowulf
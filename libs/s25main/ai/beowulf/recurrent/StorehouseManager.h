@@ -26,7 +26,7 @@ class StorehouseManager : public RecurrentBase
 public:
     StorehouseManager(Beowulf* beowulf);
 
-    void OnRun() override;
+    unsigned OnRun() override;
 
 private:
 };
@@ -84,6 +84,8 @@ noBaseBuilding::~noBaseBuilding() = default;
 
 void noBaseBuilding::Destroy_noBaseBuilding()
 {
+    gwg->RemoveObserver(*this);
+    gwg->RemoveTerritoryClaim(*this);
     DestroyAllRoads();
     gwg->GetNotifications().publish(BuildingNote(BuildingNote::Destroyed, player, pos, bldType_));
 
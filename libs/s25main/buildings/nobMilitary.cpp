@@ -323,8 +323,10 @@ unsigned nobMilitary::GetMaxTroopsCt() const
 
 void nobMilitary::LookForEnemyBuildings(const nobBaseMilitary* const exception)
 {
-    // Umgebung nach Militärgebäuden absuchen
-    sortedMilitaryBlds buildings = gwg->LookForMilitaryBuildings(pos, 3);
+    // Umgebung nach Militärgebäuden absuchen. Only our own buildings around? -> Nothing to check
+    sortedMilitaryBlds buildings;
+    if(gwg->IsAnyMilitaryBuildingNear(pos, 3, ~(1u << player)))
+        buildings = gwg->LookForMilitaryBuildings(pos, 3);
     frontier_distance = DIST_FAR;
 
     const bool frontierDistanceCheck = gwg->GetGGS().isEnabled(AddonId::FRONTIER_DISTANCE_REACHABLE);
@@ -936,6 +938,7 @@ void nobMilitary::Capture(const unsigned char new_owner)
     gwg->GetPlayer(old_player).RemoveBuilding(this, bldType_);
     // neuer Spieler
     player = new_owner;
+    gwg->GetMilitarySquares().PlayerChanged(this);
     // In der Wirtschaftsverwaltung dieses Gebäude jetzt zum neuen Spieler zählen und beim alten raushauen
     gwg->GetPlayer(new_owner).AddBuilding(this, bldType_);
 
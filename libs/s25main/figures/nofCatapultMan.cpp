@@ -127,7 +127,7 @@ void nofCatapultMan::HandleDerivedEvent(const unsigned /*id*/)
                 if(building->GetGOT() == GOT_NOB_MILITARY && gwg->GetPlayer(player).IsAttackable(building->GetPlayer()))
                 {
                     // Was nicht im Nebel liegt und auch schon besetzt wurde (nicht neu gebaut)?
-                    if(gwg->GetNode(building->GetPos()).fow[player].visibility == VIS_VISIBLE
+                    if(gwg->GetFoWNode(building->GetPos(), player).visibility == VIS_VISIBLE
                        && !static_cast<nobMilitary*>(building)->IsNewBuilt())
                     {
                         // Entfernung ausrechnen
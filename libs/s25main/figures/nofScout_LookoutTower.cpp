@@ -56,6 +56,7 @@ void nofScout_LookoutTower::WorkAborted()
 void nofScout_LookoutTower::WorkplaceReached()
 {
     // Im enstprechenden Radius alles sichtbar machen
+    gwg->SetObserver(*workplace, pos, VISUALRANGE_LOOKOUTTOWER, player);
     gwg->MakeVisibleAroundPoint(pos, VISUALRANGE_LOOKOUTTOWER, player);
 
     // Und Post versenden
@@ -30,7 +30,8 @@ MapNode::MapNode()
     std::fill(boundary_stones.begin(), boundary_stones.end(), 0);
 }
 
-void MapNode::Serialize(SerializedGameData& sgd, const unsigned numPlayers, const WorldDescription& desc) const
+void MapNode::Serialize(SerializedGameData& sgd, const unsigned numPlayers, const WorldDescription& desc,
+                        const NodeFoW& fow, const std::list<noBase*>& figures) const
 {
     for(PointRoad road : roads)
         sgd.PushEnum<uint8_t>(road);
@@ -55,7 +56,8 @@ void MapNode::Serialize(SerializedGameData& sgd, const unsigned numPlayers, cons
 }
 
 void MapNode::Deserialize(SerializedGameData& sgd, const unsigned numPlayers, const WorldDescription& desc,
-                          const std::vector<DescIdx<TerrainDesc>>& landscapeTerrains)
+                          const std::vector<DescIdx<TerrainDesc>>& landscapeTerrains, NodeFoW& fow,
+                          std::list<noBase*>& figures)
 {
     for(PointRoad& road : roads)
         road = sgd.Pop<PointRoad>();
@@ -33,7 +33,12 @@ class SerializedGameData;
 struct TerrainDesc;
 struct WorldDescription;
 
+/// How all players see a node in FoW
+using NodeFoW = std::array<FoWNode, MAX_PLAYERS>;
+
 /// Eigenschaften von einem Punkt auf der Map
+/// Only contains the frequently used data. FoW state and figures are stored separately in the World to keep the nodes
+/// small
 struct MapNode
 {
     /// Roads from this point: E, SE, SW
@@ -53,8 +58,6 @@ struct MapNode
     unsigned char owner;
     BoundaryStones boundary_stones;
     BuildingQuality bq;
-    /// How the players see the point in FoW
-    std::array<FoWNode, MAX_PLAYERS> fow;
 
     /// To which sea this belongs to (0=None)
     unsigned short seaId;
@@ -63,11 +66,12 @@ struct MapNode
 
     /// Objekt, welches sich dort befindet
     noBase* obj;
-    /// Figures or fights on this node
-    std::list<noBase*> figures;
 
     MapNode();
-    void Serialize(SerializedGameData& sgd, unsigned numPlayers, const WorldDescription& desc) const;
+    /// (De)Serialize the node including its FoW state and the figures on it
+    void Serialize(SerializedGameData& sgd, unsigned numPlayers, const WorldDescription& desc, const NodeFoW& fow,
+                   const std::list<noBase*>& figures) const;
     void Deserialize(SerializedGameData& sgd, unsigned numPlayers, const WorldDescription& desc,
-                     const std::vector<DescIdx<TerrainDesc>>& landscapeTerrains);
+                     const std::vector<DescIdx<TerrainDesc>>& landscapeTerrains, NodeFoW& fow,
+                     std::list<noBase*>& figures);
 };
@@ -55,9 +55,7 @@ noMovable::noMovable(SerializedGameData& sgd, const unsigned obj_id)
 void noMovable::Walk()
 {
     moving = false;
-    gwg->RemoveFigure(pos, this);
-    pos = gwg->GetNeighbour(pos, curMoveDir);
-    gwg->AddFigure(pos, this);
+    pos = gwg->MoveFigure(pos, curMoveDir, this);
 }
 
 void noMovable::FaceDir(Direction newDir)
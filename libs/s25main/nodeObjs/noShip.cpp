@@ -318,6 +318,7 @@ void noShip::HandleEvent(const unsigned id)
                 }
 
                 // Sichtbarkeiten neu berechnen
+                gwg->UpdateObserver(*this, pos);
                 gwg->RecalcVisibilitiesAroundPoint(pos, old_visual_range, ownerId_, nullptr);
 
                 break;
@@ -482,6 +483,7 @@ void noShip::StartExplorationExpedition(unsigned homeHarborId)
     home_harbor = homeHarborId;
     goal_harborId = homeHarborId; // This is current goal (commands are relative to current goal)
     // Sichtbarkeiten neu berechnen
+    gwg->UpdateObserver(*this, pos);
     gwg->MakeVisibleAroundPoint(pos, GetVisualRange(), ownerId_);
 }
 
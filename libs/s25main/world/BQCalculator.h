@@ -31,8 +31,13 @@ struct BQCalculator
 
 protected:
     virtual BlockingManner GetBM(const MapPoint& pt) const {
-        return world.GetNO(pt)->GetBM();
+        return GetNodeBM(pt);
     }
+    /// Blocking manner of the object at pt (used for the direct neighbours)
+    virtual BlockingManner GetNodeBM(const MapPoint& pt) const { return world.GetNO(pt)->GetBM(); }
+    /// Altitude of pt (changes while building sites level the ground)
+    virtual unsigned char GetAltitude(const MapPoint& pt) const { return world.GetNode(pt).altitude; }
+    virtual bool IsHarborPoint(const MapPoint& pt) const { return world.GetNode(pt).harborId != 0; }
     const World& world;
 };
 
@@ -79,13 +84,13 @@ BuildingQuality BQCalculator::operator()(const MapPoint pt, T_IsOnRoad isOnRoad,
     //////////////////////////////////////////////////////////////////////////
     // 2. Reduce BQ based on altitude
 
-    unsigned char curAltitude = world.GetNode(pt).altitude;
+    unsigned char curAltitude = GetAltitude(pt);
     // Restraints for buildings
     if(curBQ == BQ_CASTLE)
     {
         // First check the height of the (possible) buildings flag
         // flag point more than 1 higher? -> Flag
-        unsigned char otherAltitude = world.GetNeighbourNode(pt, Direction::SOUTHEAST).altitude;
+        unsigned char otherAltitude = GetAltitude(world.GetNeighbour(pt, Direction::SOUTHEAST));
         if(otherAltitude > curAltitude + 1)
             curBQ = BQ_FLAG;
         else
@@ -93,7 +98,7 @@ BuildingQuality BQCalculator::operator()(const MapPoint pt, T_IsOnRoad isOnRoad,
             // Direct neighbours: Flag for altitude diff > 3
             for(const auto dir : helpers::EnumRange<Direction>{})
             {
-                otherAltitude = world.GetNeighbourNode(pt, dir).altitude;
+                otherAltitude = GetAltitude(world.GetNeighbour(pt, dir));
                 if(safeDiff(curAltitude, otherAltitude) > 3)
                 {
                     curBQ = BQ_FLAG;
@@ -106,7 +111,7 @@ BuildingQuality BQCalculator::operator()(const MapPoint pt, T_IsOnRoad isOnRoad,
                 // Radius-2 neighbours: Hut for altitude diff > 2
                 for(unsigned i = 0; i < 12; ++i)
                 {
-                    otherAltitude = world.GetNode(world.GetNeighbour2(pt, i)).altitude;
+                    otherAltitude = GetAltitude(world.GetNeighbour2(pt, i));
                     if(safeDiff(curAltitude, otherAltitude) > 2)
                     {
                         curBQ = BQ_HUT;
@@ -116,7 +121,7 @@ BuildingQuality BQCalculator::operator()(const MapPoint pt, T_IsOnRoad isOnRoad,
             }
         }
 
-    } else if(curBQ == BQ_MINE && world.GetNeighbourNode(pt, Direction::SOUTHEAST).altitude > curAltitude + 3)
+    } else if(curBQ == BQ_MINE && GetAltitude(world.GetNeighbour(pt, Direction::SOUTHEAST)) > curAltitude + 3)
     {
         // Mines only possible till altitude diff of 3
         curBQ = BQ_FLAG;
@@ -128,7 +133,7 @@ BuildingQuality BQCalculator::operator()(const MapPoint pt, T_IsOnRoad isOnRoad,
     // Blocking manners of neighbours (cache for reuse)
     helpers::EnumArray<BlockingManner, Direction> neighbourBlocks;
     for(const auto dir : helpers::EnumRange<Direction>{})
-        neighbourBlocks[dir] = world.GetNO(world.GetNeighbour(pt, dir))->GetBM();
+        neighbourBlocks[dir] = GetNodeBM(world.GetNeighbour(pt, dir));
 
     // Don't build anything around charburner piles
     for(const auto dir : helpers::EnumRange<Direction>{})
@@ -241,7 +246,7 @@ BuildingQuality BQCalculator::operator()(const MapPoint pt, T_IsOnRoad isOnRoad,
     }
 
     // If we can build a castle and this is a harbor point -> Allow harbor
-    if(curBQ == BQ_CASTLE && world.GetNode(pt).harborId)
+    if(curBQ == BQ_CASTLE && IsHarborPoint(pt))
         curBQ = BQ_HARBOR;
 
     //////////////////////////////////////////////////////////////////////////
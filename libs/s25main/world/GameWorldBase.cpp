@@ -24,6 +24,8 @@
 #include "addons/const_addons.h"
 #include "buildings/nobHarborBuilding.h"
 #include "buildings/nobMilitary.h"
+#include "buildings/noBuildingSite.h"
+#include "buildings/nobUsual.h"
 #include "figures/nofPassiveSoldier.h"
 #include "helpers/containerUtils.h"
 #include "lua/LuaInterfaceGame.h"
@@ -31,9 +33,12 @@
 #include "notifications/PlayerNodeNote.h"
 #include "pathfinding/FreePathFinder.h"
 #include "pathfinding/RoadPathFinder.h"
+#include "nodeObjs/noFighting.h"
 #include "nodeObjs/noFlag.h"
+#include "nodeObjs/noShip.h"
 #include "gameData/BuildingProperties.h"
 #include "gameData/GameConsts.h"
+#include "gameData/MilitaryConsts.h"
 #include "gameData/TerrainDesc.h"
 #include <utility>
 #include <boost/lambda/lambda.hpp>
@@ -52,12 +57,16 @@ void GameWorldBase::Init(const MapExtent& mapSize, DescIdx<LandscapeDesc> lt)
     BuildingProperties::Init();
     World::Init(mapSize, lt);
     freePathFinder->Init(mapSize);
+    observers.Init(*this, GetNumPlayers());
+    territoryInfluence.Init(*this);
 }
 
 void GameWorldBase::InitAfterLoad()
 {
     RTTR_FOREACH_PT(MapPoint, GetSize())
         RecalcBQ(pt);
+    RecalcObservers();
+    RecalcTerritoryClaims();
 }
 
 GamePlayer& GameWorldBase::GetPlayer(const unsigned id)
@@ -291,6 +300,127 @@ void GameWorldBase::VisibilityChanged(const MapPoint pt, unsigned player, Visibi
     GetNotifications().publish(PlayerNodeNote(PlayerNodeNote::Visibility, pt, player));
 }
 
+void GameWorldBase::FigureAdded(const MapPoint pt, const noBase& fig)
+{
+    UpdateObserver(fig, pt);
+}
+
+void GameWorldBase::FigureRemoved(const noBase& fig)
+{
+    RemoveObserver(fig);
+}
+
+void GameWorldBase::UpdateObserver(const noBase& obj, const MapPoint pt)
+{
+    unsigned playerMask;
+    const unsigned radius = GetVisualRange(obj, playerMask);
+    observers.Set(obj, pt, radius, playerMask);
+}
+
+void GameWorldBase::SetObserver(const noBase& obj, const MapPoint pt, const unsigned radius, const unsigned char player)
+{
+    observers.Set(obj, pt, radius, 1u << player);
+}
+
+void GameWorldBase::RemoveObserver(const noBase& obj)
+{
+    observers.Remove(obj);
+}
+
+void GameWorldBase::UpdateTerritoryClaim(const noBaseBuilding& building)
+{
+    unsigned radius = building.GetMilitaryRadius();
+    // Same rules as TerritoryRegion::CalcTerritoryOfBuilding
+    if(building.GetGOT() == GOT_NOB_MILITARY && static_cast<const nobMilitary&>(building).IsNewBuilt())
+        radius = 0;
+    territoryInfluence.Set(building.GetObjId(), building.GetPos(), radius, building.GetPlayer(),
+                           building.GetGOT() == GOT_BUILDINGSITE);
+}
+
+void GameWorldBase::RemoveTerritoryClaim(const noBaseBuilding& building)
+{
+    territoryInfluence.Remove(building.GetObjId());
+}
+
+unsigned GameWorldBase::GetVisualRange(const noBase& obj, unsigned& playerMask) const
+{
+    playerMask = 0;
+    switch(obj.GetGOT())
+    {
+        // Scouts and soldiers only see while they are on the map
+        case GOT_NOF_SCOUT_FREE:
+            playerMask = 1u << static_cast<const noFigure&>(obj).GetPlayer();
+            return VISUALRANGE_SCOUT;
+        case GOT_NOF_ATTACKER:
+        case GOT_NOF_AGGRESSIVEDEFENDER:
+            playerMask = 1u << static_cast<const noFigure&>(obj).GetPlayer();
+            return VISUALRANGE_SOLDIER;
+        case GOT_FIGHTING:
+            for(unsigned i = 0; i < GetNumPlayers(); ++i)
+            {
+                if(static_cast<const noFighting&>(obj).IsSoldierOfPlayer(i))
+                    playerMask |= 1u << i;
+            }
+            return VISUALRANGE_SOLDIER;
+        case GOT_SHIP:
+            playerMask = 1u << static_cast<const noShip&>(obj).GetPlayerId();
+            return static_cast<const noShip&>(obj).GetVisualRange();
+        case GOT_NOB_MILITARY:
+            // Not occupied yet
+            if(static_cast<const nobMilitary&>(obj).IsNewBuilt())
+                return 0;
+            playerMask = 1u << static_cast<const nobMilitary&>(obj).GetPlayer();
+            return static_cast<const nobMilitary&>(obj).GetMilitaryRadius() + VISUALRANGE_MILITARY;
+        case GOT_NOB_HQ:
+        case GOT_NOB_HARBORBUILDING:
+            playerMask = 1u << static_cast<const nobBaseMilitary&>(obj).GetPlayer();
+            return static_cast<const nobBaseMilitary&>(obj).GetMilitaryRadius() + VISUALRANGE_MILITARY;
+        case GOT_BUILDINGSITE:
+            if(!helpers::contains(harbor_building_sites_from_sea, &obj))
+                return 0;
+            playerMask = 1u << static_cast<const noBuildingSite&>(obj).GetPlayer();
+            return HARBOR_RADIUS + VISUALRANGE_MILITARY;
+        case GOT_NOB_USUAL:
+        {
+            const auto& bld = static_cast<const nobUsual&>(obj);
+            if(bld.GetBuildingType() != BLD_LOOKOUTTOWER || !bld.HasWorker())
+                return 0;
+            playerMask = 1u << bld.GetPlayer();
+            return VISUALRANGE_LOOKOUTTOWER;
+        }
+        default: return 0;
+    }
+}
+
+void GameWorldBase::RecalcObservers()
+{
+    observers.Clear();
+    RTTR_FOREACH_PT(MapPoint, GetSize())
+    {
+        const MapNode& node = GetNode(pt);
+        if(node.obj)
+            UpdateObserver(*node.obj, pt);
+        for(const noBase* figure : GetFigures(pt))
+            UpdateObserver(*figure, pt);
+    }
+}
+
+void GameWorldBase::RecalcTerritoryClaims()
+{
+    territoryInfluence.Clear();
+    RTTR_FOREACH_PT(MapPoint, GetSize())
+    {
+        const noBase* obj = GetNode(pt).obj;
+        if(!obj)
+            continue;
+        const GO_Type got = obj->GetGOT();
+        if(got == GOT_NOB_MILITARY || got == GOT_NOB_HQ || got == GOT_NOB_HARBORBUILDING)
+            UpdateTerritoryClaim(static_cast<const noBaseBuilding&>(*obj));
+    }
+    for(const noBuildingSite* bldSite : harbor_building_sites_from_sea)
+        UpdateTerritoryClaim(*bldSite);
+}
+
 /// Verändert die Höhe eines Punktes und die damit verbundenen Schatten
 void GameWorldBase::AltitudeChanged(const MapPoint pt)
 {
@@ -316,8 +446,7 @@ void GameWorldBase::RecalcBQAroundPointBig(const MapPoint pt)
 
 Visibility GameWorldBase::CalcVisiblityWithAllies(const MapPoint pt, const unsigned char player) const
 {
-    const MapNode& node = GetNode(pt);
-    Visibility best_visibility = node.fow[player].visibility;
+    Visibility best_visibility = GetFoWNode(pt, player).visibility;
 
     if(best_visibility == VIS_VISIBLE)
         return best_visibility;
@@ -331,8 +460,9 @@ Visibility GameWorldBase::CalcVisiblityWithAllies(const MapPoint pt, const unsig
         {
             if(i != player && curPlayer.IsAlly(i))
             {
-                if(node.fow[i].visibility > best_visibility)
-                    best_visibility = node.fow[i].visibility;
+                const Visibility allyVisibility = GetFoWNode(pt, i).visibility;
+                if(allyVisibility > best_visibility)
+                    best_visibility = allyVisibility;
             }
         }
     }
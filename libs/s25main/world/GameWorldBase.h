@@ -23,8 +23,11 @@
 #include "lua/LuaInterfaceGame.h"
 #include "notifications/NotificationManager.h"
 #include "postSystem/PostManager.h"
+#include "world/ObserverMap.h"
+#include "world/TerritoryInfluence.h"
 #include "world/World.h"
 #include <memory>
+#include <utility>
 #include <vector>
 
 class EventManager;
@@ -68,12 +71,16 @@ class GameWorldBase : public World
     const GlobalGameSettings& gameSettings;
     EventManager& em;
     std::unique_ptr<LuaInterfaceGame> lua;
+    /// Objects that currently see nodes for each player
+    ObserverMap observers;
 
 protected:
     /// Interface zum GUI
     GameInterface* gi;
     /// harbor building sites created by ships
     std::list<noBuildingSite*> harbor_building_sites_from_sea;
+    /// Nodes claimed by military buildings and harbor building sites
+    TerritoryInfluence territoryInfluence;
 
 public:
     GameWorldBase(std::vector<GamePlayer> players, const GlobalGameSettings& gameSettings, EventManager& em);
@@ -81,7 +88,7 @@ public:
 
     // Grundlegende Initialisierungen
     void Init(const MapExtent& mapSize, DescIdx<LandscapeDesc> lt = DescIdx<LandscapeDesc>(0)) override;
-    // Remaining initialization after loading (BQ...)
+    // Remaining initialization after loading (BQ, observers, territory claims...)
     void InitAfterLoad();
 
     /// Setzt GameInterface
@@ -109,6 +116,18 @@ public:
     /// Erstellt eine Liste mit allen Milit�rgeb�uden in der Umgebung, radius bestimmt wie viele K�stchen nach einer
     /// Richtung im Umkreis
     sortedMilitaryBlds LookForMilitaryBuildings(MapPoint pt, unsigned short radius) const;
+    /// Call func for every military building of the players in playerMask (bit i = player i) in the same area as
+    /// LookForMilitaryBuildings. The buildings are visited in no specific order but without creating a list
+    template<class T_Func>
+    void VisitMilitaryBuildings(MapPoint pt, unsigned short radius, unsigned playerMask, T_Func&& func) const
+    {
+        militarySquares.VisitBuildingsInRange(pt, radius, playerMask, std::forward<T_Func>(func));
+    }
+    /// Return true if any of the players in playerMask has a military building in that area
+    bool IsAnyMilitaryBuildingNear(MapPoint pt, unsigned short radius, unsigned playerMask) const
+    {
+        return militarySquares.IsAnyBuildingInRange(pt, radius, playerMask);
+    }
 
     /// Finds a path for figures. Returns first direction to walk in if found
     helpers::OptionalEnum<Direction> FindHumanPath(MapPoint start, MapPoint dest, unsigned max_route = 0xFFFFFFFF,
@@ -213,6 +232,21 @@ public:
     /// Recalculates the BQ for the given point
     void RecalcBQ(MapPoint pt);
 
+    /// Set the visual range of a building, figure or ship at the given point from its current state.
+    /// Removes it if the object does not see anything (anymore)
+    void UpdateObserver(const noBase& obj, MapPoint pt);
+    /// Let the object see all points in the radius around the point for the player
+    void SetObserver(const noBase& obj, MapPoint pt, unsigned radius, unsigned char player);
+    /// Remove the visual range of the object, e.g. because it is destroyed
+    void RemoveObserver(const noBase& obj);
+    /// Set the territory claimed by the building from its current state (none if it is not occupied yet)
+    void UpdateTerritoryClaim(const noBaseBuilding& building);
+    /// Remove the territory claimed by the building, e.g. because it is destroyed
+    void RemoveTerritoryClaim(const noBaseBuilding& building);
+    const TerritoryInfluence& GetTerritoryInfluence() const { return territoryInfluence; }
+    /// Return true if any building, figure or ship of the player currently sees the point
+    bool IsObserved(MapPoint pt, unsigned char player) const { return observers.IsObserved(pt, player); }
+
     bool HasLua() const { return lua != nullptr; }
     LuaInterfaceGame& GetLua() const { return *lua; }
     void SetLua(std::unique_ptr<LuaInterfaceGame> newLua) { lua = std::move(newLua); }
@@ -222,8 +256,16 @@ protected:
     void VisibilityChanged(MapPoint pt, unsigned player, Visibility oldVis, Visibility newVis) override;
     /// Called, when the altitude of a point was changed
     void AltitudeChanged(MapPoint pt) override;
+    void FigureAdded(MapPoint pt, const noBase& fig) override;
+    void FigureRemoved(const noBase& fig) override;
 
 private:
+    /// Return the visual range of the object and the players seeing through it (playerMask = 0 if none)
+    unsigned GetVisualRange(const noBase& obj, unsigned& playerMask) const;
+    /// Register all objects currently in the world as observers
+    void RecalcObservers();
+    /// Register the territory of all military buildings and harbor building sites currently in the world
+    void RecalcTerritoryClaims();
     /// Returns the harbor ID of the next matching harbor in the given direction (0 = None)
     /// T_IsHarborOk must be a predicate taking a harbor Id and returning a bool if the harbor is valid to return
     template<typename T_IsHarborOk>
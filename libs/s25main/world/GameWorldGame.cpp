@@ -28,7 +28,6 @@
 #include "buildings/nobUsual.h"
 #include "figures/nofAttacker.h"
 #include "figures/nofPassiveSoldier.h"
-#include "figures/nofScout_Free.h"
 #include "helpers/containerUtils.h"
 #include "lua/LuaInterfaceGame.h"
 #include "notifications/BuildingNote.h"
@@ -43,7 +42,6 @@
 #include "world/TerritoryRegion.h"
 #include "nodeObjs/noFighting.h"
 #include "nodeObjs/noFlag.h"
-#include "nodeObjs/noShip.h"
 #include "nodeObjs/noStaticObject.h"
 #include "gameData/BuildingConsts.h"
 #include "gameData/BuildingProperties.h"
@@ -52,7 +50,6 @@
 #include <algorithm>
 #include <cmath>
 #include <functional>
-#include <set>
 #include <stdexcept>
 
 inline std::vector<GamePlayer> CreatePlayers(const std::vector<PlayerInfo>& playerInfos, GameWorldGame& gwg)
@@ -418,10 +415,18 @@ void GameWorldGame::RecalcTerritory(const noBaseBuilding& building, TerritoryCha
     const unsigned militaryRadius = building.GetMilitaryRadius();
     RTTR_Assert(militaryRadius > 0u);
 
+    if(reason == TerritoryChangeReason::Destroyed)
+        RemoveTerritoryClaim(building);
+    else
+        UpdateTerritoryClaim(building);
+
     const TerritoryRegion region = CreateTerritoryRegion(building, militaryRadius + ADD_RADIUS, reason);
 
     std::vector<MapPoint> ptsWithChangedOwners;
     std::vector<int> sizeChanges(GetNumPlayers());
+    // Bounding box of the changed points (relative to region start)
+    Position changedMin(region.size);
+    Position changedMax(-1, -1);
 
     // Copy owners from territory region to map and do the bookkeeping
     RTTR_FOREACH_PT(Position, region.size)
@@ -436,13 +441,25 @@ void GameWorldGame::RecalcTerritory(const noBaseBuilding& building, TerritoryCha
 
         SetOwner(curMapPt, newOwner);
         ptsWithChangedOwners.push_back(curMapPt);
+        changedMin = elMin(changedMin, pt);
+        changedMax = elMax(changedMax, pt);
         if(newOwner != 0)
             sizeChanges[newOwner - 1]++;
         if(oldOwner != 0)
             sizeChanges[oldOwner - 1]--;
     }
 
-    std::set<MapPoint, MapPointLess> ptsHandled;
+    // Neighbours of changed points are at most 1 node outside the region. Mark the handled ones in that area
+    const Position handledStart = region.startPt - Position::all(1);
+    const Extent handledSize = elMin(region.size + Extent::all(2), Extent(GetSize()));
+    std::vector<bool> isHandled(prodOfComponents(handledSize), false);
+    const auto getHandledIdx = [this, handledStart, handledSize](const MapPoint pt) {
+        const int x = (static_cast<int>(pt.x) - handledStart.x + GetWidth()) % GetWidth();
+        const int y = (static_cast<int>(pt.y) - handledStart.y + GetHeight()) % GetHeight();
+        RTTR_Assert(static_cast<unsigned>(x) < handledSize.x && static_cast<unsigned>(y) < handledSize.y);
+        return y * handledSize.x + x;
+    };
+    std::vector<MapPoint> ptsHandled;
     // Destroy everything from old player on all nodes where the owner has changed
     for(const MapPoint& curMapPt : ptsWithChangedOwners)
     {
@@ -453,8 +470,12 @@ void GameWorldGame::RecalcTerritory(const noBaseBuilding& building, TerritoryCha
         for(Direction dir : helpers::EnumRange<Direction>{})
         {
             MapPoint neighbourPt = GetNeighbour(curMapPt, dir);
-            if(ptsHandled.insert(neighbourPt).second)
-                DestroyPlayerRests(neighbourPt, owner, &building);
+            const unsigned idx = getHandledIdx(neighbourPt);
+            if(isHandled[idx])
+                continue;
+            isHandled[idx] = true;
+            ptsHandled.push_back(neighbourPt);
+            DestroyPlayerRests(neighbourPt, owner, &building);
         }
 
         if(gi)
@@ -489,7 +510,9 @@ void GameWorldGame::RecalcTerritory(const noBaseBuilding& building, TerritoryCha
             RecalcBQ(neighbourPt);
     }
 
-    RecalcBorderStones(region.startPt, region.size);
+    // Border stones only depend on the owners of the nodes around them
+    if(!ptsWithChangedOwners.empty())
+        RecalcBorderStones(region.startPt + changedMin, Extent(changedMax - changedMin) + Extent(1, 1));
 
     // Recalc visibilities if building was destroyed
     // Otherwise just set everything to visible
@@ -497,7 +520,10 @@ void GameWorldGame::RecalcTerritory(const noBaseBuilding& building, TerritoryCha
     if(reason == TerritoryChangeReason::Destroyed)
         RecalcVisibilitiesAroundPoint(building.GetPos(), visualRadius, building.GetPlayer(), &building);
     else
+    {
+        UpdateObserver(building, building.GetPos());
         MakeVisibleAroundPoint(building.GetPos(), visualRadius, building.GetPlayer());
+    }
 
     // Notify players
     for(unsigned i = 0; i < GetNumPlayers(); ++i)
@@ -579,25 +605,31 @@ TerritoryRegion GameWorldGame::CreateTerritoryRegion(const noBaseBuilding& build
     const Extent size = elMin(2u * radius2D + Extent(1, 1), Extent(GetSize()));
     TerritoryRegion region(startPt, size, *this);
 
-    // Alle Gebäude ihr Terrain in der Nähe neu berechnen
-    sortedMilitaryBlds buildings = LookForMilitaryBuildings(bldPos, 3);
-    for(const nobBaseMilitary* milBld : buildings)
-    {
-        if(!(reason == TerritoryChangeReason::Destroyed && milBld == &building))
-            region.CalcTerritoryOfBuilding(*milBld);
-    }
-
-    // Baustellen von Häfen mit einschließen
-    for(const noBuildingSite* bldSite : harbor_building_sites_from_sea)
-    {
-        if(!(reason == TerritoryChangeReason::Destroyed && bldSite == &building))
-            region.CalcTerritoryOfBuilding(*bldSite);
-    }
+    // Take the owners from the claims of all buildings in the area (military buildings and harbor building sites)
+    const noBaseBuilding* excludedBld = (reason == TerritoryChangeReason::Destroyed) ? &building : nullptr;
+    RTTR_FOREACH_PT(Position, region.size)
+        region.SetOwner(pt, GetTerritoryOwner(MakeMapPoint(pt + region.startPt), excludedBld));
     CleanTerritoryRegion(region, reason, building);
 
     return region;
 }
 
+uint8_t GameWorldGame::GetTerritoryOwner(const MapPoint pt, const noBaseBuilding* excludedBld) const
+{
+    // Claims are ordered like TerritoryRegion::CalcTerritoryOfBuilding would add them, so the first valid one wins
+    for(const TerritoryInfluence::Claim& claim : territoryInfluence.GetClaims(pt))
+    {
+        if(excludedBld && claim.objId == excludedBld->GetObjId())
+            continue;
+        // The building position itself is always owned, even outside the allowed area
+        const std::vector<MapPoint>& allowedArea = GetPlayer(claim.player).GetRestrictedArea();
+        if(claim.radius > 0u && !allowedArea.empty() && !TerritoryRegion::IsPointValid(GetSize(), allowedArea, pt))
+            continue;
+        return claim.player + 1;
+    }
+    return 0;
+}
+
 void GameWorldGame::CleanTerritoryRegion(TerritoryRegion& region, TerritoryChangeReason reason,
                                          const noBaseBuilding& triggerBld) const
 {
@@ -1057,125 +1089,13 @@ bool GameWorldGame::ValidPointForFighting(const MapPoint pt, const bool avoid_mi
     return bm == BlockingManner::None || bm == BlockingManner::Tree || bm == BlockingManner::Flag;
 }
 
-bool GameWorldGame::IsPointCompletelyVisible(const MapPoint& pt, unsigned char player,
-                                             const noBaseBuilding* exception) const
-{
-    sortedMilitaryBlds buildings = LookForMilitaryBuildings(pt, 3);
-
-    // Sichtbereich von Militärgebäuden
-    for(const nobBaseMilitary* milBld : buildings)
-    {
-        if(milBld->GetPlayer() == player && milBld != exception)
-        {
-            // Prüfen, obs auch unbesetzt ist
-            if(milBld->GetGOT() == GOT_NOB_MILITARY)
-            {
-                if(static_cast<const nobMilitary*>(milBld)->IsNewBuilt())
-                    continue;
-            }
-
-            if(CalcDistance(pt, milBld->GetPos()) <= unsigned(milBld->GetMilitaryRadius() + VISUALRANGE_MILITARY))
-                return true;
-        }
-    }
-
-    // Sichtbereich von Hafenbaustellen
-    for(const noBuildingSite* bldSite : harbor_building_sites_from_sea)
-    {
-        if(bldSite->GetPlayer() == player && bldSite != exception)
-        {
-            if(CalcDistance(pt, bldSite->GetPos()) <= unsigned(HARBOR_RADIUS + VISUALRANGE_MILITARY))
-                return true;
-        }
-    }
-
-    // Sichtbereich von Spähtürmen
-    for(const nobUsual* bld : GetPlayer(player).GetBuildingRegister().GetBuildings(BLD_LOOKOUTTOWER)) //-V807
-    {
-        // Ist Späturm überhaupt besetzt?
-        if(!bld->HasWorker())
-            continue;
-
-        // Nicht die Ausnahme wählen
-        if(bld == exception)
-            continue;
-
-        // Liegt Spähturm innerhalb des Sichtradius?
-        if(CalcDistance(pt, bld->GetPos()) <= VISUALRANGE_LOOKOUTTOWER)
-            return true;
-    }
-
-    // Check scouts and soldiers
-    const unsigned range = std::max(VISUALRANGE_SCOUT, VISUALRANGE_SOLDIER);
-    if(CheckPointsInRadius(
-         pt, range,
-         [this, player](auto pt, auto distance) { return this->IsScoutingFigureOnNode(pt, player, distance); }, true))
-    {
-        return true;
-    }
-    return IsPointScoutedByShip(pt, player);
-}
-
-bool GameWorldGame::IsScoutingFigureOnNode(const MapPoint& pt, unsigned player, unsigned distance) const
-{
-    static_assert(VISUALRANGE_SCOUT >= VISUALRANGE_SOLDIER, "Visual range changed. Check loop below!");
-
-    // Späher/Soldaten in der Nähe prüfen und direkt auf dem Punkt
-    for(noBase* obj : GetFigures(pt))
-    {
-        const GO_Type got = obj->GetGOT();
-        // Check for scout. Note: no need to check for distance as scouts have higher distance than soldiers
-        if(got == GOT_NOF_SCOUT_FREE)
-        {
-            // Prüfen, ob er auch am Erkunden ist und an der Position genau und ob es vom richtigen Spieler ist
-            if(static_cast<nofScout_Free*>(obj)->GetPlayer() == player)
-                return true;
-            else
-                continue;
-        } else if(distance <= VISUALRANGE_SOLDIER)
-        {
-            // Soldaten?
-            if(got == GOT_NOF_ATTACKER || got == GOT_NOF_AGGRESSIVEDEFENDER)
-            {
-                if(static_cast<nofActiveSoldier*>(obj)->GetPlayer() == player)
-                    return true;
-            }
-            // Kämpfe (wo auch Soldaten drin sind)
-            else if(got == GOT_FIGHTING)
-            {
-                // Prüfen, ob da ein Soldat vom angegebenen Spieler dabei ist
-                if(static_cast<noFighting*>(obj)->IsSoldierOfPlayer(player))
-                    return true;
-            }
-        }
-    }
-
-    return false;
-}
-
-bool GameWorldGame::IsPointScoutedByShip(const MapPoint& pt, unsigned player) const
-{
-    const std::vector<noShip*>& ships = GetPlayer(player).GetShips();
-    for(const noShip* ship : ships)
-    {
-        unsigned shipDistance = CalcDistance(pt, ship->GetPos());
-        if(shipDistance <= ship->GetVisualRange())
-            return true;
-    }
-    return false;
-}
-
-void GameWorldGame::RecalcVisibility(const MapPoint pt, const unsigned char player,
-                                     const noBaseBuilding* const exception)
+void GameWorldGame::RecalcVisibility(const MapPoint pt, const unsigned char player)
 {
     /// Zustand davor merken
-    Visibility visibility_before = GetNode(pt).fow[player].visibility;
-
-    /// Herausfinden, ob vollständig sichtbar
-    bool visible = IsPointCompletelyVisible(pt, player, exception);
+    Visibility visibility_before = GetFoWNode(pt, player).visibility;
 
     // Vollständig sichtbar --> vollständig sichtbar logischerweise
-    if(visible)
+    if(IsObserved(pt, player))
         MakeVisible(pt, player);
     else
     {
@@ -1209,9 +1129,11 @@ void GameWorldGame::MakeVisible(const MapPoint pt, const unsigned char player)
 void GameWorldGame::RecalcVisibilitiesAroundPoint(const MapPoint pt, const MapCoord radius, const unsigned char player,
                                                   const noBaseBuilding* const exception)
 {
+    if(exception)
+        RemoveObserver(*exception);
     std::vector<MapPoint> pts = GetPointsInRadiusWithCenter(pt, radius);
     for(const MapPoint& pt : pts)
-        RecalcVisibility(pt, player, exception);
+        RecalcVisibility(pt, player);
 }
 
 /// Setzt die Sichtbarkeiten um einen Punkt auf sichtbar (aus Performancegründen Alternative zu oberem)
@@ -1243,7 +1165,7 @@ void GameWorldGame::RecalcMovingVisibilities(const MapPoint pt, const unsigned c
         // Sichtbarkeit und für FOW-Gebiet vorherigen Besitzer merken
         // (d.h. der dort  zuletzt war, als es für Spieler player sichtbar war)
         Visibility old_vis = CalcVisiblityWithAllies(tt, player);
-        unsigned char old_owner = GetNode(tt).fow[player].owner;
+        unsigned char old_owner = GetFoWNode(tt, player).owner;
         MakeVisible(tt, player);
         // Neues feindliches Gebiet entdeckt?
         // Muss vorher undaufgedeckt oder FOW gewesen sein, aber in dem Fall darf dort vorher noch kein
@@ -1266,7 +1188,7 @@ void GameWorldGame::RecalcMovingVisibilities(const MapPoint pt, const unsigned c
         // Sichtbarkeit und für FOW-Gebiet vorherigen Besitzer merken
         // (d.h. der dort  zuletzt war, als es für Spieler player sichtbar war)
         Visibility old_vis = CalcVisiblityWithAllies(tt, player);
-        unsigned char old_owner = GetNode(tt).fow[player].owner;
+        unsigned char old_owner = GetFoWNode(tt, player).owner;
         MakeVisible(tt, player);
         // Neues feindliches Gebiet entdeckt?
         // Muss vorher undaufgedeckt oder FOW gewesen sein, aber in dem Fall darf dort vorher noch kein
@@ -1288,13 +1210,13 @@ void GameWorldGame::RecalcMovingVisibilities(const MapPoint pt, const unsigned c
     for(MapCoord i = 0; i < radius + 1; ++i)
         t = GetNeighbour(t, anti_moving_dir);
 
-    RecalcVisibility(t, player, nullptr);
+    RecalcVisibility(t, player);
     tt = t;
     dir = anti_moving_dir + 2u;
     for(MapCoord i = 0; i < radius; ++i)
     {
         tt = GetNeighbour(tt, dir);
-        RecalcVisibility(tt, player, nullptr);
+        RecalcVisibility(tt, player);
     }
 
     tt = t;
@@ -1302,7 +1224,7 @@ void GameWorldGame::RecalcMovingVisibilities(const MapPoint pt, const unsigned c
     for(unsigned i = 0; i < radius; ++i)
     {
         tt = GetNeighbour(tt, dir);
-        RecalcVisibility(tt, player, nullptr);
+        RecalcVisibility(tt, player);
     }
 }
 
@@ -1408,6 +1330,7 @@ void GameWorldGame::RemoveHarborBuildingSiteFromSea(noBuildingSite* building_sit
 {
     RTTR_Assert(building_site->GetBuildingType() == BLD_HARBORBUILDING);
     harbor_building_sites_from_sea.remove(building_site);
+    RemoveTerritoryClaim(*building_site);
 }
 
 bool GameWorldGame::IsHarborBuildingSiteFromSea(const noBuildingSite* building_site) const
@@ -1434,6 +1357,11 @@ MapNode& GameWorldGame::GetNodeWriteable(const MapPoint pt)
     return GetNodeInt(pt);
 }
 
+FoWNode& GameWorldGame::GetFoWNodeWriteable(const MapPoint pt, unsigned char player)
+{
+    return GetFoWNodeInt(pt, player);
+}
+
 void GameWorldGame::VisibilityChanged(const MapPoint pt, unsigned player, Visibility oldVis, Visibility newVis)
 {
     GameWorldBase::VisibilityChanged(pt, player, oldVis, newVis);
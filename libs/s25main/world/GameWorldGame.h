@@ -50,22 +50,16 @@ class GameWorldGame : public GameWorldBase
     /// Return if there are deco-objects that can be removed when building roads
     bool HasRemovableObjForRoad(MapPoint pt) const;
 
-    bool IsPointCompletelyVisible(const MapPoint& pt, unsigned char player, const noBaseBuilding* exception) const;
-    /// Return if there is a scout (or an attacking soldier) of this player at that node with a visual range of at most
-    /// the given distance. Excludes scouting ships!
-    bool IsScoutingFigureOnNode(const MapPoint& pt, unsigned player, unsigned distance) const;
-    /// Return true, if the point is explored by any ship of the player
-    bool IsPointScoutedByShip(const MapPoint& pt, unsigned player) const;
     /// Berechnet die Sichtbarkeit eines Punktes neu für den angegebenen Spieler
-    /// exception ist ein Gebäude (Spähturm, Militärgebäude), was nicht mit in die Berechnung einbezogen
-    /// werden soll, z.b. weil es abgerissen wird
-    void RecalcVisibility(MapPoint pt, unsigned char player, const noBaseBuilding* exception);
+    void RecalcVisibility(MapPoint pt, unsigned char player);
     /// Setzt Punkt auf jeden Fall auf sichtbar
     void MakeVisible(MapPoint pt, unsigned char player);
 
     /// Creates a region with territories marked around a building with the given radius
     TerritoryRegion CreateTerritoryRegion(const noBaseBuilding& building, unsigned radius,
                                           TerritoryChangeReason reason) const;
+    /// Return the owner (player + 1, 0 = none) the claimed territory gives to the point, ignoring excludedBld
+    uint8_t GetTerritoryOwner(MapPoint pt, const noBaseBuilding* excludedBld) const;
     /// Cleans the region (removes edges of terrain and applies the allied border push addon
     void CleanTerritoryRegion(TerritoryRegion& region, TerritoryChangeReason reason,
                               const noBaseBuilding& triggerBld) const;
@@ -149,6 +143,7 @@ public:
     bool ValidPointForFighting(MapPoint pt, bool avoid_military_building_flags, nofActiveSoldier* exception = nullptr);
 
     /// Berechnet die Sichtbarkeiten neu um einen Punkt mit radius
+    /// exception ist ein Gebäude (Spähturm, Militärgebäude), das nicht mehr sehen kann, z.b. weil es abgerissen wird
     void RecalcVisibilitiesAroundPoint(MapPoint pt, MapCoord radius, unsigned char player,
                                        const noBaseBuilding* exception);
     /// Setzt die Sichtbarkeiten um einen Punkt auf sichtbar (aus Performancegründen Alternative zu oberem)
@@ -183,6 +178,8 @@ public:
 
     /// Writeable access to node. Use only for initial map setup!
     MapNode& GetNodeWriteable(MapPoint pt);
+    /// Writeable access to the FoW state of a node. Use only for initial map setup!
+    FoWNode& GetFoWNodeWriteable(MapPoint pt, unsigned char player);
     /// Recalculates where border stones should be done after a change in the given region
     void RecalcBorderStones(Position startPt, Extent areaSize);
 
@@ -98,7 +98,7 @@ void MapLoader::SetMapExplored(World& world)
         for(unsigned i = 0; i < MAX_PLAYERS; ++i)
         {
             // If we have FoW here, save it
-            if(world.GetNode(pt).fow[i].visibility == VIS_FOW)
+            if(world.GetFoWNode(pt, i).visibility == VIS_FOW)
                 world.SaveFOWNode(pt, i, 0);
         }
     }
@@ -173,7 +173,7 @@ bool MapLoader::InitNodes(const glArchivItem_Map& map, Exploration exploration)
         }
 
         // FOW-Zeug initialisieren
-        for(auto& fow : node.fow)
+        for(auto& fow : world_.fowNodes[world_.GetIdx(pt)])
         {
             fow.last_update_time = 0;
             fow.visibility = fowVisibility;
@@ -184,7 +184,7 @@ bool MapLoader::InitNodes(const glArchivItem_Map& map, Exploration exploration)
         }
 
         node.obj = nullptr; // Will be overwritten later...
-        RTTR_Assert(node.figures.empty());
+        RTTR_Assert(world_.GetFigures(pt).empty());
     }
     return true;
 }
@@ -33,9 +33,10 @@ void MapSerializer::Serialize(const World& world, const unsigned numPlayers, Ser
     sgd.PushUnsignedInt(GameObject::GetObjIDCounter());
 
     // Alle Weltpunkte serialisieren
-    for(const auto& node : world.nodes)
+    for(unsigned idx = 0; idx < world.nodes.size(); ++idx)
     {
-        node.Serialize(sgd, numPlayers, world.GetDescription());
+        world.nodes[idx].Serialize(sgd, numPlayers, world.GetDescription(), world.fowNodes[idx],
+                                   world.nodeFigures[idx]);
     }
 
     // Katapultsteine serialisieren
@@ -109,9 +110,11 @@ void MapSerializer::Deserialize(World& world, const unsigned numPlayers, Seriali
     }
     // Alle Weltpunkte
     MapPoint curPos(0, 0);
-    for(auto& node : world.nodes)
+    for(unsigned idx = 0; idx < world.nodes.size(); ++idx)
     {
-        node.Deserialize(sgd, numPlayers, world.GetDescription(), landscapeTerrains);
+        MapNode& node = world.nodes[idx];
+        node.Deserialize(sgd, numPlayers, world.GetDescription(), landscapeTerrains, world.fowNodes[idx],
+                         world.nodeFigures[idx]);
         if(node.harborId)
         {
             HarborPos p(curPos);
@@ -17,8 +17,8 @@
 
 #include "world/MilitarySquares.h"
 #include "buildings/nobBaseMilitary.h"
-#include "helpers/containerUtils.h"
 #include "gameData/MilitaryConsts.h"
+#include <algorithm>
 
 MilitarySquares::MilitarySquares() : size_(MapExtent::all(0)) {}
 
@@ -37,60 +37,73 @@ void MilitarySquares::Clear()
     size_ = MapExtent::all(0);
 }
 
-std::list<nobBaseMilitary*>& MilitarySquares::GetSquare(const MapPoint pt)
+MilitarySquares::Square& MilitarySquares::GetSquare(const MapPoint pt)
 {
-    MapPoint milPt = pt / MILITARY_SQUARE_SIZE;
+    const Position milPt = GetSquarePos(pt);
     return squares[milPt.y * size_.x + milPt.x];
 }
 
-void MilitarySquares::Add(nobBaseMilitary* const bld)
+Position MilitarySquares::GetSquarePos(const MapPoint pt) const
 {
-    GetSquare(bld->GetPos()).push_back(bld);
+    return Position(pt / MILITARY_SQUARE_SIZE);
 }
 
-void MilitarySquares::Remove(nobBaseMilitary* const bld)
+void MilitarySquares::UpdatePlayerMask(Square& square)
 {
-    RTTR_Assert(helpers::contains(GetSquare(bld->GetPos()), bld));
-    GetSquare(bld->GetPos()).remove(bld);
+    square.playerMask = 0;
+    for(const Entry& entry : square.entries)
+        square.playerMask |= 1u << entry.player;
 }
 
-sortedMilitaryBlds MilitarySquares::GetBuildingsInRange(const MapPoint pt, unsigned short radius) const
+void MilitarySquares::Add(nobBaseMilitary* const bld)
 {
-    // maximum radius is half the size (rounded up) to avoid overlapping
-    const Position offsets = elMin((size_ + Position::all(1)) / 2, Position::all(radius));
-
-    // Convert to military coords
-    const Position milPos(pt / MILITARY_SQUARE_SIZE);
-
-    const Position firstPt = milPos - offsets;
-    const Position lastPt = milPos + offsets;
+    Square& square = GetSquare(bld->GetPos());
+    RTTR_Assert(std::none_of(square.entries.begin(), square.entries.end(),
+                             [bld](const Entry& entry) { return entry.bld == bld; }));
+    square.entries.push_back(Entry{bld, bld->GetPlayer()});
+    square.playerMask |= 1u << bld->GetPlayer();
+}
 
-    // List with unique(!) military buildings
-    sortedMilitaryBlds buildings;
+void MilitarySquares::Remove(nobBaseMilitary* const bld)
+{
+    Square& square = GetSquare(bld->GetPos());
+    const auto it = std::find_if(square.entries.begin(), square.entries.end(),
+                                 [bld](const Entry& entry) { return entry.bld == bld; });
+    RTTR_Assert(it != square.entries.end());
+    if(it == square.entries.end())
+        return;
+    // Order does not matter
+    *it = square.entries.back();
+    square.entries.pop_back();
+    UpdatePlayerMask(square);
+}
 
-    // Create list
-    for(int cy = firstPt.y; cy <= lastPt.y; ++cy)
+void MilitarySquares::PlayerChanged(const nobBaseMilitary* const bld)
+{
+    Square& square = GetSquare(bld->GetPos());
+    for(Entry& entry : square.entries)
     {
-        // Handle wrap-around
-        int realY = cy;
-        if(realY < 0)
-            realY += size_.y;
-        else if(realY >= static_cast<int>(size_.y))
-            realY -= size_.y;
-        RTTR_Assert(realY >= 0 && realY < static_cast<int>(size_.y));
-        for(int cx = firstPt.x; cx <= lastPt.x; ++cx)
-        {
-            int realX = cx;
-            if(realX < 0)
-                realX += size_.x;
-            else if(realX >= static_cast<int>(size_.x))
-                realX -= size_.x;
-            RTTR_Assert(realX >= 0 && realX < static_cast<int>(size_.x));
-            const std::list<nobBaseMilitary*>& milBuildings = squares[realY * size_.x + realX];
-            for(auto* milBuilding : milBuildings)
-                buildings.insert(milBuilding);
-        }
+        if(entry.bld == bld)
+            entry.player = bld->GetPlayer();
     }
+    UpdatePlayerMask(square);
+}
+
+sortedMilitaryBlds MilitarySquares::GetBuildingsInRange(const MapPoint pt, unsigned short radius) const
+{
+    // Every square is visited once, so the buildings are unique already and only need sorting
+    std::vector<nobBaseMilitary*> unsortedBuildings;
+    VisitBuildingsInRange(pt, radius, ~0u,
+                          [&unsortedBuildings](nobBaseMilitary* bld) { unsortedBuildings.push_back(bld); });
+    std::sort(unsortedBuildings.begin(), unsortedBuildings.end(), nobBaseMilitary::Comparer());
 
+    sortedMilitaryBlds buildings;
+    buildings.insert(boost::container::ordered_unique_range, unsortedBuildings.begin(), unsortedBuildings.end());
     return buildings;
 }
+
+bool MilitarySquares::IsAnyBuildingInRange(const MapPoint pt, unsigned short radius, unsigned playerMask) const
+{
+    return CheckSquaresInRange(
+      pt, radius, [playerMask](const Square& square) { return (square.playerMask & playerMask) != 0u; });
+}
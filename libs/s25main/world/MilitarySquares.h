@@ -18,7 +18,6 @@
 #pragma once
 
 #include "gameTypes/MapCoordinates.h"
-#include <list>
 #include <vector>
 
 class nobBaseMilitary;
@@ -26,11 +25,29 @@ class sortedMilitaryBlds;
 
 class MilitarySquares
 {
-    /// military buildings (including HQs and harbors) per military square
-    std::vector<std::list<nobBaseMilitary*>> squares;
+    struct Entry
+    {
+        nobBaseMilitary* bld;
+        unsigned char player;
+    };
+    struct Square
+    {
+        /// military buildings (including HQs and harbors) in this square
+        std::vector<Entry> entries;
+        /// Bit i is set if player i has a building in this square
+        unsigned playerMask = 0;
+    };
+
+    std::vector<Square> squares;
     MapExtent size_;
     // Liefert das entsprechende Militärquadrat für einen bestimmten Punkt auf der Karte zurück (normale Koordinaten)
-    std::list<nobBaseMilitary*>& GetSquare(MapPoint pt);
+    Square& GetSquare(MapPoint pt);
+    /// Return the position of the military square containing the point
+    Position GetSquarePos(MapPoint pt) const;
+    static void UpdatePlayerMask(Square& square);
+    /// Call func for every square in the radius (each once) until it returns true. Return true if any call did
+    template<class T_Func>
+    bool CheckSquaresInRange(MapPoint pt, unsigned short radius, T_Func&& func) const;
 
 public:
     MilitarySquares();
@@ -38,5 +55,63 @@ public:
     void Clear();
     void Add(nobBaseMilitary* bld);
     void Remove(nobBaseMilitary* bld);
+    /// Has to be called when the owner of a building changed
+    void PlayerChanged(const nobBaseMilitary* bld);
+    /// Return all buildings in the given radius (in military squares) sorted by age (newest first)
     sortedMilitaryBlds GetBuildingsInRange(MapPoint pt, unsigned short radius) const;
+    /// Call func for all buildings of the players in playerMask (bit i = player i) in the radius in no specific order
+    template<class T_Func>
+    void VisitBuildingsInRange(MapPoint pt, unsigned short radius, unsigned playerMask, T_Func&& func) const;
+    /// Return true if any player in the playerMask has a building in the radius
+    bool IsAnyBuildingInRange(MapPoint pt, unsigned short radius, unsigned playerMask) const;
 };
+
+template<class T_Func>
+bool MilitarySquares::CheckSquaresInRange(const MapPoint pt, unsigned short radius, T_Func&& func) const
+{
+    // maximum radius is half the size (rounded up) to avoid overlapping
+    const Position offsets = elMin((size_ + Position::all(1)) / 2, Position::all(radius));
+    // Number of squares in each direction. Might still wrap around on the other side
+    const Position numSquares = elMin(offsets * 2 + Position::all(1), Position(size_));
+
+    // Convert to military coords
+    const Position firstPt = GetSquarePos(pt) - offsets;
+
+    for(int y = 0; y < numSquares.y; ++y)
+    {
+        // Handle wrap-around
+        int realY = firstPt.y + y;
+        if(realY < 0)
+            realY += size_.y;
+        else if(realY >= static_cast<int>(size_.y))
+            realY -= size_.y;
+        for(int x = 0; x < numSquares.x; ++x)
+        {
+            int realX = firstPt.x + x;
+            if(realX < 0)
+                realX += size_.x;
+            else if(realX >= static_cast<int>(size_.x))
+                realX -= size_.x;
+            if(func(squares[realY * size_.x + realX]))
+                return true;
+        }
+    }
+    return false;
+}
+
+template<class T_Func>
+void MilitarySquares::VisitBuildingsInRange(const MapPoint pt, unsigned short radius, unsigned playerMask,
+                                            T_Func&& func) const
+{
+    CheckSquaresInRange(pt, radius, [playerMask, &func](const Square& square) {
+        if(square.playerMask & playerMask)
+        {
+            for(const Entry& entry : square.entries)
+            {
+                if(playerMask & (1u << entry.player))
+                    func(entry.bld);
+            }
+        }
+        return false;
+    });
+}
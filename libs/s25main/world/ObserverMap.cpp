@@ -0,0 +1,145 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "world/ObserverMap.h"
+#include "helpers/EnumRange.h"
+#include "world/MapBase.h"
+#include <algorithm>
+
+ObserverMap::ObserverMap() : world_(nullptr), numPlayers_(0) {}
+
+void ObserverMap::Init(const MapBase& world, unsigned numPlayers)
+{
+    world_ = &world;
+    numPlayers_ = numPlayers;
+    counts_.clear();
+    counts_.resize(prodOfComponents(world.GetSize()) * numPlayers);
+    observers_.clear();
+}
+
+void ObserverMap::Clear()
+{
+    std::fill(counts_.begin(), counts_.end(), 0);
+    observers_.clear();
+}
+
+void ObserverMap::Set(const noBase& obj, const MapPoint pt, const unsigned radius, const unsigned playerMask)
+{
+    auto it = observers_.find(&obj);
+    if(it == observers_.end())
+    {
+        if(!playerMask)
+            return;
+        it = observers_.emplace(&obj, Observer{pt, radius, playerMask}).first;
+        ChangeArea(it->second, 1);
+        return;
+    }
+    Observer& observer = it->second;
+    if(observer.pt == pt && observer.radius == radius && observer.playerMask == playerMask)
+        return;
+    if(!playerMask)
+    {
+        Remove(obj);
+        return;
+    }
+    // Walking figures: Only update the edges
+    const MapExtent size = world_->GetSize();
+    if(observer.radius == radius && observer.playerMask == playerMask && 2 * radius + 3 <= std::min(size.x, size.y))
+    {
+        for(const auto dir : helpers::EnumRange<Direction>{})
+        {
+            if(world_->GetNeighbour(observer.pt, dir) == pt)
+            {
+                MoveToNeighbour(observer, dir);
+                return;
+            }
+        }
+    }
+    ChangeArea(observer, -1);
+    observer = Observer{pt, radius, playerMask};
+    ChangeArea(observer, 1);
+}
+
+void ObserverMap::Remove(const noBase& obj)
+{
+    const auto it = observers_.find(&obj);
+    if(it == observers_.end())
+        return;
+    ChangeArea(it->second, -1);
+    observers_.erase(it);
+}
+
+bool ObserverMap::IsObserved(const MapPoint pt, const unsigned player) const
+{
+    return GetNumObservers(pt, player) != 0u;
+}
+
+unsigned ObserverMap::GetNumObservers(const MapPoint pt, const unsigned player) const
+{
+    RTTR_Assert(player < numPlayers_);
+    return counts_[world_->GetIdx(pt) * numPlayers_ + player];
+}
+
+uint16_t& ObserverMap::GetCount(const MapPoint pt, const unsigned player)
+{
+    RTTR_Assert(player < numPlayers_);
+    return counts_[world_->GetIdx(pt) * numPlayers_ + player];
+}
+
+void ObserverMap::ChangeCount(const MapPoint pt, unsigned playerMask, const int delta)
+{
+    for(unsigned player = 0; playerMask; ++player, playerMask >>= 1)
+    {
+        if(!(playerMask & 1u))
+            continue;
+        uint16_t& count = GetCount(pt, player);
+        RTTR_Assert(delta > 0 || count > 0u);
+        RTTR_Assert(delta < 0 || count < 0xFFFF);
+        count += delta;
+    }
+}
+
+void ObserverMap::ChangeArea(const Observer& observer, const int delta)
+{
+    world_->VisitPointsInRadius(
+      observer.pt, observer.radius, [this, &observer, delta](const MapPoint pt) { ChangeCount(pt, observer.playerMask, delta); },
+      true);
+}
+
+void ObserverMap::MoveToNeighbour(Observer& observer, const Direction dir)
+{
+    // Visit the edge of the range in the given direction from the point:
+    // The corner in that direction and the 2 sides next to it
+    const auto visitEdge = [this, &observer](MapPoint pt, const Direction edgeDir, const int delta) {
+        for(unsigned i = 0; i < observer.radius; ++i)
+            pt = world_->GetNeighbour(pt, edgeDir);
+        ChangeCount(pt, observer.playerMask, delta);
+        for(const Direction sideDir : {edgeDir + 2u, edgeDir - 2u})
+        {
+            MapPoint curPt = pt;
+            for(unsigned i = 0; i < observer.radius; ++i)
+            {
+                curPt = world_->GetNeighbour(curPt, sideDir);
+                ChangeCount(curPt, observer.playerMask, delta);
+            }
+        }
+    };
+    // Trailing edge of the old range, then leading edge of the new one
+    visitEdge(observer.pt, dir + 3u, -1);
+    observer.pt = world_->GetNeighbour(observer.pt, dir);
+    visitEdge(observer.pt, dir, 1);
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "gameTypes/Direction.h"
+#include "gameTypes/MapCoordinates.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class MapBase;
+class noBase;
+
+/// Counts for every node and player the objects (buildings, scouts, soldiers, ships) that currently see the node.
+/// Every object is registered with its position and visual range, so a node is visible exactly when its count is not
+/// zero. Moving an object to a neighbour node only touches the edges of its visual range.
+class ObserverMap
+{
+    struct Observer
+    {
+        MapPoint pt;
+        unsigned radius;
+        /// Bit i is set if player i sees through this object
+        unsigned playerMask;
+    };
+
+    const MapBase* world_;
+    unsigned numPlayers_;
+    /// Number of observers per node and player
+    std::vector<uint16_t> counts_;
+    std::unordered_map<const noBase*, Observer> observers_;
+
+    uint16_t& GetCount(MapPoint pt, unsigned player);
+    /// Add delta to the counts of all points within the radius
+    void ChangeArea(const Observer& observer, int delta);
+    /// Move the observer by one node in the given direction
+    void MoveToNeighbour(Observer& observer, Direction dir);
+    void ChangeCount(MapPoint pt, unsigned playerMask, int delta);
+
+public:
+    ObserverMap();
+    void Init(const MapBase& world, unsigned numPlayers);
+    /// Remove all observers
+    void Clear();
+
+    /// Set the visual range of the object replacing the previous one (if any). No playerMask removes the object.
+    void Set(const noBase& obj, MapPoint pt, unsigned radius, unsigned playerMask);
+    void Remove(const noBase& obj);
+
+    /// Return true if the point is seen by any object of the player
+    bool IsObserved(MapPoint pt, unsigned player) const;
+    unsigned GetNumObservers(MapPoint pt, unsigned player) const;
+};
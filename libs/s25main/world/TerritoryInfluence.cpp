@@ -0,0 +1,130 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "world/TerritoryInfluence.h"
+#include "world/MapBase.h"
+#include <algorithm>
+
+TerritoryInfluence::TerritoryInfluence() : world_(nullptr) {}
+
+void TerritoryInfluence::Init(const MapBase& world)
+{
+    world_ = &world;
+    claims_.clear();
+    claims_.resize(prodOfComponents(world.GetSize()));
+    sources_.clear();
+}
+
+void TerritoryInfluence::Clear()
+{
+    for(std::vector<Claim>& claims : claims_)
+        claims.clear();
+    sources_.clear();
+}
+
+bool TerritoryInfluence::IsBefore(const Claim& lhs, const Claim& rhs)
+{
+    if(lhs.radius != rhs.radius)
+        return lhs.radius < rhs.radius;
+    // Military buildings are added newest first, harbor building sites afterwards in order of creation
+    if(lhs.fromHarborSite != rhs.fromHarborSite)
+        return rhs.fromHarborSite;
+    if(lhs.fromHarborSite)
+        return lhs.objId < rhs.objId;
+    return lhs.objId > rhs.objId;
+}
+
+template<class T_Func>
+void TerritoryInfluence::VisitArea(const Source& source, T_Func&& func) const
+{
+    func(source.pt, 0u);
+    // Same iteration as MapBase::GetPointsInRadius
+    MapPoint curStartPt = source.pt;
+    for(unsigned r = 1; r <= source.radius; ++r)
+    {
+        curStartPt = world_->GetNeighbour(curStartPt, Direction::WEST);
+        MapPoint curPt = curStartPt;
+        for(unsigned i = Direction::NORTHEAST; i < Direction::NORTHEAST + Direction::COUNT; ++i)
+        {
+            for(unsigned step = 0; step < r; ++step)
+            {
+                func(curPt, r);
+                curPt = world_->GetNeighbour(curPt, Direction(i));
+            }
+        }
+    }
+}
+
+void TerritoryInfluence::Set(const unsigned objId, const MapPoint pt, const unsigned radius, const unsigned char player,
+                             const bool fromHarborSite)
+{
+    if(radius == 0u)
+    {
+        Remove(objId);
+        return;
+    }
+    const auto it = sources_.find(objId);
+    if(it != sources_.end())
+    {
+        const Source& old = it->second;
+        if(old.pt == pt && old.radius == radius && old.player == player && old.fromHarborSite == fromHarborSite)
+            return;
+        Remove(objId);
+    }
+    const Source& source = sources_.emplace(objId, Source{pt, radius, player, fromHarborSite}).first->second;
+    VisitArea(source, [this, objId, player, fromHarborSite](const MapPoint curPt, const unsigned r) {
+        AddClaim(curPt, Claim{objId, static_cast<uint16_t>(r), player, fromHarborSite});
+    });
+}
+
+void TerritoryInfluence::Remove(const unsigned objId)
+{
+    const auto it = sources_.find(objId);
+    if(it == sources_.end())
+        return;
+    VisitArea(it->second, [this, objId](const MapPoint curPt, unsigned) { RemoveClaim(curPt, objId); });
+    sources_.erase(it);
+}
+
+const std::vector<TerritoryInfluence::Claim>& TerritoryInfluence::GetClaims(const MapPoint pt) const
+{
+    return claims_[world_->GetIdx(pt)];
+}
+
+void TerritoryInfluence::AddClaim(const MapPoint pt, const Claim& claim)
+{
+    std::vector<Claim>& claims = claims_[world_->GetIdx(pt)];
+    // On small maps the area can wrap around and reach a node twice. Keep the closer one
+    const auto itOld =
+      std::find_if(claims.begin(), claims.end(), [&claim](const Claim& cur) { return cur.objId == claim.objId; });
+    if(itOld != claims.end())
+    {
+        if(itOld->radius <= claim.radius)
+            return;
+        claims.erase(itOld);
+    }
+    claims.insert(std::upper_bound(claims.begin(), claims.end(), claim, IsBefore), claim);
+}
+
+void TerritoryInfluence::RemoveClaim(const MapPoint pt, const unsigned objId)
+{
+    std::vector<Claim>& claims = claims_[world_->GetIdx(pt)];
+    const auto it =
+      std::find_if(claims.begin(), claims.end(), [objId](const Claim& cur) { return cur.objId == objId; });
+    if(it != claims.end())
+        claims.erase(it);
+}
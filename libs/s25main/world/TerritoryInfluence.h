@@ -0,0 +1,79 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "gameTypes/MapCoordinates.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class MapBase;
+
+/// Stores for every node the military buildings (and harbor building sites) that claim it as territory.
+/// The claims of a node are kept ordered like TerritoryRegion adds them: Closer buildings first, on equal distance
+/// newer military buildings before older ones and all of them before harbor building sites (oldest first).
+/// So the owner of a node is the player of the first claim that may have territory there and only the nodes in the
+/// radius of a building have to be touched when it is added, captured or destroyed.
+class TerritoryInfluence
+{
+public:
+    struct Claim
+    {
+        /// Id of the claiming building
+        unsigned objId;
+        /// Distance of the node to the building
+        uint16_t radius;
+        uint8_t player;
+        bool fromHarborSite;
+    };
+
+    TerritoryInfluence();
+    void Init(const MapBase& world);
+    /// Remove all claims
+    void Clear();
+
+    /// Set the territory claimed by the building at pt replacing the previous one (if any). Radius 0 removes it.
+    void Set(unsigned objId, MapPoint pt, unsigned radius, unsigned char player, bool fromHarborSite);
+    void Remove(unsigned objId);
+    bool Contains(unsigned objId) const { return sources_.count(objId) != 0u; }
+
+    /// Return all claims of the node, the most important first
+    const std::vector<Claim>& GetClaims(MapPoint pt) const;
+
+private:
+    struct Source
+    {
+        MapPoint pt;
+        unsigned radius;
+        uint8_t player;
+        bool fromHarborSite;
+    };
+
+    const MapBase* world_;
+    /// Claims per node
+    std::vector<std::vector<Claim>> claims_;
+    std::unordered_map<unsigned, Source> sources_;
+
+    /// Return true if claim lhs takes precedence over rhs
+    static bool IsBefore(const Claim& lhs, const Claim& rhs);
+    void AddClaim(MapPoint pt, const Claim& claim);
+    void RemoveClaim(MapPoint pt, unsigned objId);
+    /// Call the function for every point in the radius (including the center) with the distance to the center
+    template<class T_Func>
+    void VisitArea(const Source& source, T_Func&& func) const;
+};
@@ -75,23 +75,22 @@ void World::Unload()
 
     // Objekte vernichten
     for(auto& node : nodes)
-    {
         deletePtr(node.obj);
-
-        for(auto& z : node.fow)
+    for(auto& nodeFoW : fowNodes)
+    {
+        for(auto& z : nodeFoW)
         {
             deletePtr(z.object);
         }
     }
 
     // Figuren vernichten
-    for(auto& node : nodes)
+    for(std::list<noBase*>& figures : nodeFigures)
     {
-        std::list<noBase*>& nodeFigures = node.figures;
-        for(auto& nodeFigure : nodeFigures)
-            delete nodeFigure;
+        for(auto& figure : figures)
+            delete figure;
 
-        nodeFigures.clear();
+        figures.clear();
     }
 
     catapult_stones.clear();
@@ -104,10 +103,14 @@ void World::Resize(const MapExtent& newSize)
 {
     MapBase::Resize(newSize);
     nodes.clear();
+    fowNodes.clear();
+    nodeFigures.clear();
     militarySquares.Clear();
     if(GetSize().x > 0)
     {
         nodes.resize(prodOfComponents(GetSize()));
+        fowNodes.resize(nodes.size());
+        nodeFigures.resize(nodes.size());
         militarySquares.Init(GetSize());
     }
 }
@@ -117,7 +120,7 @@ void World::AddFigure(const MapPoint pt, noBase* fig)
     if(!fig)
         return;
 
-    std::list<noBase*>& figures = GetNodeInt(pt).figures;
+    std::list<noBase*>& figures = nodeFigures[GetIdx(pt)];
     RTTR_Assert(!helpers::contains(figures, fig));
     figures.push_back(fig);
 
@@ -125,15 +128,28 @@ void World::AddFigure(const MapPoint pt, noBase* fig)
     for(const auto dir : helpers::EnumRange<Direction>{})
     {
         MapPoint nb = GetNeighbour(pt, dir);
-        RTTR_Assert(!helpers::contains(GetNode(nb).figures, fig)); // Added figure that is in surrounding?
+        RTTR_Assert(!helpers::contains(GetFigures(nb), fig)); // Added figure that is in surrounding?
     }
 #endif
+    FigureAdded(pt, *fig);
 }
 
 void World::RemoveFigure(const MapPoint pt, noBase* fig)
 {
-    RTTR_Assert(helpers::contains(GetNode(pt).figures, fig));
-    GetNodeInt(pt).figures.remove(fig);
+    RTTR_Assert(helpers::contains(GetFigures(pt), fig));
+    nodeFigures[GetIdx(pt)].remove(fig);
+    FigureRemoved(*fig);
+}
+
+MapPoint World::MoveFigure(const MapPoint pt, const Direction dir, noBase* fig)
+{
+    RTTR_Assert(helpers::contains(GetFigures(pt), fig));
+    nodeFigures[GetIdx(pt)].remove(fig);
+    const MapPoint newPt = GetNeighbour(pt, dir);
+    RTTR_Assert(!helpers::contains(GetFigures(newPt), fig));
+    nodeFigures[GetIdx(newPt)].push_back(fig);
+    FigureAdded(newPt, *fig);
+    return newPt;
 }
 
 noBase* World::GetNO(const MapPoint pt)
@@ -200,7 +216,7 @@ void World::SetReserved(const MapPoint pt, const bool reserved)
 
 void World::SetVisibility(const MapPoint pt, unsigned char player, Visibility vis, unsigned fowTime)
 {
-    FoWNode& node = GetNodeInt(pt).fow[player];
+    FoWNode& node = GetFoWNodeInt(pt, player);
     Visibility oldVis = node.visibility;
     if(oldVis == vis)
         return;
@@ -288,7 +304,7 @@ DescIdx<TerrainDesc> World::GetLeftTerrain(const MapPoint pt, Direction dir) con
 
 void World::SaveFOWNode(const MapPoint pt, const unsigned player, unsigned curTime)
 {
-    FoWNode& fow = GetNodeInt(pt).fow[player];
+    FoWNode& fow = GetFoWNodeInt(pt, player);
     fow.last_update_time = curTime;
 
     // FOW-Objekt erzeugen
@@ -375,7 +391,7 @@ PointRoad World::GetPointRoad(MapPoint pt, Direction dir) const
 PointRoad World::GetPointFOWRoad(MapPoint pt, Direction dir, const unsigned char viewing_player) const
 {
     const RoadDir rDir = toRoadDir(pt, dir);
-    return GetNode(pt).fow[viewing_player].roads[rDir];
+    return GetFoWNode(pt, viewing_player).roads[rDir];
 }
 
 void World::AddCatapultStone(CatapultStone* cs)
@@ -57,6 +57,10 @@ class World : public MapBase
 
     /// Eigenschaften von einem Punkt auf der Map
     std::vector<MapNode> nodes;
+    /// FoW state of each node. Kept out of the nodes as it is only needed for a few operations
+    std::vector<NodeFoW> fowNodes;
+    /// Figures on each node
+    std::vector<std::list<noBase*>> nodeFigures;
 
     std::vector<Sea> seas;
 
@@ -91,9 +95,13 @@ public:
     const MapNode& GetNode(MapPoint pt) const;
     /// Return the neighboring node
     const MapNode& GetNeighbourNode(MapPoint pt, Direction dir) const;
+    /// Return how the player sees the node in FoW
+    const FoWNode& GetFoWNode(MapPoint pt, unsigned char player) const;
 
     void AddFigure(MapPoint pt, noBase* fig);
     void RemoveFigure(MapPoint pt, noBase* fig);
+    /// Move a figure to the neighbouring node in the given direction and return the new position
+    MapPoint MoveFigure(MapPoint pt, Direction dir, noBase* fig);
     /// Return the NO from that point or a "nothing"-object if there is none
     noBase* GetNO(MapPoint pt);
     /// Return the NO from that point or a "nothing"-object if there is none
@@ -126,7 +134,7 @@ public:
     BuildingQuality AdjustBQ(MapPoint pt, unsigned char player, BuildingQuality nodeBQ) const;
 
     /// Return the figures currently on the node
-    const std::list<noBase*>& GetFigures(const MapPoint pt) const { return GetNode(pt).figures; }
+    const std::list<noBase*>& GetFigures(const MapPoint pt) const { return nodeFigures[GetIdx(pt)]; }
 
     /// Return a specific object or nullptr
     template<typename T>
@@ -222,11 +230,16 @@ protected:
     /// Internal method for access to nodes with write access
     MapNode& GetNodeInt(MapPoint pt);
     MapNode& GetNeighbourNodeInt(MapPoint pt, Direction dir);
+    FoWNode& GetFoWNodeInt(MapPoint pt, unsigned char player);
 
     /// Notify derived classes of changed altitude
     virtual void AltitudeChanged(MapPoint pt) = 0;
     /// Notify derived classes of changed visibility
     virtual void VisibilityChanged(MapPoint pt, unsigned player, Visibility oldVis, Visibility newVis) = 0;
+    /// Notify derived classes that a figure is now on the node (was added or moved there)
+    virtual void FigureAdded(MapPoint pt, const noBase& fig) = 0;
+    /// Notify derived classes that a figure was removed from the map
+    virtual void FigureRemoved(const noBase& fig) = 0;
     /// Sets the road for the given (road) direction
     void SetRoad(MapPoint pt, RoadDir roadDir, PointRoad type);
     BoundaryStones& GetBoundaryStones(const MapPoint pt) { return GetNodeInt(pt).boundary_stones; }
@@ -261,6 +274,16 @@ inline MapNode& World::GetNeighbourNodeInt(const MapPoint pt, Direction dir)
     return GetNodeInt(GetNeighbour(pt, dir));
 }
 
+inline const FoWNode& World::GetFoWNode(const MapPoint pt, const unsigned char player) const
+{
+    return fowNodes[GetIdx(pt)][player];
+}
+
+inline FoWNode& World::GetFoWNodeInt(const MapPoint pt, const unsigned char player)
+{
+    return fowNodes[GetIdx(pt)][player];
+}
+
 template<class T_Predicate>
 inline bool World::IsOfTerrain(const MapPoint pt, T_Predicate predicate) const
 {
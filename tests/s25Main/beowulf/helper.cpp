@@ -134,7 +134,7 @@ bool CompareBuildingsWithWorld(
 
 bool IsConnected(const MapPoint& src, const MapPoint& dst, const beowulf::World& world)
 {
-    return beowulf::FindPath(src, world, nullptr,
+    return world.GetPathFinder().FindPath(src, nullptr,
     // Condition
     [&world, src](const MapPoint& pt, Direction dir)
     {
@@ -28,6 +28,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
 #include <set>
 
 #include "helper.h"
@@ -65,8 +66,8 @@ BOOST_FIXTURE_TEST_CASE(Bergschlumpf_1vs1, WorldBergschlumpf2PL)
 
         std::vector<std::string> row;
         row.push_back(std::to_string(em.GetCurrentGF()));
-        for (std::clock_t clocks : beowulf_raw->GetWorstRuntime()) {
-            double ms = static_cast<double>(clocks) * 1000.0 / static_cast<double>(CLOCKS_PER_SEC);
+        for (const Beowulf::Runtime& runtime : beowulf_raw->GetWorstRuntime()) {
+            double ms = std::chrono::duration<double, std::milli>(runtime).count();
             row.push_back(std::to_string(ms));
         }
         table.addRow(row);
@@ -167,6 +167,38 @@ BOOST_FIXTURE_TEST_CASE(PlaceFarmsClosely, BiggerWorldWithGCExecution)
     BOOST_REQUIRE(bl.Get(farm3Point) >= BQ_CASTLE);
 }
 
+BOOST_FIXTURE_TEST_CASE(ReachabilityMatchesPathSearch, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    const beowulf::World& bw = beowulf_raw->world;
+
+    beowulf::BuildLocations bl(bw, false);
+    bl.Calculate(bw.GetHQFlag());
+
+    // Cut off a part of the territory.
+    for (const MapPoint& pt : { MapPoint(13, 3), MapPoint(14, 4), MapPoint(14, 5), MapPoint(15, 6),
+                                MapPoint(15, 7), MapPoint(16, 7), MapPoint(17, 7), MapPoint(18, 7) }) {
+        world.SetNO(pt, new noTree(pt, 0, 3));
+        bl.Update(pt, 2);
+    }
+
+    RTTR_FOREACH_PT(MapPoint, world.GetSize()) {
+        BuildingQuality bq = bl.Get(pt);
+        if (bq == BQ_NOTHING)
+            continue;
+        std::vector<std::pair<MapPoint, BuildingQuality>> tmps = { { pt, bq } };
+        BOOST_REQUIRE(bw.CanConnectBuilding(bw.GetNeighbour(pt, Direction::SOUTHEAST), bw.GetHQFlag(), false, tmps));
+    }
+
+    // A fresh calculation gives the same result.
+    beowulf::BuildLocations bl2(bw, false);
+    bl2.Calculate(bw.GetHQFlag());
+    BOOST_REQUIRE_EQUAL(bl.GetSize(), bl2.GetSize());
+    BOOST_REQUIRE_EQUAL(bl.GetSum(), bl2.GetSum());
+}
+
 void ValidateBuildLocations(
         const GameWorldGame& world,
         const Beowulf* beowulf,
@@ -83,6 +83,70 @@ BOOST_FIXTURE_TEST_CASE(PlanMultipleBuildings, BiggerWorldWithGCExecution)
     BOOST_REQUIRE(requests.front()->GetState() == Building::Finished);
 }
 
+std::vector<MapPoint> PlanBuildings(unsigned scoringThreads);
+std::vector<MapPoint> PlanBuildings(unsigned scoringThreads)
+{
+    BiggerWorldWithGCExecution fixture;
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, fixture.world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf_raw->build.Enable();
+    beowulf_raw->build.SetScoringThreads(scoringThreads);
+
+    std::vector<Building*> requests;
+    for (BuildingType type : { BLD_SAWMILL, BLD_WOODCUTTER, BLD_FORESTER, BLD_FARM, BLD_WELL, BLD_MILL, BLD_BAKERY, BLD_QUARRY }) {
+        requests.push_back(beowulf_raw->world.Create(type, Building::PlanningRequest));
+        beowulf_raw->build.Request(requests.back(), beowulf_raw->world.GetHQFlag());
+    }
+
+    Proceed([&]() { return beowulf_raw->build.GetRequestCount() == 0; }, { beowulf_raw }, fixture.em, fixture.world, 100);
+
+    std::vector<MapPoint> ret;
+    for (const Building* building : requests)
+        ret.push_back(building->GetPt());
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(ParallelScoringMatchesSerial)
+{
+    std::vector<MapPoint> serial = PlanBuildings(1);
+    BOOST_REQUIRE(std::find_if(serial.begin(), serial.end(), [](const MapPoint& pt) { return pt.isValid(); }) != serial.end());
+    BOOST_REQUIRE(serial == PlanBuildings(4));
+}
+
+BOOST_FIXTURE_TEST_CASE(ResumePlacementWithSmallBudget, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf_raw->build.Enable();
+    // Every run is exhausted by the first building.
+    beowulf_raw->SetBudget(1);
+
+    std::vector<Building*> requests;
+    for (BuildingType type : { BLD_WELL, BLD_WOODCUTTER, BLD_QUARRY }) {
+        requests.push_back(beowulf_raw->world.Create(type, Building::PlanningRequest));
+        beowulf_raw->build.Request(requests.back(), beowulf_raw->world.GetHQFlag());
+    }
+
+    // One building per run.
+    Proceed([&]() { return beowulf_raw->build.GetRequestCount() < requests.size(); }, { beowulf_raw }, em, world, 100);
+    BOOST_REQUIRE_EQUAL(beowulf_raw->build.GetRequestCount(), 2u);
+    BOOST_REQUIRE_EQUAL(std::count_if(requests.begin(), requests.end(), [](const Building* bld) { return bld->GetPt().isValid(); }), 1);
+
+    Proceed([&]() { return beowulf_raw->build.GetRequestCount() == 0; }, { beowulf_raw }, em, world, 100);
+    BOOST_REQUIRE_EQUAL(beowulf_raw->build.GetRequestCount(), 0u);
+
+    Proceed([&]() {
+        for (const Building* bld : requests)
+            if (bld->GetState() != Building::UnderConstruction)
+                return false;
+        return true;
+    }, { beowulf_raw }, em, world, 1000);
+    for (const Building* bld : requests)
+        BOOST_REQUIRE(IsConnected(bld, beowulf_raw));
+}
+
 BOOST_FIXTURE_TEST_CASE(PlanManyBuildingsStepByStep, BiggerWorldWithGCExecution)
 {
     /**
@@ -493,6 +557,40 @@ BOOST_FIXTURE_TEST_CASE(TooManyBuildings, WorldLoaded1PFixture)
     BOOST_REQUIRE(beowulf_raw->build.GetRequestCount() > 0);
 }
 
+BOOST_FIXTURE_TEST_CASE(PlanInBackground, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf_raw->build.Enable();
+    beowulf_raw->SetBackgroundPlanning(true);
+
+    std::vector<Building*> requests;
+    requests.push_back(beowulf_raw->world.Create(BLD_SAWMILL, Building::PlanningRequest));
+    requests.push_back(beowulf_raw->world.Create(BLD_WOODCUTTER, Building::PlanningRequest));
+    requests.push_back(beowulf_raw->world.Create(BLD_FORESTER, Building::PlanningRequest));
+
+    for (Building* building : requests)
+        beowulf_raw->build.Request(building, beowulf_raw->world.GetHQFlag());
+
+    // Beowulf's state may only be read while it is not planning.
+    bool planned = false;
+    Proceed([&]()
+    {
+        planned |= beowulf_raw->IsPlanning();
+        return !beowulf_raw->IsPlanning() && requests.front()->GetState() == Building::UnderConstruction;
+    }, { beowulf_raw }, em, world);
+
+    BOOST_REQUIRE(planned);
+    for (Building* building : requests) {
+        BOOST_REQUIRE(building->GetState() == Building::UnderConstruction);
+        BOOST_REQUIRE(IsConnected(building, beowulf_raw));
+    }
+
+    beowulf_raw->SetBackgroundPlanning(false);
+    BOOST_REQUIRE(!beowulf_raw->IsPlanning());
+}
+
 #endif
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -24,9 +24,13 @@
 
 #include "nodeObjs/noTree.h"
 #include "world/GameWorldBase.h"
+#include "RTTR_AssertError.h"
+
+#include <rttr/test/LogAccessor.hpp>
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <set>
 
 #include "helper.h"
@@ -49,7 +53,7 @@ BOOST_FIXTURE_TEST_CASE(FindPathEmptyMapToHQ, BiggerWorldWithGCExecution)
     MapPoint dest = beowulf_raw->world.GetBuilding(MapPoint(12, 11))->GetFlag();
 
     std::vector<Direction> route;
-    bool found = beowulf::FindPath(start, world, &route,
+    bool found = beowulf_raw->world.GetPathFinder().FindPath(start, &route,
     // Condition
     [&](const MapPoint& pt, Direction dir)
     {
@@ -90,6 +94,77 @@ BOOST_FIXTURE_TEST_CASE(FindPathEmptyMapToHQ, BiggerWorldWithGCExecution)
     BOOST_REQUIRE(beowulf_raw->world.GetRoadState(start, route[0]) == beowulf::RoadFinished);
 }
 
+BOOST_FIXTURE_TEST_CASE(PathFinderReusesBuffers, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+
+    beowulf::PathFinder& pathFinder = beowulf_raw->world.GetPathFinder();
+
+    MapPoint start(8, 3);
+    MapPoint dest(16, 7);
+
+    auto condition = [&](const MapPoint&, Direction) { return true; };
+    auto end = [&](const MapPoint& pt) { return pt == dest; };
+    auto heuristic = [&](const MapPoint& pt) { return world.CalcDistance(pt, dest); };
+    auto cost = [](const MapPoint&, Direction) { return 1; };
+
+    // Without any obstacles the route is as long as the distance.
+    std::vector<Direction> route;
+    BOOST_REQUIRE(pathFinder.FindPath(start, &route, condition, end, heuristic, cost));
+    BOOST_REQUIRE_EQUAL(route.size(), world.CalcDistance(start, dest));
+
+    MapPoint cur = start;
+    for (Direction dir : route)
+        cur = world.GetNeighbour(cur, dir);
+    BOOST_REQUIRE(cur == dest);
+
+    // A failing search must not influence the next one.
+    BOOST_REQUIRE(!pathFinder.FindPath(start, nullptr,
+                                       [](const MapPoint&, Direction) { return true; },
+                                       [](const MapPoint&) { return false; },
+                                       heuristic, cost));
+
+    std::vector<Direction> route2;
+    BOOST_REQUIRE(pathFinder.FindPath(start, &route2, condition, end, heuristic, cost));
+    BOOST_REQUIRE(route == route2);
+
+    // Expensive directions are avoided.
+    std::vector<Direction> route3;
+    BOOST_REQUIRE(pathFinder.FindPath(start, &route3, condition, end, heuristic,
+                                      [](const MapPoint&, Direction dir) { return dir == Direction::EAST ? 10 : 1; }));
+    BOOST_REQUIRE(std::find(route3.begin(), route3.end(), Direction::EAST) == route3.end());
+}
+
+BOOST_FIXTURE_TEST_CASE(PathFinderRejectsNestedSearch, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+
+    beowulf::PathFinder& pathFinder = beowulf_raw->world.GetPathFinder();
+    rttr::test::LogAccessor logAcc;
+
+    MapPoint start(8, 3);
+    MapPoint dest(16, 7);
+    auto heuristic = [&](const MapPoint& pt) { return world.CalcDistance(pt, dest); };
+    auto cost = [](const MapPoint&, Direction) { return 1; };
+
+    auto nestedSearch = [&](const MapPoint& pt, Direction)
+    {
+        return pathFinder.FindPath(pt, nullptr,
+                                   [](const MapPoint&, Direction) { return true; },
+                                   [&](const MapPoint& cur) { return cur == dest; },
+                                   heuristic, cost);
+    };
+
+    // The buffers are shared, so searching from within a callback must be caught.
+    RTTR_REQUIRE_ASSERT(pathFinder.FindPath(start, nullptr, nestedSearch,
+                                            [&](const MapPoint& pt) { return pt == dest; },
+                                            heuristic, cost));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif
@@ -0,0 +1,90 @@
+// Copyright (c) 2016 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ai/beowulf/NodeContainers.h"
+#include "ai/beowulf/Helper.h"
+#include "world/NodeMapBase.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+
+#include "helper.h"
+
+BOOST_AUTO_TEST_SUITE(BeowulfNodeContainers)
+
+#ifndef DISABLE_ALL_BEOWULF_TESTS
+
+BOOST_AUTO_TEST_CASE(StampedNodeMapClear)
+{
+    beowulf::StampedNodeMap<unsigned> map;
+    map.Resize(10);
+    map[3] = 5;
+    BOOST_REQUIRE(map.Contains(3));
+    BOOST_REQUIRE(!map.Contains(4));
+    BOOST_REQUIRE_EQUAL(*map.Find(3), 5u);
+
+    map.Clear();
+    BOOST_REQUIRE(!map.Contains(3));
+    BOOST_REQUIRE(!map.Find(3));
+    BOOST_REQUIRE_EQUAL(map[3], 0u);
+
+    beowulf::StampedNodeSet set;
+    set.Resize(10);
+    BOOST_REQUIRE(set.Insert(7));
+    BOOST_REQUIRE(!set.Insert(7));
+    set.Clear();
+    BOOST_REQUIRE(!set.Contains(7));
+}
+
+BOOST_AUTO_TEST_CASE(PointHashMapMatchesMap)
+{
+    NodeMapBase<char> world;
+    world.Resize(MapExtent(24, 22));
+    beowulf::PointHashMap<unsigned> map(world);
+    std::map<MapPoint, unsigned, beowulf::MapPointComp> expected;
+
+    // Insert and erase in an order scattering the points over the map.
+    unsigned seed = 1;
+    for (unsigned i = 0; i < 2000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const MapPoint pt(static_cast<MapCoord>((seed >> 8) % 24), static_cast<MapCoord>((seed >> 16) % 22));
+        if ((seed >> 4) % 3 == 0) {
+            BOOST_REQUIRE_EQUAL(map.erase(pt), expected.erase(pt) > 0);
+        } else {
+            map[pt] += i;
+            expected[pt] += i;
+        }
+        BOOST_REQUIRE_EQUAL(map.size(), expected.size());
+    }
+
+    for (const auto& it : expected) {
+        const unsigned* value = map.Find(it.first);
+        BOOST_REQUIRE(value);
+        BOOST_REQUIRE_EQUAL(*value, it.second);
+    }
+    size_t count = 0;
+    for (const auto& it : map) {
+        BOOST_REQUIRE(expected.count(it.first) == 1u);
+        count++;
+    }
+    BOOST_REQUIRE_EQUAL(count, expected.size());
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,13 @@
 #include "factories/AIFactory.h"
 #include "ai/beowulf/Beowulf.h"
 #include "ai/beowulf/Resources.h"
+#include "ai/beowulf/World.h"
+
+#include "nodeObjs/noAnimal.h"
+#include "nodeObjs/noTree.h"
+#include "world/GameWorldBase.h"
+
+#include <boost/test/unit_test.hpp>
 
 #include "helper.h"
 
@@ -27,8 +34,6 @@ using beowulf::Beowulf;
 
 #ifdef BEOWULF_ENABLE_ALL
 
-#include <boost/test/unit_test.hpp>
-
 typedef WorldWithGCExecution<1, 24, 22> BiggerWorldWithGCExecution;
 
 BOOST_AUTO_TEST_SUITE(BeowulfResourceMap)
@@ -46,3 +51,124 @@ BOOST_FIXTURE_TEST_CASE(Insert, BiggerWorldWithGCExecution)
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif
+
+#ifndef DISABLE_ALL_BEOWULF_TESTS
+
+BOOST_AUTO_TEST_SUITE(BeowulfResources)
+
+typedef WorldWithGCExecution<1, 24, 22> BiggerWorldWithGCExecution;
+
+unsigned CountPlantSpace(const GameWorldBase& gwb, const MapPoint& pt, unsigned radius)
+{
+    unsigned ret = 0;
+    gwb.VisitPointsInRadius(pt, radius, [&](const MapPoint& p)
+    {
+        if (gwb.IsPlantSpace(p))
+            ret += (radius + 1) - gwb.CalcDistance(pt, p);
+    }, true);
+    return ret;
+}
+
+// Plant space around 'pt' not harvested by a farm at 'farmPt'.
+unsigned CountFreePlantSpace(const GameWorldBase& gwb, const MapPoint& pt, unsigned radius, const MapPoint& farmPt)
+{
+    unsigned ret = 0;
+    gwb.VisitPointsInRadius(pt, radius, [&](const MapPoint& p)
+    {
+        bool harvested = farmPt.isValid() && p != farmPt && gwb.CalcDistance(p, farmPt) <= beowulf::FARMER_RADIUS;
+        if (gwb.IsPlantSpace(p) && !harvested)
+            ret++;
+    }, true);
+    return ret;
+}
+
+BOOST_FIXTURE_TEST_CASE(LayersFollowTheWorld, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::Resources& resources = beowulf_raw->world.resources;
+
+    const MapPoint pt(8, 5);
+    BOOST_REQUIRE_GT(resources.GetReachable(pt, beowulf::BResourcePlantSpace_6, true, true), 0u);
+    BOOST_REQUIRE_EQUAL(resources.GetReachable(pt, beowulf::BResourcePlantSpace_6, true, true),
+                        CountPlantSpace(world, pt, 6));
+
+    // Planting trees removes plant space around 'pt'.
+    for (const MapPoint& treePt : { MapPoint(8, 5), MapPoint(10, 6), MapPoint(5, 3) }) {
+        world.SetNO(treePt, new noTree(treePt, 0, 3));
+        world.RecalcBQAroundPointBig(treePt);
+    }
+    BOOST_REQUIRE_EQUAL(resources.GetReachable(pt, beowulf::BResourcePlantSpace_6, true, true),
+                        CountPlantSpace(world, pt, 6));
+    BOOST_REQUIRE_EQUAL(resources.Get(MapPoint(10, 6), beowulf::BResourcePlantSpace_6, false), 0u);
+
+    // Unweighted sums match the number of points.
+    unsigned count = 0;
+    world.VisitPointsInRadius(pt, 2, [&](const MapPoint& p) { count += world.IsPlantSpace(p) ? 1 : 0; }, true);
+    BOOST_REQUIRE_EQUAL(resources.GetReachable(pt, beowulf::BResourcePlantSpace_2, false, true), count);
+}
+
+BOOST_FIXTURE_TEST_CASE(HarvestedPoints, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::World& bw = beowulf_raw->world;
+
+    const MapPoint farmPt(8, 5);
+    const MapPoint pt(9, 5);
+    const unsigned total = CountFreePlantSpace(world, pt, 2, MapPoint::Invalid());
+    BOOST_REQUIRE_EQUAL(bw.resources.GetReachable(pt, beowulf::BResourcePlantSpace_2, false), total);
+
+    // Only points not used by the farm are counted (not all points around 'pt' are harvested).
+    bw.Plan(bw.Create(BLD_FARM, beowulf::Building::PlanningRequest), farmPt);
+    const unsigned free = CountFreePlantSpace(world, pt, 2, farmPt);
+    BOOST_REQUIRE_GT(free, 0u);
+    BOOST_REQUIRE_LT(free, total);
+    BOOST_REQUIRE_EQUAL(bw.resources.GetReachable(pt, beowulf::BResourcePlantSpace_2, false), free);
+    BOOST_REQUIRE_EQUAL(bw.resources.GetReachable(pt, beowulf::BResourcePlantSpace_2, false, true), total);
+
+    bw.ClearPlan();
+    BOOST_REQUIRE_EQUAL(bw.resources.GetReachable(pt, beowulf::BResourcePlantSpace_2, false), total);
+}
+
+BOOST_FIXTURE_TEST_CASE(ChangingResourcesAreRefreshed, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::World& bw = beowulf_raw->world;
+
+    // No notification tells about moving animals. They are recalculated on every refresh in
+    // the area of a hunter.
+    const MapPoint hunterPt(15, 7);
+    const MapPoint animalPt(14, 8);
+    bw.Plan(bw.Create(BLD_HUNTER, beowulf::Building::PlanningRequest), hunterPt);
+    BOOST_REQUIRE_EQUAL(bw.resources.Get(animalPt, beowulf::BResourceHuntableAnimals, false), 0u);
+    world.AddFigure(animalPt, new noAnimal(SPEC_DEER, animalPt));
+    bw.resources.Refresh();
+    BOOST_REQUIRE_EQUAL(bw.resources.Get(animalPt, beowulf::BResourceHuntableAnimals, false), 1u);
+    bw.ClearPlan();
+
+    // Elsewhere within one sweep over the map (S_refresh_runs).
+    const MapPoint farAnimalPt(3, 18);
+    world.AddFigure(farAnimalPt, new noAnimal(SPEC_DEER, farAnimalPt));
+    for (unsigned i = 0; i < 64; ++i)
+        bw.resources.Refresh();
+    BOOST_REQUIRE_EQUAL(bw.resources.Get(farAnimalPt, beowulf::BResourceHuntableAnimals, false), 1u);
+
+    // Trees growing in the area of a woodcutter without changing the building quality.
+    const MapPoint woodcutterPt(9, 8);
+    const MapPoint treePt(10, 10);
+    bw.Plan(bw.Create(BLD_WOODCUTTER, beowulf::Building::PlanningRequest), woodcutterPt);
+    world.SetNO(treePt, new noTree(treePt, 0, 3));
+    BOOST_REQUIRE_EQUAL(bw.resources.Get(treePt, beowulf::BResourceWood, false), 0u);
+    bw.resources.Refresh();
+    BOOST_REQUIRE_EQUAL(bw.resources.Get(treePt, beowulf::BResourceWood, false), 1u);
+    bw.ClearPlan();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -20,8 +20,11 @@
 #include "factories/AIFactory.h"
 #include "ai/beowulf/Beowulf.h"
 #include "ai/beowulf/Resources.h"
+#include "ai/beowulf/TrafficMap.h"
+#include "ai/beowulf/World.h"
 
 #include "helper.h"
+#include "helpers/containerUtils.h"
 
 using beowulf::Beowulf;
 
@@ -40,6 +43,113 @@ BOOST_FIXTURE_TEST_CASE(Connect, BiggerWorldWithGCExecution)
     beowulf_raw->DisableRecurrents();
 }
 
+BOOST_FIXTURE_TEST_CASE(ConnectToClosestNetworkFlag, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::World& buildings = beowulf_raw->world;
+
+    // Extend the HQ network to the west.
+    buildings.ConstructFlag(MapPoint(9, 12));
+    buildings.ConstructRoad(MapPoint(9, 12), { Direction::EAST, Direction::EAST, Direction::EAST, Direction::EAST });
+
+    // The new road ends at the closest flag of the network instead of the HQ flag.
+    const MapPoint flag(7, 12);
+    beowulf::Building* bld = buildings.Create(BLD_WOODCUTTER, beowulf::Building::PlanningRequest);
+    buildings.Construct(bld, world.GetNeighbour(flag, Direction::NORTHWEST));
+    BOOST_REQUIRE(beowulf_raw->roads.Connect(bld));
+    BOOST_REQUIRE(buildings.HasRoad(flag, Direction::EAST));
+    BOOST_REQUIRE(buildings.HasRoad(world.GetNeighbour(flag, Direction::EAST), Direction::EAST));
+    BOOST_REQUIRE(buildings.IsConnected(flag, buildings.GetHQFlag()));
+
+    // Connecting again does not add roads.
+    const size_t numFlags = buildings.GetFlags().size();
+    BOOST_REQUIRE(beowulf_raw->roads.Connect(bld));
+    BOOST_REQUIRE(buildings.GetFlags().size() == numFlags);
+}
+
+BOOST_FIXTURE_TEST_CASE(TrafficFlow, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::World& buildings = beowulf_raw->world;
+    const beowulf::TrafficMap& traffic = beowulf_raw->roads.GetTrafficMap();
+
+    // The stones of a quarry flow to the HQ.
+    const MapPoint flag(7, 12);
+    beowulf::Building* bld = buildings.Create(BLD_QUARRY, beowulf::Building::PlanningRequest);
+    buildings.Construct(bld, world.GetNeighbour(flag, Direction::NORTHWEST));
+    BOOST_REQUIRE(beowulf_raw->roads.Connect(bld));
+
+    std::vector<Direction> route = buildings.GetPath(flag, buildings.GetHQFlag());
+    BOOST_REQUIRE(!route.empty());
+    MapPoint cur = flag;
+    for (Direction dir : route) {
+        const MapPoint next = world.GetNeighbour(cur, dir);
+        BOOST_REQUIRE_EQUAL(traffic.GetFlow(cur, dir), 2u);
+        BOOST_REQUIRE_EQUAL(traffic.GetFlow(next, beowulf::OppositeDirection(dir)), 0u);
+        BOOST_REQUIRE_EQUAL(traffic.GetCongestion(next, beowulf::OppositeDirection(dir)), 2u);
+        BOOST_REQUIRE(helpers::contains(traffic.GetUsers(cur, dir), buildings.GetHandle(bld)));
+        cur = next;
+    }
+    BOOST_REQUIRE(traffic.GetCongestedSegments(1).size() == route.size());
+    BOOST_REQUIRE(traffic.GetCongestedSegments(2).empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(DestroyDeliveryTarget, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf_raw->roads.Enable();
+    beowulf::World& buildings = beowulf_raw->world;
+    const beowulf::TrafficMap& traffic = beowulf_raw->roads.GetTrafficMap();
+
+    // Two quarries deliver their stones to a storehouse west of the HQ.
+    const MapPoint storeFlag(7, 12);
+    beowulf::Building* store = buildings.Create(BLD_STOREHOUSE, beowulf::Building::PlanningRequest);
+    buildings.Construct(store, world.GetNeighbour(storeFlag, Direction::NORTHWEST));
+    BOOST_REQUIRE(beowulf_raw->roads.Connect(store));
+
+    const std::vector<MapPoint> quarryFlags = { MapPoint(6, 15), MapPoint(6, 8) };
+    std::vector<beowulf::Building*> quarries;
+    for (const MapPoint& flag : quarryFlags) {
+        quarries.push_back(buildings.Create(BLD_QUARRY, beowulf::Building::PlanningRequest));
+        buildings.Construct(quarries.back(), world.GetNeighbour(flag, Direction::NORTHWEST));
+        BOOST_REQUIRE(beowulf_raw->roads.Connect(quarries.back()));
+    }
+
+    Proceed([&]() {
+        if (store->GetState() != beowulf::Building::UnderConstruction)
+            return false;
+        for (const beowulf::Building* bld : quarries)
+            if (bld->GetState() != beowulf::Building::UnderConstruction)
+                return false;
+        return true;
+    }, { beowulf.get() }, em, world);
+
+    // First segment of every quarry route.
+    std::vector<Direction> firstDirs;
+    std::vector<beowulf::BuildingHandle> handles;
+    for (size_t i = 0; i < quarries.size(); ++i) {
+        std::vector<Direction> route = buildings.GetPath(quarryFlags[i], storeFlag);
+        BOOST_REQUIRE(!route.empty());
+        firstDirs.push_back(route.front());
+        handles.push_back(buildings.GetHandle(quarries[i]));
+        BOOST_REQUIRE(helpers::contains(traffic.GetUsers(quarryFlags[i], firstDirs[i]), handles[i]));
+    }
+
+    // Destroying the storehouse must not drop the routes of the quarries.
+    const MapPoint storePos = store->GetPt();
+    buildings.Deconstruct(store);
+    Proceed([&]() { return buildings.GetBuilding(storePos) == nullptr; }, { beowulf.get() }, em, world);
+
+    for (size_t i = 0; i < quarries.size(); ++i)
+        BOOST_REQUIRE(helpers::contains(traffic.GetUsers(quarryFlags[i], firstDirs[i]), handles[i]));
+}
+
 #endif
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+// Copyright (c) 2016 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ai/beowulf/ThreadPool.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "helper.h"
+
+BOOST_AUTO_TEST_SUITE(BeowulfThreadPool)
+
+#ifndef DISABLE_ALL_BEOWULF_TESTS
+
+BOOST_AUTO_TEST_CASE(RunsEveryTaskOnce)
+{
+    for (unsigned numThreads : { 1u, 4u }) {
+        beowulf::ThreadPool pool(numThreads);
+        BOOST_REQUIRE_EQUAL(pool.GetNumThreads(), numThreads);
+
+        // Boost.Test is not thread-safe. Check the results on this thread.
+        std::vector<std::atomic<unsigned>> counts(100);
+        for (std::atomic<unsigned>& count : counts)
+            count = 0;
+        std::atomic<bool> threadsValid(true);
+        pool.Run(static_cast<unsigned>(counts.size()), [&](unsigned i, unsigned thread)
+        {
+            if (thread >= numThreads)
+                threadsValid = false;
+            counts[i]++;
+        });
+        BOOST_REQUIRE(threadsValid);
+        for (const std::atomic<unsigned>& count : counts)
+            BOOST_REQUIRE_EQUAL(count.load(), 1u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TaskExceptionIsRethrown)
+{
+    for (unsigned numThreads : { 1u, 4u }) {
+        beowulf::ThreadPool pool(numThreads);
+        BOOST_REQUIRE_THROW(pool.Run(100, [](unsigned i, unsigned)
+        {
+            if (i == 42)
+                throw std::runtime_error("task failed");
+        }), std::runtime_error);
+
+        // The pool is still usable afterwards.
+        std::atomic<unsigned> count(0);
+        pool.Run(100, [&](unsigned, unsigned) { count++; });
+        BOOST_REQUIRE_EQUAL(count.load(), 100u);
+    }
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
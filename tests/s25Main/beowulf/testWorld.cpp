@@ -22,9 +22,13 @@
 #include "ai/beowulf/World.h"
 #include "ai/beowulf/Debug.h"
 #include "ai/beowulf/Types.h"
+#include "ai/beowulf/NoteQueue.h"
+#include "ai/beowulf/WorldSnapshot.h"
 
 #include "nodeObjs/noTree.h"
 #include "nodeObjs/noFlag.h"
+#include "nodeObjs/noGranite.h"
+#include "notifications/RoadNote.h"
 
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobUsual.h"
@@ -36,6 +40,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <memory> /* std::unique_ptr */
 #include <set>
 
@@ -321,6 +326,94 @@ BOOST_FIXTURE_TEST_CASE(ConstructRoad, BiggerWorldWithGCExecution)
     BOOST_REQUIRE(CompareBuildingsWithWorld(beowulf.get(), world));
 }
 
+BOOST_FIXTURE_TEST_CASE(PlanSavepoints, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::World& buildings = beowulf_raw->world;
+    const size_t numFlags = buildings.GetFlags().size();
+
+    const MapPoint firstPt(16, 13);
+    const MapPoint secondPt(10, 8);
+    const MapPoint secondFlag = world.GetNeighbour(secondPt, Direction::SOUTHEAST);
+
+    Building* bld = buildings.Create(BLD_WOODCUTTER, Building::PlanningRequest);
+    buildings.Plan(bld, firstPt);
+    buildings.PlanRoad(MapPoint(13, 12), { Direction::WEST, Direction::WEST });
+    BOOST_REQUIRE(buildings.IsConnected(MapPoint(11, 12), MapPoint(13, 12)));
+
+    // Try the building somewhere else and go back.
+    const beowulf::World::PlanSavepoint savepoint = buildings.SavePlan();
+    buildings.Plan(bld, secondPt);
+    buildings.PlanRoad(secondFlag, { Direction::SOUTHEAST, Direction::SOUTHEAST });
+    BOOST_REQUIRE(bld->GetPt() == secondPt);
+    BOOST_REQUIRE(buildings.HasFlag(secondFlag));
+    BOOST_REQUIRE(buildings.HasRoad(secondFlag, Direction::SOUTHEAST));
+
+    buildings.RollbackPlan(savepoint);
+    BOOST_REQUIRE(bld->GetPt() == firstPt);
+    BOOST_REQUIRE(buildings.GetBuilding(firstPt) == bld);
+    BOOST_REQUIRE(!buildings.HasBuilding(secondPt));
+    BOOST_REQUIRE(!buildings.HasFlag(secondFlag));
+    BOOST_REQUIRE(!buildings.HasRoad(secondFlag, Direction::SOUTHEAST));
+    BOOST_REQUIRE(buildings.IsConnected(MapPoint(11, 12), MapPoint(13, 12)));
+    BOOST_REQUIRE(buildings.IsPlanning());
+
+    // Clearing the plan undoes the rest.
+    buildings.ClearPlan();
+    BOOST_REQUIRE(!buildings.IsPlanning());
+    BOOST_REQUIRE(!buildings.HasBuilding(firstPt));
+    BOOST_REQUIRE(!buildings.HasFlag(MapPoint(11, 12)));
+    BOOST_REQUIRE(!buildings.HasRoad(MapPoint(13, 12), Direction::WEST));
+    BOOST_REQUIRE(!buildings.IsConnected(MapPoint(11, 12), MapPoint(13, 12)));
+    BOOST_REQUIRE(buildings.GetFlags().size() == numFlags);
+    buildings.Remove(bld);
+}
+
+BOOST_FIXTURE_TEST_CASE(BuildingHandles, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::World& buildings = beowulf_raw->world;
+
+    Building* bld = buildings.Create(BLD_WOODCUTTER, Building::PlanningRequest);
+    const beowulf::BuildingHandle handle = buildings.GetHandle(bld);
+    BOOST_REQUIRE(buildings.GetBuilding(handle) == bld);
+    BOOST_REQUIRE(buildings.GetBuildings(BLD_WOODCUTTER).size() == 1u);
+
+    // The slot is reused, but the old handle stays invalid.
+    buildings.Remove(bld);
+    BOOST_REQUIRE(!buildings.GetBuilding(handle));
+    Building* other = buildings.Create(BLD_QUARRY, Building::PlanningRequest);
+    BOOST_REQUIRE(!buildings.GetBuilding(handle));
+    BOOST_REQUIRE(buildings.GetBuilding(buildings.GetHandle(other)) == other);
+    BOOST_REQUIRE(buildings.GetBuildings(BLD_WOODCUTTER).empty());
+    BOOST_REQUIRE(buildings.GetBuildings(BLD_QUARRY).size() == 1u);
+    buildings.Remove(other);
+}
+
+BOOST_FIXTURE_TEST_CASE(BuildingsOfTypeInCreationOrder, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::World& buildings = beowulf_raw->world;
+
+    Building* first = buildings.Create(BLD_WOODCUTTER, Building::PlanningRequest);
+    Building* second = buildings.Create(BLD_WOODCUTTER, Building::PlanningRequest);
+
+    // The new building reuses the slot of the first one, but comes last.
+    buildings.Remove(first);
+    Building* third = buildings.Create(BLD_WOODCUTTER, Building::PlanningRequest);
+    const std::vector<Building*> expected = { second, third };
+    BOOST_REQUIRE(buildings.GetBuildings(BLD_WOODCUTTER) == expected);
+
+    buildings.Remove(second);
+    buildings.Remove(third);
+}
+
 BOOST_FIXTURE_TEST_CASE(ConstructInvalidRoad, BiggerWorldWithGCExecution)
 {
     std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
@@ -342,6 +435,43 @@ BOOST_FIXTURE_TEST_CASE(ConstructInvalidRoad, BiggerWorldWithGCExecution)
     BOOST_REQUIRE(!IsConnected(MapPoint(11, 12), MapPoint(13, 12), beowulf_raw->world));
 }
 
+BOOST_FIXTURE_TEST_CASE(RoadNetworks, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::World& buildings = beowulf_raw->world;
+
+    buildings.ConstructFlag(MapPoint(9, 12));
+    buildings.ConstructFlag(MapPoint(7, 12));
+    buildings.ConstructRoad(MapPoint(7, 12), { Direction::EAST, Direction::EAST });
+    BOOST_REQUIRE(buildings.IsConnected(MapPoint(7, 12), MapPoint(9, 12)));
+    BOOST_REQUIRE(!buildings.IsConnected(MapPoint(9, 12), MapPoint(13, 12)));
+    BOOST_REQUIRE(buildings.GetRoadNetwork(MapPoint(10, 8)) == beowulf::RoadNetworks::InvalidNetwork);
+
+    // Planned roads join networks until the plan is cleared.
+    buildings.PlanRoad(MapPoint(9, 12), { Direction::EAST, Direction::EAST, Direction::EAST, Direction::EAST });
+    BOOST_REQUIRE(buildings.IsConnected(MapPoint(7, 12), MapPoint(13, 12)));
+    BOOST_REQUIRE(buildings.GetRoadNetwork(MapPoint(11, 12)) == buildings.GetRoadNetwork(MapPoint(13, 12)));
+
+    buildings.ClearPlan();
+    BOOST_REQUIRE(buildings.IsConnected(MapPoint(7, 12), MapPoint(9, 12)));
+    BOOST_REQUIRE(!buildings.IsConnected(MapPoint(9, 12), MapPoint(13, 12)));
+    BOOST_REQUIRE(buildings.GetRoadNetwork(MapPoint(11, 12)) == beowulf::RoadNetworks::InvalidNetwork);
+
+    // The index agrees with a path search.
+    buildings.ConstructRoad(MapPoint(9, 12), { Direction::EAST, Direction::EAST, Direction::EAST, Direction::EAST });
+    buildings.DeconstructRoad(MapPoint(7, 12), { Direction::EAST, Direction::EAST });
+    for (const MapPoint& pt : { MapPoint(7, 12), MapPoint(9, 12), MapPoint(11, 12) }) {
+        BOOST_REQUIRE_EQUAL(buildings.IsConnected(pt, MapPoint(13, 12)),
+                            IsConnected(pt, MapPoint(13, 12), buildings));
+    }
+    BOOST_REQUIRE(!buildings.IsConnected(MapPoint(7, 12), MapPoint(9, 12)));
+
+    Proceed({ beowulf.get() }, em,  world);
+    BOOST_REQUIRE(CompareBuildingsWithWorld(beowulf.get(), world));
+}
+
 BOOST_FIXTURE_TEST_CASE(IsRoadPossible, BiggerWorldWithGCExecution)
 {
     std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
@@ -387,6 +517,51 @@ BOOST_FIXTURE_TEST_CASE(NewBuildingsAreAssignedToProductionGroups, BiggerWorldWi
     BOOST_REQUIRE(CompareBuildingsWithWorld(beowulf.get(), world));
 }
 
+BOOST_FIXTURE_TEST_CASE(BuildingIndex, EvenBiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::World& buildings = beowulf_raw->world;
+
+    // Spread some buildings over the map (including the borders to check wrap-around).
+    std::vector<Building*> farms;
+    for (const MapPoint& pt : { MapPoint(0, 0), MapPoint(43, 20), MapPoint(5, 41), MapPoint(30, 30), MapPoint(20, 5) })
+        farms.push_back(buildings.Create(BLD_FARM, Building::Finished, InvalidProductionGroup, pt));
+    Building* quarry = buildings.Create(BLD_QUARRY, Building::Finished, InvalidProductionGroup, MapPoint(22, 22));
+    buildings.SetPoint(farms.back(), MapPoint(21, 6));
+
+    RTTR_FOREACH_PT(MapPoint, world.GetSize()) {
+        unsigned best = std::numeric_limits<unsigned>::max();
+        unsigned inRadius = 0;
+        for (const Building* farm : farms) {
+            unsigned dist = world.CalcDistance(pt, farm->GetPt());
+            best = std::min(best, dist);
+            if (dist <= 10)
+                inRadius++;
+        }
+
+        auto nearest = buildings.GetNearestBuilding(pt, { BLD_FARM });
+        BOOST_REQUIRE_EQUAL(nearest.second, best);
+        BOOST_REQUIRE_EQUAL(world.CalcDistance(pt, nearest.first), best);
+        BOOST_REQUIRE_EQUAL(buildings.GetBuildingIndex().GetInRadius(pt, BLD_FARM, 10).size(), inRadius);
+
+        std::vector<const Building*> closest = buildings.GetBuildingIndex().GetNearest(pt, BLD_FARM, 3);
+        BOOST_REQUIRE_EQUAL(closest.size(), 3u);
+        BOOST_REQUIRE(closest.front()->GetPt() == nearest.first);
+        for (size_t i = 1; i < closest.size(); ++i)
+            BOOST_REQUIRE_LE(closest[i - 1]->GetDistance(pt), closest[i]->GetDistance(pt));
+    }
+
+    // 'self' and other types are skipped.
+    BOOST_REQUIRE_EQUAL(buildings.GetNearestBuilding(MapPoint(22, 22), { BLD_QUARRY }, quarry).second,
+                        std::numeric_limits<unsigned>::max());
+    BOOST_REQUIRE(buildings.GetNearestBuilding(MapPoint(22, 22), { BLD_QUARRY, BLD_FARM }).first == MapPoint(22, 22));
+
+    buildings.Remove(quarry);
+    BOOST_REQUIRE(!buildings.GetNearestBuilding(MapPoint(22, 22), { BLD_QUARRY }).first.isValid());
+}
+
 BOOST_FIXTURE_TEST_CASE(IsRoadPossibleOnlyInsideTerritory, BiggerWorldWithGCExecution)
 {
     std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
@@ -398,6 +573,46 @@ BOOST_FIXTURE_TEST_CASE(IsRoadPossibleOnlyInsideTerritory, BiggerWorldWithGCExec
     BOOST_REQUIRE(!beowulf_raw->world.IsRoadPossible({ 2, 10}, Direction::EAST, true));
 }
 
+BOOST_FIXTURE_TEST_CASE(CachedBQMatchesRecalculation, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+
+    // A new Beowulf has an empty cache and calculates all BQs again.
+    auto compareWithNewBeowulf = [&]()
+    {
+        std::unique_ptr<AIPlayer> other(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+        Beowulf* other_raw = static_cast<Beowulf*>(other.get());
+        other_raw->DisableRecurrents();
+        RTTR_FOREACH_PT(MapPoint, world.GetSize()) {
+            BOOST_REQUIRE(beowulf_raw->world.GetBQ(pt, false) == other_raw->world.GetBQ(pt, false));
+            BOOST_REQUIRE(beowulf_raw->world.GetBQ(pt, true) == other_raw->world.GetBQ(pt, true));
+        }
+    };
+    compareWithNewBeowulf();
+
+    // Planned buildings change the cached BQs until the plan is cleared.
+    Building* fortress = beowulf_raw->world.Create(BLD_FORTRESS, Building::PlanningRequest);
+    Building* barracks = beowulf_raw->world.Create(BLD_BARRACKS, Building::PlanningRequest);
+    beowulf_raw->world.Plan(fortress, { 10, 11 });
+    beowulf_raw->world.Plan(barracks, { 10, 5 });
+    BOOST_REQUIRE(beowulf_raw->world.GetBQ({ 10, 11 }, true) == BQ_NOTHING);
+    BOOST_REQUIRE(beowulf_raw->world.GetBQ({ 10, 5 }, true) == BQ_NOTHING);
+    beowulf_raw->world.ClearPlan();
+    beowulf_raw->world.Remove(fortress);
+    beowulf_raw->world.Remove(barracks);
+    compareWithNewBeowulf();
+
+    // Constructed buildings and roads as well as the new territory.
+    Building* building = beowulf_raw->world.Create(BLD_BARRACKS, Building::PlanningRequest);
+    beowulf_raw->world.Construct(building, { 10, 5 });
+    beowulf_raw->world.ConstructRoad({ 11, 6 }, { Direction::SOUTHWEST, Direction::SOUTHWEST, Direction::SOUTHWEST, Direction::SOUTHEAST, Direction::SOUTHEAST, Direction::SOUTHEAST, Direction::EAST, Direction::EAST });
+    Proceed([&](){ return building->GetCaptured(); }, { beowulf.get() }, em, world);
+    BOOST_REQUIRE(building->GetCaptured());
+    compareWithNewBeowulf();
+}
+
 BOOST_FIXTURE_TEST_CASE(NewMilitaryBuilding, BiggerWorldWithGCExecution)
 {
     std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
@@ -714,6 +929,195 @@ BOOST_FIXTURE_TEST_CASE(MultipleEnemyBuildingsAdditionalTerritory, EmptyWorldFix
     Proceed([&](){ return bld->GetCaptured(); }, { beowulf_raw }, em, world);
 }
 
+BOOST_FIXTURE_TEST_CASE(EnemyMilitaryFollowsTerritoryChanges, EmptyWorldFixture2P40x30)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    std::unique_ptr<AIPlayer> player2(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 1, world));
+    Beowulf* player2_raw = static_cast<Beowulf*>(player2.get());
+
+    beowulf_raw->DisableRecurrents();
+    player2_raw->DisableRecurrents();
+
+    const MapPoint enemyPos(24, 14);
+    const MapPoint enemyHQ = player2_raw->GetAII().GetHeadquarter()->GetPos();
+    // Covered by our planned guardhouse, but closer to the enemy barracks.
+    const MapPoint pos(17, 15);
+    const MapPoint contested(22, 14);
+
+    BOOST_REQUIRE_EQUAL(beowulf_raw->world.GetEnemyMilitaryDistance(enemyPos), beowulf_raw->world.CalcDistance(enemyPos, enemyHQ));
+
+    // Enemy barracks are only known once occupied.
+    Building* enemy = player2_raw->world.Create(BLD_BARRACKS, Building::PlanningRequest);
+    player2_raw->world.Construct(enemy, enemyPos);
+    Proceed([&]() { return enemy->GetState() == Building::UnderConstruction; }, { beowulf.get(), player2.get() }, em, world);
+    BOOST_REQUIRE(player2_raw->roads.Connect(enemy));
+    Proceed([&]() { return enemy->GetCaptured(); }, { beowulf.get(), player2.get() }, em, world);
+    BOOST_REQUIRE(Proceed([&]() {
+        return beowulf_raw->world.GetEnemyMilitaryDistance(enemyPos) == 0;
+    }, { beowulf.get(), player2.get() }, em, world, 100));
+
+    Building* guardhouse = beowulf_raw->world.Create(BLD_GUARDHOUSE, Building::PlanningRequest);
+    beowulf::World::PlanSavepoint savepoint = beowulf_raw->world.SavePlan();
+    beowulf_raw->world.Plan(guardhouse, pos);
+    BOOST_REQUIRE(!beowulf_raw->world.IsOwner(contested, true));
+    beowulf_raw->world.RollbackPlan(savepoint);
+
+    // Destroying the barracks hands the point to our planned guardhouse.
+    player2_raw->world.Deconstruct(enemy);
+    BOOST_REQUIRE(Proceed([&]() {
+        return beowulf_raw->world.GetEnemyMilitaryDistance(enemyPos) != 0;
+    }, { beowulf.get(), player2.get() }, em, world, 100));
+    BOOST_REQUIRE_EQUAL(beowulf_raw->world.GetEnemyMilitaryDistance(enemyPos), beowulf_raw->world.CalcDistance(enemyPos, enemyHQ));
+
+    beowulf_raw->world.Plan(guardhouse, pos);
+    BOOST_REQUIRE(beowulf_raw->world.IsOwner(contested, true));
+    BOOST_REQUIRE(!beowulf_raw->world.IsOwner(contested, false));
+}
+
+BOOST_FIXTURE_TEST_CASE(BatchExpansionResultsMatchSingleResults, EmptyWorldFixture2P48x32)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    std::unique_ptr<AIPlayer> player2(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 1, world));
+    Beowulf* player2_raw = static_cast<Beowulf*>(player2.get());
+
+    beowulf_raw->DisableRecurrents();
+    player2_raw->DisableRecurrents();
+
+    // Enemy military and civilian buildings, so that some candidates destroy buildings.
+    std::vector<Building*> player2buildings;
+    player2buildings.push_back(player2_raw->world.Create(BLD_BARRACKS, Building::PlanningRequest));
+    player2_raw->world.Construct(player2buildings.back(), { 29, 13 });
+    player2buildings.push_back(player2_raw->world.Create(BLD_GUARDHOUSE, Building::PlanningRequest));
+    player2_raw->world.Construct(player2buildings.back(), { 30, 20 });
+    player2buildings.push_back(player2_raw->world.Create(BLD_FARM, Building::PlanningRequest));
+    player2_raw->world.Construct(player2buildings.back(), { 25, 17 });
+
+    Proceed([&]() {
+        for (Building* bld : player2buildings)
+            if (bld->GetState() != Building::UnderConstruction)
+                return false;
+        return true;
+    }, { beowulf.get(), player2.get() }, em, world);
+    for (Building* bld : player2buildings) {
+        BOOST_REQUIRE(player2_raw->roads.Connect(bld));
+    }
+    Proceed([&](){
+        return player2buildings[0]->GetCaptured()
+            && player2buildings[1]->GetCaptured()
+            && player2buildings[2]->GetState() == Building::Finished;
+    }, { beowulf.get(), player2.get() }, em, world);
+
+    // Overlapping candidates, the same point with different types and one without enemies around.
+    const std::vector<beowulf::World::ExpansionCandidate> candidates = {
+        { { 19, 16 }, BLD_FORTRESS },
+        { { 20, 16 }, BLD_WATCHTOWER },
+        { { 19, 16 }, BLD_GUARDHOUSE },
+        { { 18, 14 }, BLD_BARRACKS },
+        { { 19, 16 }, BLD_FORTRESS },
+        { { 12, 24 }, BLD_GUARDHOUSE },
+        { { 15, 16 }, BLD_WOODCUTTER },
+    };
+
+    std::vector<beowulf::World::ExpansionResult> results;
+    beowulf_raw->world.PredictExpansionResults(candidates, results);
+    BOOST_REQUIRE_EQUAL(results.size(), candidates.size());
+
+    auto byIdx = [&](const MapPoint& l, const MapPoint& r)
+    {
+        return beowulf_raw->world.GetIdx(l) < beowulf_raw->world.GetIdx(r);
+    };
+    bool anyDestroyed = false;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        std::vector<MapPoint> additionalTerritory;
+        std::vector<const noBaseBuilding*> destroyed;
+        beowulf_raw->world.PredictExpansionResults(candidates[i].pt, candidates[i].type, additionalTerritory, destroyed);
+
+        std::vector<MapPoint> batchTerritory = results[i].additionalTerritory;
+        std::vector<const noBaseBuilding*> batchDestroyed = results[i].destroyed;
+        std::sort(additionalTerritory.begin(), additionalTerritory.end(), byIdx);
+        std::sort(batchTerritory.begin(), batchTerritory.end(), byIdx);
+        std::sort(destroyed.begin(), destroyed.end());
+        std::sort(batchDestroyed.begin(), batchDestroyed.end());
+
+        BOOST_REQUIRE(batchTerritory == additionalTerritory);
+        BOOST_REQUIRE(batchDestroyed == destroyed);
+        anyDestroyed |= !destroyed.empty();
+    }
+    BOOST_REQUIRE(anyDestroyed);
+}
+
+BOOST_AUTO_TEST_CASE(DeferredRoadNoteKeepsRoute)
+{
+    beowulf::NoteQueue notes;
+    std::vector<Direction> received;
+    auto handler = [&received](const RoadNote& note) { received = note.route; };
+
+    notes.Defer();
+    {
+        // The publisher's route is gone before the note is delivered.
+        std::unique_ptr<std::vector<Direction>> route(new std::vector<Direction>({ Direction::EAST, Direction::SOUTHEAST, Direction::EAST }));
+        notes.Dispatch(RoadNote(RoadNote::Destroyed, 0, MapPoint(3, 4), *route), handler);
+        route.reset(new std::vector<Direction>({ Direction::WEST }));
+    }
+    BOOST_REQUIRE(received.empty());
+
+    notes.Flush();
+    const std::vector<Direction> expected = { Direction::EAST, Direction::SOUTHEAST, Direction::EAST };
+    BOOST_REQUIRE(received == expected);
+    BOOST_REQUIRE(!notes.IsDeferring());
+}
+
+BOOST_FIXTURE_TEST_CASE(SnapshotMilitaryBuildingsInRange, EmptyWorldFixture2P48x32)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+
+    beowulf::WorldSnapshot snapshot;
+    snapshot.Capture(beowulf_raw->GetAII());
+
+    // Same buildings in the same order as the game world.
+    for (const MapPoint& pt : { MapPoint(0, 0), MapPoint(12, 16), MapPoint(30, 5), MapPoint(47, 31) }) {
+        for (unsigned short radius = 0; radius < 3; ++radius) {
+            const sortedMilitaryBlds expected = world.LookForMilitaryBuildings(pt, radius);
+            const std::vector<beowulf::WorldSnapshot::MilitaryBuilding> actual = snapshot.GetMilitaryBuildings(pt, radius);
+            BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+            size_t i = 0;
+            for (const nobBaseMilitary* bld : expected)
+                BOOST_REQUIRE(actual[i++].obj == bld);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(FindHumanPathMatchesGameWorld, BiggerWorldWithGCExecution)
+{
+    std::unique_ptr<AIPlayer> beowulf(AIFactory::Create(AI::Info(AI::BEOWULF, AI::HARD), 0, world));
+    Beowulf* beowulf_raw = static_cast<Beowulf*>(beowulf.get());
+    beowulf_raw->DisableRecurrents();
+    beowulf::World& buildings = beowulf_raw->world;
+
+    // Granite wall with a gap, so some points need a detour.
+    for (unsigned short y = 2; y < 18; ++y)
+        world.SetNO(MapPoint(5, y), new noGranite(GT_1, 1));
+
+    beowulf::WorldSnapshot snapshot;
+    snapshot.Capture(beowulf_raw->GetAII());
+
+    beowulf::HumanPathSearch search;
+    const MapPoint start(3, 8);
+    for (const unsigned maxLength : { 2u, 5u, 10u }) {
+        RTTR_FOREACH_PT(MapPoint, world.GetSize()) {
+            const bool expected = world.FindHumanPath(start, pt, maxLength) != boost::none;
+            BOOST_REQUIRE_EQUAL(buildings.FindHumanPath(start, pt, maxLength, search), expected);
+            buildings.SetSnapshot(&snapshot);
+            BOOST_REQUIRE_EQUAL(buildings.FindHumanPath(start, pt, maxLength, search), expected);
+            buildings.SetSnapshot(nullptr);
+        }
+    }
+}
+
 // @todo: Test on capturing enemy buildings.
 
 #endif
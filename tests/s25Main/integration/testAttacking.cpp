@@ -336,13 +336,13 @@ BOOST_FIXTURE_TEST_CASE(StartAttack, AttackFixture<>)
     AddSoldiers(milBld1Pos, 1, 0);
     BOOST_REQUIRE(!milBld1->IsNewBuilt());
     // Try to attack invisible bld -> Fail
-    MapNode& node = world.GetNodeWriteable(milBld1Pos);
-    node.fow[0].visibility = VIS_FOW;
+    FoWNode& fowNode = world.GetFoWNodeWriteable(milBld1Pos, 0);
+    fowNode.visibility = VIS_FOW;
     BOOST_REQUIRE_EQUAL(world.CalcVisiblityWithAllies(milBld1Pos, curPlayer), VIS_FOW);
     TestFailingAttack(gwv, milBld1Pos, attackSrc);
 
     // Attack it
-    node.fow[0].visibility = VIS_VISIBLE;
+    fowNode.visibility = VIS_VISIBLE;
     std::vector<nofPassiveSoldier*> soldiers(attackSrc.GetTroops().begin(), attackSrc.GetTroops().end()); //-V807
     BOOST_REQUIRE_EQUAL(soldiers.size(), 6u);
     for(int i = 0; i < 3; i++)
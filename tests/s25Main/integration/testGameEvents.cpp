@@ -18,9 +18,17 @@
 #include "GameEvent.h"
 #include "GameObject.h"
 #include "RTTR_AssertError.h"
+#include "SerializedGameData.h"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include "worldFixtures/MockLocalGameState.h"
 #include "worldFixtures/TestEventManager.h"
+#include "worldFixtures/WorldFixture.h"
+#include "nodeObjs/noFire.h"
 #include <rttr/test/LogAccessor.hpp>
 #include <boost/test/unit_test.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(GameEventsTestSuite)
 
@@ -222,6 +230,164 @@ BOOST_AUTO_TEST_CASE(RemoveEvent)
     BOOST_CHECK(!evMgr.ObjectHasEvents(obj));
 }
 
+namespace {
+/// Execute GFs till no event is left. Return (GF, id) of every executed event
+template<class T_ExecuteGF>
+std::vector<std::pair<unsigned, unsigned>> executeAllEvents(TestEventManager& evMgr, TestEventHandler& obj,
+                                                             T_ExecuteGF&& executeGF)
+{
+    std::vector<std::pair<unsigned, unsigned>> executed;
+    while(evMgr.GetNumActiveEvents() > 0u)
+    {
+        const size_t numHandled = obj.handledEventIds.size();
+        executeGF();
+        for(size_t i = numHandled; i < obj.handledEventIds.size(); i++)
+            executed.emplace_back(evMgr.GetCurrentGF(), obj.handledEventIds[i]);
+    }
+    return executed;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(EventsAfterWheel)
+{
+    // Events 1024 GFs or more ahead are kept outside the wheel till they come close.
+    // Check stepping GF by GF and skipping to the next event (as the tests do)
+    for(bool skipGFs : {false, true})
+    {
+        TestEventManager evMgr(1000);
+        TestEventHandler obj;
+        evMgr.AddEvent(&obj, 3000, 1);
+        evMgr.AddEvent(&obj, 1024, 2);
+        evMgr.AddEvent(&obj, 1023, 3);
+        evMgr.AddEvent(&obj, 3000, 4);
+        evMgr.AddEvent(&obj, 5000, 5);
+        // Continued event started before the current GF
+        evMgr.AddEvent(&obj, 2500, 6, 500);
+        BOOST_REQUIRE_EQUAL(evMgr.GetNumActiveEvents(), 6u);
+
+        // Ordered by GF, events of the same GF in the order they were added
+        std::vector<unsigned> evIds;
+        for(const GameEvent* ev : evMgr.GetEvents())
+            evIds.push_back(ev->id);
+        const std::vector<unsigned> expectedIds = {3, 2, 6, 1, 4, 5};
+        BOOST_TEST(evIds == expectedIds, boost::test_tools::per_element());
+
+        const auto executed = executeAllEvents(evMgr, obj, [&]() {
+            if(skipGFs)
+                evMgr.ExecuteNextEvent();
+            else
+                evMgr.ExecuteNextGF();
+        });
+        const std::vector<std::pair<unsigned, unsigned>> expected = {{2023, 3}, {2024, 2}, {3000, 6},
+                                                                     {4000, 1}, {4000, 4}, {6000, 5}};
+        BOOST_REQUIRE(executed == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RemoveEventsAfterWheel)
+{
+    TestEventManager evMgr(0);
+    TestEventHandler obj;
+    const GameEvent* ev1 = evMgr.AddEvent(&obj, 2000, 1);
+    const GameEvent* ev2 = evMgr.AddEvent(&obj, 2000, 2);
+    evMgr.AddEvent(&obj, 2000, 3);
+    const GameEvent* ev4 = evMgr.AddEvent(&obj, 3000, 4);
+
+    // Remove while still outside the wheel
+    evMgr.RemoveEvent(ev1);
+    BOOST_REQUIRE(!ev1);
+    // Last event of its GF
+    evMgr.RemoveEvent(ev4);
+    BOOST_REQUIRE(!ev4);
+    BOOST_REQUIRE_EQUAL(evMgr.GetNumActiveEvents(), 2u);
+
+    // Move the remaining events into the wheel and remove one there
+    for(unsigned gf = 1; gf <= 1500; gf++)
+        evMgr.ExecuteNextGF();
+    BOOST_REQUIRE_EQUAL(obj.handledEventIds.size(), 0u);
+    evMgr.RemoveEvent(ev2);
+    BOOST_REQUIRE(!ev2);
+    BOOST_REQUIRE_EQUAL(evMgr.GetNumActiveEvents(), 1u);
+
+    // Add an event to the same GF after the removals
+    evMgr.AddEvent(&obj, 500, 5);
+    const auto executed = executeAllEvents(evMgr, obj, [&]() { evMgr.ExecuteNextGF(); });
+    const std::vector<std::pair<unsigned, unsigned>> expected = {{2000, 3}, {2000, 5}};
+    BOOST_REQUIRE(executed == expected);
+    // Nothing executed for the removed event at GF 3000
+    for(unsigned gf = evMgr.GetCurrentGF(); gf < 3100; gf++)
+        evMgr.ExecuteNextGF();
+    BOOST_REQUIRE_EQUAL(obj.handledEventIds.size(), 2u);
+    BOOST_CHECK(!evMgr.ObjectHasEvents(obj));
+}
+
+BOOST_AUTO_TEST_CASE(RemoveEventInSameGFAfterWheel)
+{
+    // Same as RemoveEvent but the events were added outside the wheel
+    TestEventManager evMgr(0);
+    TestRemoveEvent obj(evMgr);
+    evMgr.AddEvent(&obj, 1500, 41);
+    evMgr.AddEvent(&obj, 1500, 42);
+    obj.ev2Remove = evMgr.AddEvent(&obj, 1500, 43);
+    evMgr.AddEvent(&obj, 1500, 44);
+    // Event 42 removes 43. The others keep their order
+    evMgr.ExecuteNextEvent();
+    BOOST_REQUIRE_EQUAL(evMgr.GetCurrentGF(), 1500u);
+    const std::vector<unsigned> expectedIds = {41, 42, 44};
+    BOOST_TEST(obj.handledEventIds == expectedIds, boost::test_tools::per_element());
+    BOOST_REQUIRE_EQUAL(evMgr.GetNumActiveEvents(), 0u);
+}
+
+using EmptyWorldFixture0P = WorldFixture<CreateEmptyWorld, 0>;
+BOOST_FIXTURE_TEST_CASE(SaveLoadEventsAfterWheel, EmptyWorldFixture0P)
+{
+    // Fires burn for 3700 GFs, so their events start after the wheel
+    const std::vector<MapPoint> firePts = {MapPoint(2, 2), MapPoint(5, 2), MapPoint(2, 5), MapPoint(5, 5)};
+    world.SetNO(firePts[0], new noFire(firePts[0], false));
+    for(unsigned i = 0; i < 5; i++)
+        em.ExecuteNextGF();
+    world.SetNO(firePts[1], new noFire(firePts[1], false));
+    world.SetNO(firePts[2], new noFire(firePts[2], false));
+    // The first 3 events are now in the wheel, the last one is added after it
+    for(unsigned i = 0; i < 3000; i++)
+        em.ExecuteNextGF();
+    world.SetNO(firePts[3], new noFire(firePts[3], false));
+    const std::vector<unsigned> deadGFs = {3700, 3705, 3705, 6705};
+
+    SerializedGameData sgd;
+    sgd.MakeSnapshot(game);
+    auto loadedGame = std::make_shared<Game>(ggs, std::make_unique<TestEventManager>(em.GetCurrentGF()),
+                                             std::vector<PlayerInfo>());
+    MockLocalGameState localGameState;
+    sgd.ReadSnapshot(loadedGame, localGameState);
+    auto& loadedEm = static_cast<TestEventManager&>(loadedGame->world_.GetEvMgr());
+    const GameWorld& loadedWorld = loadedGame->world_;
+
+    BOOST_REQUIRE_EQUAL(loadedEm.GetCurrentGF(), em.GetCurrentGF());
+    BOOST_REQUIRE_EQUAL(loadedEm.GetNumActiveEvents(), em.GetNumActiveEvents());
+    const std::vector<const GameEvent*> evs = em.GetEvents();
+    const std::vector<const GameEvent*> loadedEvs = loadedEm.GetEvents();
+    BOOST_REQUIRE_EQUAL(loadedEvs.size(), evs.size());
+    for(unsigned i = 0; i < evs.size(); i++)
+    {
+        BOOST_REQUIRE_EQUAL(loadedEvs[i]->GetInstanceId(), evs[i]->GetInstanceId());
+        BOOST_REQUIRE_EQUAL(loadedEvs[i]->GetTargetGF(), evs[i]->GetTargetGF());
+        BOOST_REQUIRE_EQUAL(loadedEvs[i]->id, evs[i]->id);
+    }
+
+    // Every fire burns out exactly at its GF, including the one loaded after the wheel
+    while(loadedEm.GetNumActiveEvents() > 0u)
+    {
+        loadedEm.ExecuteNextGF();
+        for(unsigned i = 0; i < firePts.size(); i++)
+        {
+            const bool burning = loadedWorld.GetNO(firePts[i])->GetGOT() == GOT_FIRE;
+            BOOST_REQUIRE_EQUAL(burning, loadedEm.GetCurrentGF() < deadGFs[i]);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(loadedEm.GetCurrentGF(), deadGFs.back());
+}
+
 #if RTTR_ENABLE_ASSERTS
 BOOST_AUTO_TEST_CASE(InvalidEvent)
 {
@@ -0,0 +1,109 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "GamePlayer.h"
+#include "PointOutput.h"
+#include "buildings/nobBaseMilitary.h"
+#include "factories/BuildingFactory.h"
+#include "helpers/containerUtils.h"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include "worldFixtures/WorldFixture.h"
+#include "gameData/MilitaryConsts.h"
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(MilitarySquaresSuite)
+
+namespace {
+using WorldFixtureEmpty2P = WorldFixture<CreateEmptyWorld, 2, 64, 64>;
+
+MapPoint getSquare(const MapPoint pt)
+{
+    return pt / MILITARY_SQUARE_SIZE;
+}
+
+std::vector<nobBaseMilitary*> visitBuildings(const GameWorldBase& world, MapPoint pt, unsigned short radius,
+                                             unsigned playerMask)
+{
+    std::vector<nobBaseMilitary*> result;
+    world.VisitMilitaryBuildings(pt, radius, playerMask, [&result](nobBaseMilitary* bld) { result.push_back(bld); });
+    return result;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(QueryBuildings, WorldFixtureEmpty2P)
+{
+    const MapPoint hqPos0 = world.GetPlayer(0).GetHQPos();
+    const MapPoint hqPos1 = world.GetPlayer(1).GetHQPos();
+    // Find a square without HQs
+    MapPoint bldPos = MapPoint::Invalid();
+    for(MapCoord y = 2; y < world.GetHeight() && !bldPos.isValid(); y += MILITARY_SQUARE_SIZE)
+    {
+        for(MapCoord x = 2; x < world.GetWidth(); x += MILITARY_SQUARE_SIZE)
+        {
+            const MapPoint pt(x, y);
+            if(getSquare(pt) != getSquare(hqPos0) && getSquare(pt) != getSquare(hqPos1))
+            {
+                bldPos = pt;
+                break;
+            }
+        }
+    }
+    BOOST_REQUIRE(bldPos.isValid());
+    const MapPoint bldPos2 = bldPos + MapPoint(4, 0);
+    BOOST_REQUIRE(getSquare(bldPos) == getSquare(bldPos2));
+
+    auto* bld1 =
+      static_cast<nobBaseMilitary*>(BuildingFactory::CreateBuilding(world, BLD_BARRACKS, bldPos, 1, NAT_ROMANS));
+    auto* bld2 =
+      static_cast<nobBaseMilitary*>(BuildingFactory::CreateBuilding(world, BLD_GUARDHOUSE, bldPos2, 1, NAT_ROMANS));
+    const auto* hq0 = world.GetSpecObj<nobBaseMilitary>(hqPos0);
+    const auto* hq1 = world.GetSpecObj<nobBaseMilitary>(hqPos1);
+
+    // Radius covers the whole map (and more) -> Everything exactly once, newest first
+    sortedMilitaryBlds allBlds = world.LookForMilitaryBuildings(bldPos, 99);
+    BOOST_REQUIRE_EQUAL(allBlds.size(), 4u);
+    std::vector<const nobBaseMilitary*> allBldsVec(allBlds.begin(), allBlds.end());
+    for(unsigned i = 1; i < allBldsVec.size(); i++)
+        BOOST_TEST(allBldsVec[i - 1]->GetObjId() > allBldsVec[i]->GetObjId());
+    BOOST_TEST(allBldsVec.front() == bld2);
+
+    std::vector<nobBaseMilitary*> player0Blds = visitBuildings(world, bldPos, 99, 1u << 0);
+    BOOST_REQUIRE_EQUAL(player0Blds.size(), 1u);
+    BOOST_TEST(player0Blds.front() == hq0);
+    std::vector<nobBaseMilitary*> player1Blds = visitBuildings(world, bldPos, 99, 1u << 1);
+    BOOST_REQUIRE_EQUAL(player1Blds.size(), 3u);
+    BOOST_TEST(helpers::contains(player1Blds, hq1));
+    BOOST_TEST(helpers::contains(player1Blds, bld1));
+    BOOST_TEST(helpers::contains(player1Blds, bld2));
+
+    // Radius 0 = only the square of the point
+    BOOST_TEST(visitBuildings(world, bldPos, 0, ~0u).size() == 2u);
+    BOOST_TEST(world.IsAnyMilitaryBuildingNear(bldPos, 0, 1u << 1));
+    BOOST_TEST(!world.IsAnyMilitaryBuildingNear(bldPos, 0, 1u << 0));
+    BOOST_TEST(world.IsAnyMilitaryBuildingNear(bldPos, 99, 1u << 0));
+
+    world.DestroyNO(bldPos);
+    BOOST_TEST(visitBuildings(world, bldPos, 0, ~0u).size() == 1u);
+    BOOST_TEST(world.IsAnyMilitaryBuildingNear(bldPos, 0, 1u << 1));
+    world.DestroyNO(bldPos2);
+    BOOST_TEST(visitBuildings(world, bldPos, 0, ~0u).empty());
+    BOOST_TEST(!world.IsAnyMilitaryBuildingNear(bldPos, 0, ~0u));
+    BOOST_REQUIRE_EQUAL(world.LookForMilitaryBuildings(bldPos, 99).size(), 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -296,6 +296,14 @@ BOOST_FIXTURE_TEST_CASE(CreateTerritoryRegion, WorldFixtureEmpty2P)
             BOOST_TEST_INFO(pt << " iteration " << i);
             BOOST_TEST_REQUIRE(region.GetOwner(Position(pt)) == owner);
         }
+        // The stored claims must give the same owners (no restricted areas here)
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            const std::vector<TerritoryInfluence::Claim>& claims = world.GetTerritoryInfluence().GetClaims(pt);
+            const uint8_t owner = claims.empty() ? 0 : claims.front().player + 1;
+            BOOST_TEST_INFO(pt << " iteration " << i);
+            BOOST_TEST_REQUIRE(region.GetOwner(Position(pt)) == owner);
+        }
         // Check that all world points that should have an owner do have one
         RTTR_FOREACH_PT(MapPoint, world.GetSize())
         {
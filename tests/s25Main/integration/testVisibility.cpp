@@ -0,0 +1,130 @@
+// Copyright (c) 2005 - 2017 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "GamePlayer.h"
+#include "PointOutput.h"
+#include "RttrForeachPt.h"
+#include "buildings/nobMilitary.h"
+#include "factories/BuildingFactory.h"
+#include "figures/nofPassiveSoldier.h"
+#include "figures/nofScout_Free.h"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include "worldFixtures/WorldFixture.h"
+#include "gameTypes/GameTypesOutput.h"
+#include "gameData/MilitaryConsts.h"
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(VisibilitySuite)
+
+namespace {
+struct VisibilityFixture : public WorldFixture<CreateEmptyWorld, 1, 64, 64>
+{
+    MapPoint hqPos;
+    VisibilityFixture()
+    {
+        ggs.exploration = EXP_FOGOFWAR;
+        hqPos = world.GetPlayer(0).GetHQPos();
+    }
+
+    /// The incrementally maintained observer counts must match a full rebuild
+    void checkObserversConsistent()
+    {
+        std::vector<bool> observed;
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+            observed.push_back(world.IsObserved(pt, 0));
+        world.InitAfterLoad();
+        unsigned idx = 0;
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            BOOST_TEST_INFO("Position" << pt);
+            BOOST_REQUIRE_EQUAL(world.IsObserved(pt, 0), observed[idx++]);
+        }
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(HQObservesItsRange, VisibilityFixture)
+{
+    const unsigned range = HQ_RADIUS + VISUALRANGE_MILITARY;
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        BOOST_REQUIRE_EQUAL(world.IsObserved(pt, 0), world.CalcDistance(pt, hqPos) <= range);
+    checkObserversConsistent();
+}
+
+BOOST_FIXTURE_TEST_CASE(MilitaryBuildingObservesWhenOccupied, VisibilityFixture)
+{
+    const MapPoint milPos = hqPos + MapPoint(7, 0);
+    auto* bld = static_cast<nobMilitary*>(BuildingFactory::CreateBuilding(world, BLD_WATCHTOWER, milPos, 0, NAT_ROMANS));
+    const unsigned range = bld->GetMilitaryRadius() + VISUALRANGE_MILITARY;
+    const unsigned hqRange = HQ_RADIUS + VISUALRANGE_MILITARY;
+    // Find a point only the tower can see
+    MapPoint testPt = MapPoint::Invalid();
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        if(world.CalcDistance(pt, milPos) == range && world.CalcDistance(pt, hqPos) > hqRange)
+        {
+            testPt = pt;
+            break;
+        }
+    }
+    BOOST_REQUIRE(testPt.isValid());
+    // Not occupied yet -> does not see anything
+    BOOST_REQUIRE(!world.IsObserved(testPt, 0));
+    checkObserversConsistent();
+
+    auto* soldier = new nofPassiveSoldier(milPos, 0, bld, bld, 0);
+    world.GetPlayer(0).IncreaseInventoryJob(soldier->GetJobType(), 1);
+    world.AddFigure(milPos, soldier);
+    soldier->WalkToGoal();
+    BOOST_REQUIRE(!bld->IsNewBuilt());
+    BOOST_REQUIRE(world.IsObserved(testPt, 0));
+    BOOST_REQUIRE_EQUAL(world.CalcVisiblityWithAllies(testPt, 0), VIS_VISIBLE);
+    checkObserversConsistent();
+
+    world.DestroyNO(milPos);
+    BOOST_REQUIRE(!world.IsObserved(testPt, 0));
+    BOOST_REQUIRE_EQUAL(world.GetFoWNode(testPt, 0).visibility, VIS_FOW);
+    // Still seen by the HQ
+    BOOST_REQUIRE(world.IsObserved(hqPos + MapPoint(1, 0), 0));
+    checkObserversConsistent();
+}
+
+BOOST_FIXTURE_TEST_CASE(MovingScoutUpdatesObservers, VisibilityFixture)
+{
+    MapPoint pos = hqPos + MapPoint(HQ_RADIUS, 0);
+    auto* scout = new nofScout_Free(pos, 0, nullptr);
+    world.AddFigure(pos, scout);
+    for(unsigned i = 0; i < 15; i++)
+    {
+        pos = world.MoveFigure(pos, Direction::EAST, scout);
+        scout->SetPos(pos);
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            const bool seenByScout = world.CalcDistance(pt, pos) <= VISUALRANGE_SCOUT;
+            const bool seenByHQ = world.CalcDistance(pt, hqPos) <= HQ_RADIUS + VISUALRANGE_MILITARY;
+            BOOST_REQUIRE_EQUAL(world.IsObserved(pt, 0), seenByScout || seenByHQ);
+        }
+    }
+    checkObserversConsistent();
+    world.RemoveFigure(pos, scout);
+    delete scout;
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        BOOST_REQUIRE_EQUAL(world.IsObserved(pt, 0), world.CalcDistance(pt, hqPos) <= HQ_RADIUS + VISUALRANGE_MILITARY);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -784,10 +784,9 @@ BOOST_AUTO_TEST_CASE(onExplored)
     std::map<int, Points> gamePtsPerPlayer;
     RTTR_FOREACH_PT(MapPoint, world.GetSize())
     {
-        const MapNode& node = world.GetNode(pt);
         for(unsigned i = 0; i < world.GetNumPlayers(); i++)
         {
-            if(node.fow[i].visibility == VIS_VISIBLE)
+            if(world.GetFoWNode(pt, i).visibility == VIS_VISIBLE)
                 gamePtsPerPlayer[i].push_back(std::pair<int, int>(pt.x, pt.y));
         }
     }